@@ -27,7 +27,9 @@ void showhelp(){
  cout<<"  Usage: gjm [-options] your_file.split"<<endl;
  cout<<endl;
  cout<<"  You may give the name of the split file created by gjs (see inside the .Gate directory)."<<endl;
- cout<<"  !! This merger is only designed to ROOT output. !!"<<endl;
+ cout<<"  This merger handles the ROOT output and the .mhd images saved by the actors:"<<endl;
+ cout<<"  images are summed and uncertainty images recomputed from the merged value and squared"<<endl;
+ cout<<"  images, with the number of events of the SimulationStatisticActor."<<endl;
  cout<<endl;
  cout<<"  Options: "<<endl;
  cout<<"  -outDir path              : where to save the output files default is PWD"<<endl;
@@ -35,12 +37,23 @@ void showhelp(){
 // cout<<"                              multiple root files will be created: filename_part(n).root "<<endl;
 // cout<<"                              xxx is an integer, default unit is M "<<endl;
  cout<<"  -v                        : verbosity 0 1 2 3 - 1 default "<<endl;
+ cout<<"  -j                        : number of threads for the image merging - all cores default "<<endl;
  cout<<"  -f                        : forced output - an existing output file will be overwritten"<<endl;
  cout<<"  -cleanonly                : do only a the cleanup step i.e. no merging"<<endl;
  cout<<"                              erase work directory in .Gate and the files from the parallel jobs"<<endl;
  cout<<"  -cleanonlyTest            : just tells you what will be erased by the -cleanonly"<<endl;
  cout<<"  -clean                    : merge and then do the cleanup automatically"<<endl;
  cout<<"  -fastMerge                : correct the output in each file, to be used with a TChain (only for Root output)"<<endl;
+ cout<<"  -timeOrdered              : merge the singles of all files in time order (k-way merge)"<<endl;
+ cout<<"  -buffer n                 : number of singles read ahead per file by -timeOrdered - 10000 default"<<endl;
+ cout<<"  -coincWindow ns           : sort the time ordered singles into coincidences with this window (ns)"<<endl;
+ cout<<"                              written to the OfflineCoincidences tree, implies -timeOrdered"<<endl;
+ cout<<"  -coincOffset ns           : offset of the coincidence window (ns) - 0 default"<<endl;
+ cout<<"  -coincPolicy name         : multiples policy, as /gate/digitizer/Coincidences/MultiplesPolicy"<<endl;
+ cout<<"                              - keepIfAllAreGoods default"<<endl;
+ cout<<"  -coincAllOpen             : all singles open a coincidence window"<<endl;
+ cout<<"  -coincMinSectorDiff d     : minimum rsectorID difference - 2 default"<<endl;
+ cout<<"  -coincSectorNumber n      : number of rsectors for the sector difference - no check default"<<endl;
  cout<<endl;
  cout<<"  Environment variable: "<<endl;
  cout<<"  GC_DOT_GATE_DIR : points to the .Gate directory"<<endl<<endl;
@@ -53,11 +66,20 @@ int main(int argc,char** argv)
   string splitfileName ="";
   Long64_t     maxRoot = 0;
   int     verboseLevel = 1;
+  int         nThreads = 0;
   bool          forced = false;
   bool          clean  = false;
   bool          test   = false;
   bool          merge  = true;
   bool       fastMerge = false;
+  bool     timeOrdered = false;
+  long      bufferSize = 10000;
+  double   coincWindow = 0.0;
+  double   coincOffset = 0.0;
+  string   coincPolicy = "keepIfAllAreGoods";
+  bool    coincAllOpen = false;
+  int coincMinSectorDiff = 2;
+  int coincSectorNumber  = 0;
 
   // Parse the command line
   if (argc==1) showhelp();
@@ -75,6 +97,13 @@ int main(int argc,char** argv)
     } else if (!strcmp(argv[nextArg],"-outDir") && (nextArg+1)<argc){
        nextArg++;
        outDir=argv[nextArg];
+    } else if (!strcmp(argv[nextArg],"-j") && (nextArg+1)<argc){
+       nextArg++;
+       if(!isdigit(argv[nextArg][0]) ) {
+          cout<<"-j "<<argv[nextArg]<<" That's not a number!"<<endl;
+          exit(0);
+       }
+       nThreads=atoi(argv[nextArg]);
     } else if (!strcmp(argv[nextArg],"-f")){
        forced=true;
     } else if (!strcmp(argv[nextArg],"-clean")){
@@ -87,6 +116,48 @@ int main(int argc,char** argv)
        test  = true;
     } else if (!strcmp(argv[nextArg],"-fastMerge")){
        fastMerge=true;
+    } else if (!strcmp(argv[nextArg],"-timeOrdered")){
+       timeOrdered=true;
+    } else if (!strcmp(argv[nextArg],"-buffer") && (nextArg+1)<argc){
+       nextArg++;
+       if(!isdigit(argv[nextArg][0]) || atol(argv[nextArg])<1) {
+          cout<<"-buffer "<<argv[nextArg]<<" That's not a positive number!"<<endl;
+          exit(0);
+       }
+       bufferSize=atol(argv[nextArg]);
+    } else if (!strcmp(argv[nextArg],"-coincWindow") && (nextArg+1)<argc){
+       nextArg++;
+       if(!isdigit(argv[nextArg][0]) && argv[nextArg][0]!='.') {
+          cout<<"-coincWindow "<<argv[nextArg]<<" That's not a number!"<<endl;
+          exit(0);
+       }
+       coincWindow=atof(argv[nextArg])*1.e-9;   // the times of the root output are in s
+    } else if (!strcmp(argv[nextArg],"-coincOffset") && (nextArg+1)<argc){
+       nextArg++;
+       if(!isdigit(argv[nextArg][0]) && argv[nextArg][0]!='.') {
+          cout<<"-coincOffset "<<argv[nextArg]<<" That's not a number!"<<endl;
+          exit(0);
+       }
+       coincOffset=atof(argv[nextArg])*1.e-9;
+    } else if (!strcmp(argv[nextArg],"-coincPolicy") && (nextArg+1)<argc){
+       nextArg++;
+       coincPolicy=argv[nextArg];
+    } else if (!strcmp(argv[nextArg],"-coincAllOpen")){
+       coincAllOpen=true;
+    } else if (!strcmp(argv[nextArg],"-coincMinSectorDiff") && (nextArg+1)<argc){
+       nextArg++;
+       if(!isdigit(argv[nextArg][0]) ) {
+          cout<<"-coincMinSectorDiff "<<argv[nextArg]<<" That's not a number!"<<endl;
+          exit(0);
+       }
+       coincMinSectorDiff=atoi(argv[nextArg]);
+    } else if (!strcmp(argv[nextArg],"-coincSectorNumber") && (nextArg+1)<argc){
+       nextArg++;
+       if(!isdigit(argv[nextArg][0]) ) {
+          cout<<"-coincSectorNumber "<<argv[nextArg]<<" That's not a number!"<<endl;
+          exit(0);
+       }
+       coincSectorNumber=atoi(argv[nextArg]);
     } else if (!strcmp(argv[nextArg],"-cleanonly")){
        clean = true;
        merge = false;
@@ -138,7 +209,17 @@ int main(int argc,char** argv)
   }
 
   //create a merge manager
-  GateMergeManager* manager = new GateMergeManager(fastMerge,verboseLevel,forced,maxRoot,outDir);
+  GateMergeManager* manager = new GateMergeManager(fastMerge,verboseLevel,forced,maxRoot,outDir,nThreads);
+  if(timeOrdered) manager->SetTimeOrdered(true,bufferSize);
+  if(coincWindow>0) {
+     manager->SetTimeOrdered(true,bufferSize);
+     manager->SetOfflineCoincidences(coincWindow,coincOffset,coincPolicy,coincAllOpen,
+                                     coincMinSectorDiff,coincSectorNumber);
+  }
+  if((timeOrdered || coincWindow>0) && fastMerge) {
+     cout<<"-timeOrdered and -coincWindow cannot be used with -fastMerge"<<endl;
+     exit(0);
+  }
 
   if(merge) manager->StartMerging(splitfileName);
   if(clean) manager->StartCleaning(splitfileName,test);
@@ -0,0 +1,71 @@
+/*----------------------
+   GATE version name: gate_v...
+
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+
+#ifndef GateImageMerger_h
+#define GateImageMerger_h 1
+#include <string>
+#include <vector>
+
+// Merges the .mhd images saved by the actors of the split jobs: value
+// and squared images are summed, uncertainty images are recomputed from
+// the merged sums and the total number of primaries (read from the
+// SimulationStatisticActor outputs). The raw data are memory mapped and
+// summed by chunks with several threads.
+class GateImageMerger
+{
+public:
+
+  GateImageMerger(int verboseLevel,bool forced,std::string outDir,int nThreads);
+
+  // one actor 'save' command: file names of all the split jobs and of the original macro
+  void AddActor(std::string type,std::string name,std::vector<std::string> splitNames,std::string originalName);
+
+  void MergeActors();
+
+private:
+
+  enum ElementType {kUnknown,kChar,kUChar,kShort,kUShort,kInt,kUInt,kFloat,kDouble};
+
+  struct MHDHeader {
+    std::vector<std::string> lines;          // all lines, kept for the output header
+    int                      dataFileLine;   // index of the ElementDataFile line
+    int                      totalSumLine;   // index of the TotalSum line (image of histograms), -1 if none
+    ElementType              type;
+    size_t                   nbOfValues;
+    std::string              dataFileName;   // raw file name with its path
+  };
+
+  struct Actor {
+    std::string              type;
+    std::string              name;
+    std::vector<std::string> splitNames;
+    std::string              originalName;
+  };
+
+  bool ReadHeader(std::string filename,MHDHeader& header);
+  bool WriteHeader(std::string filename,const MHDHeader& header,double totalSum);
+  bool MergeImage(const std::vector<std::string>& inputs,std::string output);
+  bool MergeUncertainty(std::string value,std::string squared,std::string output,long long nbOfEvents);
+  long long ReadNumberOfEvents(const Actor& actor);
+  std::vector<std::string> FindOutputSuffixes(std::string splitName);
+  std::string OutputName(std::string name);
+
+  static size_t ElementSize(ElementType type);
+
+  int                     m_verboseLevel;
+  bool                    m_forced;             // if to overwrite existing files
+  std::string             m_outDir;             // where to save the output files
+  int                     m_nThreads;
+  std::vector<Actor>      m_actors;
+};
+
+
+#endif
@@ -22,13 +22,17 @@ class GateMergeManager
 {
 public:
 
-  GateMergeManager(bool fastMerge,int verboseLevel,bool forced,Long64_t maxRoot,std::string outDir){
+  GateMergeManager(bool fastMerge,int verboseLevel,bool forced,Long64_t maxRoot,std::string outDir,int nThreads=0){
      m_verboseLevel = verboseLevel;
      m_forced       =       forced;
      m_maxRoot      =      maxRoot;
      m_outDir       =       outDir;
      m_CompLevel    =            1;
      m_fastMerge    =    fastMerge;
+     m_nThreads     =     nThreads;
+     m_timeOrdered  =        false;
+     m_bufferSize   =        10000;
+     m_coincWindow  =          0.0;
 
      //check if a .Gate directory can be found
      if (!getenv("GC_DOT_GATE_DIR")) {
@@ -59,11 +63,29 @@ public:
   bool MergeSing(TChain* chain);
   bool MergeCoin(TChain* chain);
 
+  // time ordered merging of the singles, optionally followed by the coincidence sorting
+  void SetTimeOrdered(bool timeOrdered,long bufferSize){
+     m_timeOrdered = timeOrdered;
+     m_bufferSize  =  bufferSize;
+  }
+  void SetOfflineCoincidences(double window,double offset,std::string policy,bool allOpen,
+                              int minSectorDiff,int sectorNumber){
+     m_timeOrdered        =          true;
+     m_coincWindow        =        window;
+     m_coincOffset        =        offset;
+     m_coincPolicy        =        policy;
+     m_coincAllOpen       =       allOpen;
+     m_coincMinSectorDiff = minSectorDiff;
+     m_coincSectorNumber  =  sectorNumber;
+  }
+  bool MergeSingTimeOrdered(std::string name);
+
   // the cleanup after succesful merging
   void StartCleaning(std::string splitfileName,bool test);
 
   // the merging methods
   void MergeRoot();
+  void MergeActorImages();
 
 private:
   void FastMergeRoot(); 
@@ -83,6 +105,19 @@ private:
   TFile*           m_RootTarget;             // root output file
   std::string  m_RootTargetName;             // name of target i.e. root output file
   bool              m_fastMerge;             // fast merge option, corrects the eventIDs locally
+  int                m_nThreads;             // threads for the image merging, 0 = all cores
+  bool            m_timeOrdered;             // k-way merge of the singles in time order
+  long             m_bufferSize;             // number of singles times read ahead per file
+  double          m_coincWindow;             // offline coincidence window (s), 0 = no sorting
+  double          m_coincOffset;             // offline coincidence window offset (s)
+  std::string     m_coincPolicy;             // offline coincidences multiples policy
+  bool           m_coincAllOpen;             // all singles open a coincidence window
+  int      m_coincMinSectorDiff;             // minimum rsectorID difference
+  int       m_coincSectorNumber;             // number of rsectors, 0 = no sector check
+  std::vector<std::string> m_vActorTypes;    // actor type of each actor 'save' command
+  std::vector<std::string> m_vActorNames;    // actor name of each actor 'save' command
+  std::vector<std::string> m_vActorTargetNames;             // original file name of each actor 'save' command
+  std::vector<std::vector<std::string> > m_vActorFileNames; // file names from all jobs of each actor 'save' command
 };
 
 
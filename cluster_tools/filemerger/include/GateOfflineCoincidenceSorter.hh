@@ -0,0 +1,78 @@
+/*----------------------
+   GATE version name: gate_v...
+
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+
+#ifndef GateOfflineCoincidenceSorter_h
+#define GateOfflineCoincidenceSorter_h 1
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+
+// Coincidence sorting of a time ordered stream of singles, with the
+// coincidence windows and the multiples policies of GateCoincidenceSorter
+// (source/digits_hits). As the stream is already time ordered, there is no
+// presort buffer; the memory is bounded by the singles of the open windows.
+class GateOfflineCoincidenceSorter
+{
+public:
+
+  struct Single {
+    double              time;
+    double              energy;
+    int                 sectorID;
+    std::vector<double> values;    // all the values of the single, for the output
+  };
+
+  // called for each coincidence (pair of singles)
+  typedef std::function<void(const Single&,const Single&)> CoincidenceOutput;
+
+  // window and offset in the time unit of the singles; minSectorDifference is
+  // only checked if sectorNumber>0
+  GateOfflineCoincidenceSorter(double window,double offset,std::string multiplesPolicy,
+                               bool allSinglesOpenWindow,int minSectorDifference,int sectorNumber,
+                               CoincidenceOutput output);
+
+  void ProcessSingle(const Single& single);
+  // close the remaining windows at the end of the stream
+  void Flush();
+
+  long long GetNumberOfCoincidences() const { return m_nbOfCoincidences; }
+
+private:
+
+  enum MultiplesPolicy {kKillAll,kTakeAllGoods,kTakeWinnerOfGoods,kTakeWinnerIfIsGood,
+                        kTakeWinnerIfAllAreGoods,kKillAllIfMultipleGoods,kKeepIfAnyIsGood,
+                        kKeepIfOnlyOneGood,kKeepIfAllAreGoods,kKeepAll};
+
+  struct Window {
+    double              startTime;
+    double              endTime;
+    bool                delayed;
+    std::vector<Single> singles;
+  };
+
+  void ProcessCompletedWindow(const Window& window);
+  bool IsForbiddenCoincidence(const Single& single1,const Single& single2) const;
+  void Store(const Single& single1,const Single& single2);
+
+  double              m_window;
+  double              m_offset;
+  MultiplesPolicy     m_multiplesPolicy;
+  bool                m_allSinglesOpenWindow;
+  int                 m_minSectorDifference;
+  int                 m_sectorNumber;
+  CoincidenceOutput   m_output;
+  std::deque<Window>  m_windows;
+  long long           m_nbOfCoincidences;
+};
+
+
+#endif
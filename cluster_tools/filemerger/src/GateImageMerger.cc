@@ -0,0 +1,470 @@
+/*----------------------
+   GATE version name: gate_v...
+
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <glob.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "GateImageMerger.hh"
+
+using namespace std;
+
+namespace {
+
+// number of voxels summed at once by a thread
+const size_t kChunkSize = 1<<20;
+
+struct MappedFile {
+  void*  data;
+  size_t size;
+  MappedFile():data(NULL),size(0){}
+};
+
+bool MapFile(string filename,size_t size,bool write,MappedFile& file){
+  int fd = write ? open(filename.c_str(),O_RDWR|O_CREAT|O_TRUNC,0644) : open(filename.c_str(),O_RDONLY);
+  if(fd<0) return false;
+  if(write && ftruncate(fd,size)!=0) { close(fd); return false; }
+  if(!write){
+    struct stat st;
+    if(fstat(fd,&st)!=0 || (size_t)st.st_size<size) { close(fd); return false; }
+  }
+  file.size = size;
+  file.data = size ? mmap(NULL,size,write ? PROT_READ|PROT_WRITE : PROT_READ,MAP_SHARED,fd,0) : NULL;
+  close(fd);
+  if(file.data==MAP_FAILED) { file.data=NULL; return false; }
+  if(file.data && !write) madvise(file.data,size,MADV_SEQUENTIAL);
+  return true;
+}
+
+void UnmapFile(MappedFile& file){
+  if(file.data) munmap(file.data,file.size);
+  file.data=NULL;
+}
+
+// calls f(begin,end,thread) on all the chunks of [0,n), the chunks being shared among the threads
+void ParallelChunks(size_t n,int nThreads,function<void(size_t,size_t,int)> f){
+  atomic<size_t> nextChunk(0);
+  size_t nChunks = (n+kChunkSize-1)/kChunkSize;
+  if((size_t)nThreads>nChunks) nThreads = max((size_t)1,nChunks);
+  vector<thread> threads;
+  for(int t=0;t<nThreads;t++){
+    threads.push_back(thread([&,t](){
+      size_t c;
+      while((c=nextChunk++)<nChunks) f(c*kChunkSize,min(n,(c+1)*kChunkSize),t);
+    }));
+  }
+  for(unsigned int t=0;t<threads.size();t++) threads[t].join();
+}
+
+template<class T> void AddValues(const void* data,size_t begin,size_t end,double* acc){
+  const T* p = (const T*)data+begin;
+  for(size_t i=0;i<end-begin;i++) acc[i]+=p[i];
+}
+
+template<class T> void StoreValues(void* data,size_t begin,size_t end,const double* values){
+  T* p = (T*)data+begin;
+  for(size_t i=0;i<end-begin;i++) p[i]=(T)values[i];
+}
+
+string RemoveExtension(string filename){
+  size_t pos=filename.rfind('.');
+  size_t slash=filename.rfind('/');
+  if(pos==string::npos || (slash!=string::npos && pos<slash)) return filename;
+  return filename.substr(0,pos);
+}
+
+bool FileExists(string filename){
+  struct stat st;
+  return stat(filename.c_str(),&st)==0;
+}
+
+string Trim(string s){
+  size_t b=s.find_first_not_of(" \t\r");
+  if(b==string::npos) return "";
+  size_t e=s.find_last_not_of(" \t\r");
+  return s.substr(b,e-b+1);
+}
+
+}
+
+/************************************************************************************/
+GateImageMerger::GateImageMerger(int verboseLevel,bool forced,string outDir,int nThreads){
+  m_verboseLevel = verboseLevel;
+  m_forced       =       forced;
+  m_outDir       =       outDir;
+  m_nThreads     =     nThreads;
+  if(m_nThreads<=0) m_nThreads = max(1u,thread::hardware_concurrency());
+}
+
+/************************************************************************************/
+void GateImageMerger::AddActor(string type,string name,vector<string> splitNames,string originalName){
+  Actor actor;
+  actor.type         =         type;
+  actor.name         =         name;
+  actor.splitNames   =   splitNames;
+  actor.originalName = originalName;
+  m_actors.push_back(actor);
+}
+
+/************************************************************************************/
+size_t GateImageMerger::ElementSize(ElementType type){
+  switch(type){
+    case kChar:   return sizeof(char);
+    case kUChar:  return sizeof(unsigned char);
+    case kShort:  return sizeof(short);
+    case kUShort: return sizeof(unsigned short);
+    case kInt:    return sizeof(int);
+    case kUInt:   return sizeof(unsigned int);
+    case kFloat:  return sizeof(float);
+    case kDouble: return sizeof(double);
+    default:      return 0;
+  }
+}
+
+/************************************************************************************/
+bool GateImageMerger::ReadHeader(string filename,MHDHeader& header){
+  ifstream file(filename.c_str());
+  if(!file){
+     cout<<"Can't open image header: "<<filename<<endl;
+     return false;
+  }
+  header.lines.clear();
+  header.dataFileLine = -1;
+  header.totalSumLine = -1;
+  header.type         = kUnknown;
+  header.nbOfValues   = 1;
+  header.dataFileName = "";
+  size_t nbOfChannels = 1;
+  bool hasDimSize = false;
+
+  string line;
+  while(getline(file,line)){
+     header.lines.push_back(line);
+     size_t pos=line.find('=');
+     if(pos==string::npos) continue;
+     string key   = Trim(line.substr(0,pos));
+     string value = Trim(line.substr(pos+1));
+     if(key=="ElementType"){
+        if(value=="MET_CHAR")   header.type=kChar;
+        if(value=="MET_UCHAR")  header.type=kUChar;
+        if(value=="MET_SHORT")  header.type=kShort;
+        if(value=="MET_USHORT") header.type=kUShort;
+        if(value=="MET_INT")    header.type=kInt;
+        if(value=="MET_UINT")   header.type=kUInt;
+        if(value=="MET_FLOAT")  header.type=kFloat;
+        if(value=="MET_DOUBLE") header.type=kDouble;
+     }
+     else if(key=="DimSize"){
+        stringstream ss(value);
+        size_t d;
+        while(ss>>d) header.nbOfValues*=d;
+        hasDimSize=true;
+     }
+     else if(key=="ElementNumberOfChannels"){
+        nbOfChannels=atoi(value.c_str());
+     }
+     else if(key=="TotalSum"){
+        header.totalSumLine=header.lines.size()-1;
+     }
+     else if((key=="CompressedData" || key=="BinaryDataByteOrderMSB") && (value=="True" || value=="true")){
+        cout<<"Image "<<filename<<": "<<key<<" is not handled"<<endl;
+        return false;
+     }
+     else if(key=="ElementDataFile"){
+        if(value=="LOCAL" || value.find(' ')!=string::npos){
+           cout<<"Image "<<filename<<": only a single separate raw data file is handled"<<endl;
+           return false;
+        }
+        header.dataFileLine=header.lines.size()-1;
+        size_t slash=filename.rfind('/');
+        if(value[0]=='/' || slash==string::npos) header.dataFileName=value;
+        else header.dataFileName=filename.substr(0,slash+1)+value;
+     }
+  }
+  header.nbOfValues*=nbOfChannels;
+  if(header.type==kUnknown || !hasDimSize || header.dataFileLine<0){
+     cout<<"Image "<<filename<<": unknown element type or incomplete header"<<endl;
+     return false;
+  }
+  return true;
+}
+
+/************************************************************************************/
+bool GateImageMerger::WriteHeader(string filename,const MHDHeader& header,double totalSum){
+  ofstream file(filename.c_str());
+  if(!file){
+     cout<<"Can't write image header: "<<filename<<endl;
+     return false;
+  }
+  string rawName=RemoveExtension(filename)+".raw";
+  size_t slash=rawName.rfind('/');
+  if(slash!=string::npos) rawName=rawName.substr(slash+1);
+  file.precision(10);
+  for(unsigned int i=0;i<header.lines.size();i++){
+     if((int)i==header.dataFileLine)      file<<"ElementDataFile = "<<rawName<<endl;
+     else if((int)i==header.totalSumLine) file<<"TotalSum = "<<totalSum<<endl;
+     else                                 file<<header.lines[i]<<endl;
+  }
+  return true;
+}
+
+/************************************************************************************/
+// the output file name, in the output directory if the option is used
+string GateImageMerger::OutputName(string name){
+  if(m_outDir=="") return name;
+  size_t pos=name.rfind('/');
+  if(pos==string::npos) return m_outDir+name;
+  return m_outDir+name.substr(pos+1);
+}
+
+/************************************************************************************/
+// the images saved by an actor are named from its 'save' file name: dose1.mhd -> dose1-Dose.mhd,
+// dose1-Dose-Squared.mhd, ... We keep the part after the split file name i.e. "-Dose.mhd", ...
+vector<string> GateImageMerger::FindOutputSuffixes(string splitName){
+  vector<string> suffixes;
+  string stem=RemoveExtension(splitName);
+  string pattern=stem+"*.mhd";
+  glob_t globbuf;
+  if(glob(pattern.c_str(),0,NULL,&globbuf)==0){
+     for(size_t i=0;i<globbuf.gl_pathc;i++){
+        string suffix=string(globbuf.gl_pathv[i]).substr(stem.length());
+        // dose1*.mhd also matches dose10-Dose.mhd
+        if(suffix[0]=='-' || suffix[0]=='.') suffixes.push_back(suffix);
+     }
+  }
+  globfree(&globbuf);
+  return suffixes;
+}
+
+/************************************************************************************/
+bool GateImageMerger::MergeImage(const vector<string>& inputs,string output){
+
+  vector<MHDHeader> headers(inputs.size());
+  for(unsigned int i=0;i<inputs.size();i++){
+     if(!ReadHeader(inputs[i],headers[i])) return false;
+     if(headers[i].type!=headers[0].type || headers[i].nbOfValues!=headers[0].nbOfValues){
+        cout<<"Image "<<inputs[i]<<" has not the same size or type than "<<inputs[0]<<" - not merged"<<endl;
+        return false;
+     }
+  }
+  if(FileExists(output) && !m_forced){
+     cout<<"The output image "<<output<<" already exists! Try -f to overwrite it."<<endl;
+     return false;
+  }
+
+  const ElementType type = headers[0].type;
+  const size_t n = headers[0].nbOfValues;
+  const size_t size = n*ElementSize(type);
+
+  vector<MappedFile> in(inputs.size());
+  MappedFile out;
+  bool ok=true;
+  for(unsigned int i=0;i<inputs.size() && ok;i++){
+     ok=MapFile(headers[i].dataFileName,size,false,in[i]);
+     if(!ok) cout<<"Can't read image data "<<headers[i].dataFileName<<endl;
+  }
+  string rawName=RemoveExtension(output)+".raw";
+  if(ok){
+     ok=MapFile(rawName,size,true,out);
+     if(!ok) cout<<"Can't write image data "<<rawName<<endl;
+  }
+
+  vector<double> partialSums(m_nThreads,0.0);
+  if(ok){
+     if(m_verboseLevel>0) cout<<"Combining "<<inputs.size()<<" images "<<inputs[0]<<" ... -> "<<output<<endl;
+     ParallelChunks(n,m_nThreads,[&](size_t begin,size_t end,int t){
+        vector<double> acc(end-begin,0.0);
+        for(unsigned int i=0;i<in.size();i++){
+           switch(type){
+              case kChar:   AddValues<char>(in[i].data,begin,end,&acc[0]); break;
+              case kUChar:  AddValues<unsigned char>(in[i].data,begin,end,&acc[0]); break;
+              case kShort:  AddValues<short>(in[i].data,begin,end,&acc[0]); break;
+              case kUShort: AddValues<unsigned short>(in[i].data,begin,end,&acc[0]); break;
+              case kInt:    AddValues<int>(in[i].data,begin,end,&acc[0]); break;
+              case kUInt:   AddValues<unsigned int>(in[i].data,begin,end,&acc[0]); break;
+              case kFloat:  AddValues<float>(in[i].data,begin,end,&acc[0]); break;
+              case kDouble: AddValues<double>(in[i].data,begin,end,&acc[0]); break;
+              default: break;
+           }
+        }
+        for(size_t j=0;j<acc.size();j++) partialSums[t]+=acc[j];
+        switch(type){
+           case kChar:   StoreValues<char>(out.data,begin,end,&acc[0]); break;
+           case kUChar:  StoreValues<unsigned char>(out.data,begin,end,&acc[0]); break;
+           case kShort:  StoreValues<short>(out.data,begin,end,&acc[0]); break;
+           case kUShort: StoreValues<unsigned short>(out.data,begin,end,&acc[0]); break;
+           case kInt:    StoreValues<int>(out.data,begin,end,&acc[0]); break;
+           case kUInt:   StoreValues<unsigned int>(out.data,begin,end,&acc[0]); break;
+           case kFloat:  StoreValues<float>(out.data,begin,end,&acc[0]); break;
+           case kDouble: StoreValues<double>(out.data,begin,end,&acc[0]); break;
+           default: break;
+        }
+     });
+  }
+
+  for(unsigned int i=0;i<in.size();i++) UnmapFile(in[i]);
+  UnmapFile(out);
+  if(!ok) return false;
+
+  double totalSum=0.0;
+  for(unsigned int t=0;t<partialSums.size();t++) totalSum+=partialSums[t];
+  return WriteHeader(output,headers[0],totalSum);
+}
+
+/************************************************************************************/
+// same relative uncertainty as GateImageWithStatistic (Chetty2006), from the merged
+// value and squared images; 'templateHeader' gives the output type
+bool GateImageMerger::MergeUncertainty(string value,string squared,string output,long long nbOfEvents){
+
+  MHDHeader valueHeader,squaredHeader;
+  if(!ReadHeader(value,valueHeader) || !ReadHeader(squared,squaredHeader)) return false;
+  if(valueHeader.nbOfValues!=squaredHeader.nbOfValues){
+     cout<<"Images "<<value<<" and "<<squared<<" have not the same size"<<endl;
+     return false;
+  }
+  if(FileExists(output) && !m_forced){
+     cout<<"The output image "<<output<<" already exists! Try -f to overwrite it."<<endl;
+     return false;
+  }
+
+  const size_t n = valueHeader.nbOfValues;
+  MappedFile in,in2,out;
+  string rawName=RemoveExtension(output)+".raw";
+  bool ok = MapFile(valueHeader.dataFileName,n*ElementSize(valueHeader.type),false,in)
+         && MapFile(squaredHeader.dataFileName,n*ElementSize(squaredHeader.type),false,in2)
+         && MapFile(rawName,n*sizeof(double),true,out);
+  if(!ok) cout<<"Can't map image data for "<<output<<endl;
+
+  if(ok){
+     if(m_verboseLevel>0) cout<<"Computing "<<output<<" with "<<nbOfEvents<<" events"<<endl;
+     const double N = nbOfEvents;
+     ParallelChunks(n,m_nThreads,[&](size_t begin,size_t end,int){
+        vector<double> sum(end-begin,0.0),sq(end-begin,0.0);
+        if(valueHeader.type==kFloat) AddValues<float>(in.data,begin,end,&sum[0]);
+        else AddValues<double>(in.data,begin,end,&sum[0]);
+        if(squaredHeader.type==kFloat) AddValues<float>(in2.data,begin,end,&sq[0]);
+        else AddValues<double>(in2.data,begin,end,&sq[0]);
+        for(size_t j=0;j<sum.size();j++){
+           if(sum[j]!=0.0 && N!=1 && sq[j]!=0.0)
+              sum[j]=sqrt((1.0/(N-1))*(sq[j]/N-pow(sum[j]/N,2)))/(sum[j]/N);
+           else sum[j]=1.0;
+        }
+        StoreValues<double>(out.data,begin,end,&sum[0]);
+     });
+  }
+  UnmapFile(in);
+  UnmapFile(in2);
+  UnmapFile(out);
+  if(!ok) return false;
+
+  // the uncertainty is always written as double, as GateImageWithStatistic does
+  MHDHeader header=valueHeader;
+  for(unsigned int i=0;i<header.lines.size();i++)
+     if(header.lines[i].find("ElementType")==0) header.lines[i]="ElementType = MET_DOUBLE";
+  return WriteHeader(output,header,0.0);
+}
+
+/************************************************************************************/
+// total number of primaries of all the jobs, from the first SimulationStatisticActor
+long long GateImageMerger::ReadNumberOfEvents(const Actor& actor){
+  long long total=0;
+  for(unsigned int i=0;i<actor.splitNames.size();i++){
+     ifstream file(actor.splitNames[i].c_str());
+     if(!file){
+        cout<<"Can't open statistics file "<<actor.splitNames[i]<<endl;
+        return 0;
+     }
+     string line;
+     bool found=false;
+     while(getline(file,line)){
+        size_t pos=line.find("NumberOfEvents");
+        size_t eq=line.find('=');
+        if(pos!=string::npos && eq!=string::npos){
+           total+=atoll(line.c_str()+eq+1);
+           found=true;
+           break;
+        }
+     }
+     if(!found){
+        cout<<"No NumberOfEvents in "<<actor.splitNames[i]<<endl;
+        return 0;
+     }
+  }
+  return total;
+}
+
+/************************************************************************************/
+void GateImageMerger::MergeActors(){
+
+  long long nbOfEvents=0;
+  for(unsigned int a=0;a<m_actors.size();a++){
+     if(m_actors[a].type=="SimulationStatisticActor"){
+        nbOfEvents=ReadNumberOfEvents(m_actors[a]);
+        break;
+     }
+  }
+
+  for(unsigned int a=0;a<m_actors.size();a++){
+     const Actor& actor=m_actors[a];
+     if(actor.type=="SimulationStatisticActor") continue;
+     vector<string> suffixes=FindOutputSuffixes(actor.splitNames[0]);
+     if(suffixes.empty()){
+        if(m_verboseLevel>1) cout<<"No image found for actor "<<actor.name<<endl;
+        continue;
+     }
+
+     // sums first, the uncertainties are computed from the merged sums
+     vector<string> uncertainties;
+     for(unsigned int s=0;s<suffixes.size();s++){
+        if(suffixes[s].find("-Uncertainty.")!=string::npos){
+           uncertainties.push_back(suffixes[s]);
+           continue;
+        }
+        vector<string> inputs;
+        for(unsigned int i=0;i<actor.splitNames.size();i++)
+           inputs.push_back(RemoveExtension(actor.splitNames[i])+suffixes[s]);
+        string output=OutputName(RemoveExtension(actor.originalName)+suffixes[s]);
+        if(!MergeImage(inputs,output)) cout<<"Problem with merging "<<output<<endl;
+     }
+
+     for(unsigned int s=0;s<uncertainties.size();s++){
+        string output=OutputName(RemoveExtension(actor.originalName)+uncertainties[s]);
+        if(nbOfEvents<=1){
+           cout<<"Can't compute "<<output<<": the number of events is unknown"
+               <<" (add a SimulationStatisticActor to the macro)"<<endl;
+           continue;
+        }
+        string valueSuffix=uncertainties[s];
+        valueSuffix.erase(valueSuffix.find("-Uncertainty."),12);
+        string squaredSuffix=RemoveExtension(valueSuffix)+"-Squared"+valueSuffix.substr(RemoveExtension(valueSuffix).length());
+        string value=OutputName(RemoveExtension(actor.originalName)+valueSuffix);
+        string squared=OutputName(RemoveExtension(actor.originalName)+squaredSuffix);
+        if(!FileExists(value) || !FileExists(squared)){
+           cout<<"Can't compute "<<output<<": the squared image is needed (enableSquared...)"<<endl;
+           continue;
+        }
+        if(!MergeUncertainty(value,squared,output,nbOfEvents)) cout<<"Problem with merging "<<output<<endl;
+     }
+  }
+}
@@ -19,6 +19,8 @@ See GATE/LICENSE.txt for further details
 #include <TKey.h>
 #include <TH1.h>
 #include <TH2.h>
+#include <TLeaf.h>
+#include <TObjArray.h>
 
 #include <iostream>
 #include <fstream>
@@ -31,6 +33,10 @@ See GATE/LICENSE.txt for further details
 #include <cmath>
 
 #include "GateMergeManager.hh"
+#include "GateImageMerger.hh"
+#include "GateOfflineCoincidenceSorter.hh"
+#include <queue>
+#include <functional>
 
 using namespace std;
 
@@ -39,8 +45,12 @@ void GateMergeManager::StartMerging(string splitfileName){
   // get the files to merge
   ReadSplitFile(splitfileName);
   //do the merging
-  if (m_fastMerge==true) FastMergeRoot();
-  else MergeRoot();
+  bool hasRoot = m_vRootFileNames.size()>0 || m_RootTargetName!="";
+  if (hasRoot || m_vActorFileNames.size()==0) {
+     if (m_fastMerge==true) FastMergeRoot();
+     else MergeRoot();
+  }
+  if (m_vActorFileNames.size()>0) MergeActorImages();
 
   //if we are here the merging has been successful
   //we mark the directory as ready for cleanup
@@ -86,6 +96,22 @@ void GateMergeManager::ReadSplitFile(string splitfileName){
         if(m_verboseLevel>2) cout<<"Root input file name: "<<m_vRootFileNames[iRoot]<<endl;
         iRoot++;
      }
+     // actor output files: type name split_file_name original_file_name
+     else if(!strncmp(cline,"Actor filename:",15)){
+        stringstream ss(cline+15);
+        string type,name,file,original;
+        ss>>type>>name>>file>>original;
+        unsigned int iActor=0;
+        while(iActor<m_vActorTargetNames.size() && m_vActorTargetNames[iActor]!=original) iActor++;
+        if(iActor==m_vActorTargetNames.size()){
+           m_vActorTypes.push_back(type);
+           m_vActorNames.push_back(name);
+           m_vActorTargetNames.push_back(original);
+           m_vActorFileNames.push_back(vector<string>());
+        }
+        m_vActorFileNames[iActor].push_back(file);
+        if(m_verboseLevel>2) cout<<"Actor "<<name<<" input file name: "<<file<<endl;
+     }
      // output file
      else if(!strncmp(cline,"Original Root filename:",23)){
         m_RootTargetName=strtok(cline+23," ");
@@ -106,6 +132,21 @@ void GateMergeManager::ReadSplitFile(string splitfileName){
        cout<<"Inconsistent number of root file entries in split file!"<<endl;
        exit(0);
   }
+  for(unsigned int i=0;i<m_vActorFileNames.size();i++){
+     if((int)m_vActorFileNames[i].size()!=m_Nfiles) {
+        cout<<"Inconsistent number of actor file entries in split file for "<<m_vActorNames[i]<<"!"<<endl;
+        exit(0);
+     }
+  }
+}
+
+/************************************************************************************/
+// sum the images saved by the actors (dose, squared, ...) and recompute the uncertainties
+void GateMergeManager::MergeActorImages(){
+  GateImageMerger merger(m_verboseLevel,m_forced,m_outDir,m_nThreads);
+  for(unsigned int i=0;i<m_vActorFileNames.size();i++)
+     merger.AddActor(m_vActorTypes[i],m_vActorNames[i],m_vActorFileNames[i],m_vActorTargetNames[i]);
+  merger.MergeActors();
 }
 
 /************************************************************************************/
@@ -389,6 +430,10 @@ if (m_fastMerge==false)
              return false;
             }
            // Singles or Hits
+           if(m_timeOrdered && chainName.find("Singles",0)!=string::npos) {
+              delete chain;
+              return MergeSingTimeOrdered(chainName);
+           }
            return MergeSing(chain);
    }
    else
@@ -685,6 +730,234 @@ bool GateMergeManager::MergeSing(TChain* chainS){
     return true;
 }
 
+/*******************************************************************************************/
+// Singles tree merger keeping the time order across the files: k-way merge of the
+// (time ordered) singles of all files, reading ahead only m_bufferSize times per file.
+// The merged stream can feed an offline coincidence sorter, so that the coincidences
+// between singles of different jobs (time slices) are not lost.
+bool GateMergeManager::MergeSingTimeOrdered(string name){
+
+   int nfiles=m_vRootFileNames.size();
+   vector<TFile*> files(nfiles);
+   vector<TTree*> trees(nfiles);
+   for(int i=0;i<nfiles;i++){
+      files[i]=TFile::Open(m_vRootFileNames[i].c_str(),"OLD");
+      if(files[i]==NULL){
+         cout<<"Not a readable file "<<m_vRootFileNames[i]<<" - exit!"<<endl;
+         exit(0);
+      }
+      trees[i]=(TTree*)files[i]->Get(name.c_str());
+      if(trees[i]==NULL){
+         cout<<"No tree "<<name<<" in "<<m_vRootFileNames[i]<<endl;
+         return false;
+      }
+   }
+
+   int eventID = 0;
+   int runID   = 0;
+   double time = 0;
+
+   // all files read into the same buffers (one leaf per branch in Gate trees)
+   vector<vector<char> > buffers;
+   TObjArray* branches=trees[0]->GetListOfBranches();
+   buffers.resize(branches->GetEntries());
+   for(int b=0;b<branches->GetEntries();b++){
+      TBranch* branch=(TBranch*)branches->At(b);
+      TLeaf* leaf=(TLeaf*)branch->GetListOfLeaves()->At(0);
+      void* address=NULL;
+      string bname=branch->GetName();
+      if(bname=="eventID")   address=&eventID;
+      else if(bname=="runID") address=&runID;
+      else if(bname=="time")  address=&time;
+      else {
+         buffers[b].resize(max(1024,leaf->GetLenStatic()*leaf->GetLenType()));
+         address=&buffers[b][0];
+      }
+      for(int i=0;i<nfiles;i++) trees[i]->SetBranchAddress(bname.c_str(),address);
+   }
+   vector<TBranch*> timeBranches(nfiles);
+   for(int i=0;i<nfiles;i++) timeBranches[i]=trees[i]->GetBranch("time");
+
+   m_RootTarget->cd();
+   TTree * newSing = trees[0]->CloneTree(0);
+   newSing->SetAutoSave(2000000000);
+   if(m_maxRoot!=0) newSing->SetMaxTreeSize(m_maxRoot);
+   else newSing->SetMaxTreeSize(17179869184LL);
+
+   // changing CompLevel everywhere
+   TBranch *br;
+   TIter next(newSing->GetListOfBranches());
+   while ((br=(TBranch*)next())) br->SetCompressionLevel(m_CompLevel);
+
+   // the offline coincidences: scalar Int/Float/Double leaves of the singles
+   // are written twice (name1, name2), except the ones of the Gate coincidences
+   // tree which are not by single
+   struct CoincLeaf {
+      TLeaf*  leaf;
+      char    type;
+      bool    perSingle;
+      Int_t    i[2];
+      Float_t  f[2];
+      Double_t d[2];
+   };
+   vector<CoincLeaf> coincLeaves;
+   TTree* newCoin=NULL;
+   GateOfflineCoincidenceSorter* sorter=NULL;
+   int energyIndex=-1;
+   int sectorIndex=-1;
+   if(m_coincWindow>0){
+      TObjArray* leaves=newSing->GetListOfLeaves();
+      for(int l=0;l<leaves->GetEntries();l++){
+         TLeaf* leaf=(TLeaf*)leaves->At(l);
+         string type=leaf->GetTypeName();
+         if(leaf->GetLenStatic()!=1 || leaf->GetLeafCount()) continue;
+         CoincLeaf c;
+         c.leaf=leaf;
+         if(type=="Int_t")         c.type='I';
+         else if(type=="Float_t")  c.type='F';
+         else if(type=="Double_t") c.type='D';
+         else continue;
+         string lname=leaf->GetName();
+         c.perSingle=!(lname=="runID" || lname=="axialPos" || lname=="rotationAngle");
+         if(lname=="energy")    energyIndex=coincLeaves.size();
+         if(lname=="rsectorID") sectorIndex=coincLeaves.size();
+         coincLeaves.push_back(c);
+      }
+      if(energyIndex<0){
+         cout<<"No energy branch in "<<name<<" - no offline coincidence sorting"<<endl;
+      }
+      else {
+         if(m_coincSectorNumber>0 && sectorIndex<0)
+            cout<<"No rsectorID branch in "<<name<<" - no sector difference check"<<endl;
+         string coinName=name.substr(0,name.find("Singles"))+"OfflineCoincidences";
+         newCoin=new TTree(coinName.c_str(),"Coincidences sorted offline by gjm");
+         newCoin->SetAutoSave(2000000000);
+         if(m_maxRoot!=0) newCoin->SetMaxTreeSize(m_maxRoot);
+         else newCoin->SetMaxTreeSize(17179869184LL);
+         for(unsigned int l=0;l<coincLeaves.size();l++){
+            CoincLeaf& c=coincLeaves[l];
+            string lname=c.leaf->GetName();
+            for(int k=0;k<(c.perSingle?2:1);k++){
+               string bname=lname+(c.perSingle?(k==0?"1":"2"):"");
+               void* address = c.type=='I' ? (void*)&c.i[k] : c.type=='F' ? (void*)&c.f[k] : (void*)&c.d[k];
+               newCoin->Branch(bname.c_str(),address,(bname+"/"+c.type).c_str());
+            }
+         }
+         TIter nextc(newCoin->GetListOfBranches());
+         while ((br=(TBranch*)nextc())) br->SetCompressionLevel(m_CompLevel);
+
+         GateOfflineCoincidenceSorter::CoincidenceOutput output=
+            [&](const GateOfflineCoincidenceSorter::Single& s1,const GateOfflineCoincidenceSorter::Single& s2){
+               for(unsigned int l=0;l<coincLeaves.size();l++){
+                  CoincLeaf& c=coincLeaves[l];
+                  for(int k=0;k<(c.perSingle?2:1);k++){
+                     double v=(k==0?s1:s2).values[l];
+                     if(c.type=='I') c.i[k]=(Int_t)v;
+                     else if(c.type=='F') c.f[k]=(Float_t)v;
+                     else c.d[k]=v;
+                  }
+               }
+               newCoin->Fill();
+            };
+         int sectorNumber = sectorIndex<0 ? 0 : m_coincSectorNumber;
+         sorter=new GateOfflineCoincidenceSorter(m_coincWindow,m_coincOffset,m_coincPolicy,m_coincAllOpen,
+                                                 m_coincMinSectorDiff,sectorNumber,output);
+      }
+   }
+
+   vector<Long64_t> nEntries(nfiles),nextEntry(nfiles,0),bufferStart(nfiles,0);
+   for(int i=0;i<nfiles;i++) nEntries[i]=trees[i]->GetEntries();
+
+   // the eventID offset of each file, as MergeSing computes it reading the files one
+   // after the other: the offset of a file is added to its entries until the runID
+   // changes (new run), after which the eventIDs are not changed anymore.
+   // A first pass on the runID branch gives the entry of each file where this happens.
+   vector<int> offsets(nfiles,0);
+   vector<Long64_t> runChange(nfiles,0);
+   int offset   = 0;
+   float lastRun = 0;
+   for(int i=0;i<nfiles;i++){
+      if(i>0) offset+=m_lastEvents[i];
+      offsets[i]=offset;
+      runChange[i]=nEntries[i];
+      TBranch* runBranch=trees[i]->GetBranch("runID");
+      for(Long64_t j=0;j<nEntries[i];j++){
+         runBranch->GetEntry(j);
+         if(lastRun!=runID){
+            lastRun=runID;
+            if(runChange[i]==nEntries[i]) runChange[i]=j;
+            offset=0;
+         }
+      }
+   }
+
+   // read ahead buffers of the times of each file
+   vector<vector<double> > times(nfiles);
+   auto fillTimes=[&](int i){
+      bufferStart[i]=nextEntry[i];
+      Long64_t n=min((Long64_t)m_bufferSize,nEntries[i]-nextEntry[i]);
+      times[i].resize(n);
+      for(Long64_t j=0;j<n;j++){
+         timeBranches[i]->GetEntry(bufferStart[i]+j);
+         times[i][j]=time;
+      }
+   };
+
+   typedef pair<double,int> HeapEntry; // time, file
+   priority_queue<HeapEntry,vector<HeapEntry>,greater<HeapEntry> > heap;
+   for(int i=0;i<nfiles;i++){
+      if(nEntries[i]==0) continue;
+      fillTimes(i);
+      heap.push(HeapEntry(times[i][0],i));
+   }
+
+   if(m_verboseLevel>0) cout<<"Time ordered merging of "<<name<<" from "<<nfiles<<" files"<<endl;
+   double lastTime=-1e300;
+   bool warned=false;
+   GateOfflineCoincidenceSorter::Single single;
+   while(!heap.empty()){
+      int i=heap.top().second;
+      heap.pop();
+      trees[i]->GetEntry(nextEntry[i]);
+      if(nextEntry[i]<runChange[i]) eventID+=offsets[i];
+      if(time<lastTime && !warned){
+         // the files themselves are not time ordered
+         if(m_verboseLevel>0) cout<<"Warning - Singles not time ordered in file: "<<m_vRootFileNames[i]<<endl;
+         warned=true;
+      }
+      lastTime=time;
+      newSing->Fill();
+
+      if(sorter){
+         single.time=time;
+         single.values.resize(coincLeaves.size());
+         for(unsigned int l=0;l<coincLeaves.size();l++) single.values[l]=coincLeaves[l].leaf->GetValue();
+         single.energy=single.values[energyIndex];
+         single.sectorID=sectorIndex<0 ? 0 : (int)single.values[sectorIndex];
+         sorter->ProcessSingle(single);
+      }
+
+      nextEntry[i]++;
+      if(nextEntry[i]<nEntries[i]){
+         if(nextEntry[i]-bufferStart[i]>=(Long64_t)times[i].size()) fillTimes(i);
+         heap.push(HeapEntry(times[i][nextEntry[i]-bufferStart[i]],i));
+      }
+   }
+   newSing->Write();
+   delete newSing;
+
+   if(sorter){
+      sorter->Flush();
+      if(m_verboseLevel>0) cout<<sorter->GetNumberOfCoincidences()<<" offline coincidences in "<<newCoin->GetName()<<endl;
+      m_RootTarget->cd();
+      newCoin->Write();
+      delete newCoin;
+      delete sorter;
+   }
+   for(int i=0;i<nfiles;i++) files[i]->Close();
+   return true;
+}
+
 /*******************************************************************************************/
 // Coincidences tree merger
 bool GateMergeManager::MergeCoin(TChain* chainC){
@@ -0,0 +1,201 @@
+/*----------------------
+   GATE version name: gate_v...
+
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See GATE/LICENSE.txt for further details
+----------------------*/
+
+
+#include <iostream>
+#include <algorithm>
+
+#include "GateOfflineCoincidenceSorter.hh"
+
+using namespace std;
+
+/************************************************************************************/
+GateOfflineCoincidenceSorter::GateOfflineCoincidenceSorter(double window,double offset,string policy,
+                                                           bool allSinglesOpenWindow,int minSectorDifference,
+                                                           int sectorNumber,CoincidenceOutput output){
+  m_window               =               window;
+  m_offset               =               offset;
+  m_allSinglesOpenWindow = allSinglesOpenWindow;
+  m_minSectorDifference  =  minSectorDifference;
+  m_sectorNumber         =         sectorNumber;
+  m_output               =               output;
+  m_nbOfCoincidences     =                    0;
+
+  // same names and default as /gate/digitizer/Coincidences/MultiplesPolicy
+  if (policy=="takeWinnerOfGoods")            m_multiplesPolicy=kTakeWinnerOfGoods;
+  else if (policy=="takeWinnerIfIsGood")      m_multiplesPolicy=kTakeWinnerIfIsGood;
+  else if (policy=="takeWinnerIfAllAreGoods") m_multiplesPolicy=kTakeWinnerIfAllAreGoods;
+  else if (policy=="killAll")                 m_multiplesPolicy=kKillAll;
+  else if (policy=="takeAllGoods")            m_multiplesPolicy=kTakeAllGoods;
+  else if (policy=="killAllIfMultipleGoods")  m_multiplesPolicy=kKillAllIfMultipleGoods;
+  else if (policy=="keepIfAnyIsGood")         m_multiplesPolicy=kKeepIfAnyIsGood;
+  else if (policy=="keepIfOnlyOneGood")       m_multiplesPolicy=kKeepIfOnlyOneGood;
+  else if (policy=="keepAll")                 m_multiplesPolicy=kKeepAll;
+  else {
+     if (policy!="keepIfAllAreGoods")
+        cout<<"WARNING : policy not recognized, using default : keepMultiplesIfAllAreGoods"<<endl;
+     m_multiplesPolicy=kKeepIfAllAreGoods;
+  }
+}
+
+/************************************************************************************/
+void GateOfflineCoincidenceSorter::ProcessSingle(const Single& single){
+
+  // process completed coincidence windows at front of list
+  while(!m_windows.empty() && single.time>=m_windows.front().endTime){
+     ProcessCompletedWindow(m_windows.front());
+     m_windows.pop_front();
+  }
+
+  // add the single to the open windows
+  bool inCoincidence=false;
+  deque<Window>::iterator it=m_windows.begin();
+  while(it!=m_windows.end() && single.time>=it->startTime && single.time<it->endTime){
+     inCoincidence=true;
+     it->singles.push_back(single);
+     it++;
+  }
+
+  // open a new window
+  if(m_allSinglesOpenWindow || !inCoincidence){
+     Window window;
+     window.startTime = single.time+m_offset;
+     window.endTime   = window.startTime+m_window;
+     window.delayed   = m_offset>0.0;
+     window.singles.push_back(single);
+     m_windows.push_back(window);
+  }
+}
+
+/************************************************************************************/
+void GateOfflineCoincidenceSorter::Flush(){
+  while(!m_windows.empty()){
+     ProcessCompletedWindow(m_windows.front());
+     m_windows.pop_front();
+  }
+}
+
+/************************************************************************************/
+void GateOfflineCoincidenceSorter::Store(const Single& single1,const Single& single2){
+  m_nbOfCoincidences++;
+  m_output(single1,single2);
+}
+
+/************************************************************************************/
+bool GateOfflineCoincidenceSorter::IsForbiddenCoincidence(const Single& single1,const Single& single2) const{
+  if(m_sectorNumber<=0) return false;
+  // deal with the circular difference problem
+  int sectorDiff1 = single1.sectorID-single2.sectorID;
+  if (sectorDiff1<0) sectorDiff1 += m_sectorNumber;
+  int sectorDiff2 = single2.sectorID-single1.sectorID;
+  if (sectorDiff2<0) sectorDiff2 += m_sectorNumber;
+  return min(sectorDiff1,sectorDiff2)<m_minSectorDifference;
+}
+
+/************************************************************************************/
+// look for valid coincidences, as GateCoincidenceSorter::ProcessCompletedCoincidenceWindow;
+// multiples kept as a whole (keep* policies) are written as the pair of their first two singles
+void GateOfflineCoincidenceSorter::ProcessCompletedWindow(const Window& coincidence){
+  int i,j;
+  int nGoods,maxGoods;
+  double E,maxE;
+  int winner_i=0;
+  int winner_j=1;
+
+  const vector<Single>& s=coincidence.singles;
+  const int nSingles=s.size();
+
+  if(nSingles<2) return;
+  if(nSingles==2){
+     if(!IsForbiddenCoincidence(s[0],s[1])) Store(s[0],s[1]);
+     return;
+  }
+
+  // multiples
+  if(m_multiplesPolicy==kKillAll) return;
+
+  // if dealing with a delayed window or if other singles open coincidence windows,
+  // we only want to pair with the first single to avoid invalid pairs, or double counting
+  const bool pairWithFirstOnly = m_allSinglesOpenWindow || coincidence.delayed;
+
+  if(m_multiplesPolicy==kTakeAllGoods){
+     for(i=0;i<(pairWithFirstOnly?1:(nSingles-1));i++)
+        for(j=i+1;j<nSingles;j++)
+           if(!IsForbiddenCoincidence(s[i],s[j])) Store(s[i],s[j]);
+     return;
+  }
+
+  // count the goods
+  nGoods=0;
+  for(i=0;i<(coincidence.delayed?1:(nSingles-1));i++)
+     for(j=i+1;j<nSingles;j++)
+        if(!IsForbiddenCoincidence(s[i],s[j])) nGoods++;
+  if(nGoods==0) return;
+
+  if( (m_multiplesPolicy==kKeepIfAnyIsGood) ||
+      ((m_multiplesPolicy==kKeepIfOnlyOneGood) && (nGoods==1)) ||
+      ((m_multiplesPolicy==kKeepIfAllAreGoods) && (nGoods==(nSingles*(nSingles-1)/2))) ){
+     Store(s[0],s[1]);
+     return;
+  }
+  if( (m_multiplesPolicy==kKeepIfAnyIsGood) ||
+      (m_multiplesPolicy==kKeepIfOnlyOneGood) ||
+      (m_multiplesPolicy==kKeepIfAllAreGoods) ) return;
+
+  // find winner and count the goods
+  maxE=0.0;
+  nGoods=0;
+  for(i=0;i<(pairWithFirstOnly?1:(nSingles-1));i++)
+     for(j=i+1;j<nSingles;j++){
+        if(!IsForbiddenCoincidence(s[i],s[j])) nGoods++;
+        E=s[i].energy+s[j].energy;
+        if(E>maxE){
+           maxE=E;
+           winner_i=i;
+           winner_j=j;
+        }
+     }
+  if(nGoods==0) return;
+
+  if(m_multiplesPolicy==kTakeWinnerIfIsGood){
+     if(!IsForbiddenCoincidence(s[winner_i],s[winner_j])) Store(s[winner_i],s[winner_j]);
+     return;
+  }
+
+  if(m_multiplesPolicy==kKillAllIfMultipleGoods){
+     if(nGoods>1) return;
+     for(i=0;i<(coincidence.delayed?1:(nSingles-1));i++)
+        for(j=i+1;j<nSingles;j++)
+           if(!IsForbiddenCoincidence(s[i],s[j])) Store(s[i],s[j]);
+     return;
+  }
+
+  maxGoods=pairWithFirstOnly?(nSingles-1):(nSingles*(nSingles-1)/2);
+  if(m_multiplesPolicy==kTakeWinnerIfAllAreGoods){
+     if(nGoods==maxGoods) Store(s[winner_i],s[winner_j]);
+     return;
+  }
+
+  if(m_multiplesPolicy==kTakeWinnerOfGoods){
+     maxE=0.0;
+     for(i=0;i<(pairWithFirstOnly?1:(nSingles-1));i++)
+        for(j=i+1;j<nSingles;j++){
+           if(!IsForbiddenCoincidence(s[i],s[j])){
+              E=s[i].energy+s[j].energy;
+              if(E>maxE){
+                 maxE=E;
+                 winner_i=i;
+                 winner_j=j;
+              }
+           }
+        }
+     Store(s[winner_i],s[winner_j]);
+  }
+}
@@ -925,8 +925,14 @@ void GateMacfileParser::SearchForActors(G4int splitNumber,ofstream& output, ofst
     // If it is the case we registered this actor as enabled and we split its filename
     if (findInList)
     {
+      G4String key = "/gate/actor/"+actorName+"/save";
+      string originalFileName, splitFileName;
+      istringstream(ExtractFileName(key)) >> originalFileName;
       AddSplitNumberWithExtension(splitNumber);
-      AddPWD("/gate/actor/"+actorName+"/save");
+      AddPWD(key);
+      istringstream(ExtractFileName(key)) >> splitFileName;
+      // for the merging of the actor outputs (gjm)
+      splitfile<<"Actor filename: "<<listOfEnabledActorType.back()<<" "<<actorName<<" "<<splitFileName<<" "<<originalFileName<<endl;
     }
     // Else, it is an error, this actor does not exist !
     else
@@ -0,0 +1,138 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+/*
+ *	\file GateDigit_offline_digitizer.cc
+ *
+ *	Offline digitizer: reads the Hits tree of a Gate ROOT output by batches and
+ *	runs the pulse-processor chains on each event, without any Geant4 event.
+ *	All the single chains defined in the macro are independent configurations,
+ *	evaluated in the same pass over the hits: each one is written in its own
+ *	tree, named after the chain.
+ */
+
+#include "GateMessageManager.hh"
+#include "G4UImanager.hh"
+#include "GateDigitizer.hh"
+#include "GateSingleDigi.hh"
+#include "GateRootDefs.hh"
+#include "GateHitBatchReader.hh"
+
+#include "GateDetectorConstruction.hh"
+#include "GateRunManager.hh"
+#include "GateSignalHandler.hh"
+
+#include "TFile.h"
+
+#include <cstdlib>
+#include <chrono>
+
+int main(int argc, char *argv[])
+{
+    // Usage
+    std::ostringstream usage;
+    usage << std::endl
+          << "GateDigit_offline_digitizer" << std::endl
+          << "Process the hits of a Gate ROOT output to provide singles" << std::endl
+          << "All the single chains of the macro are evaluated in one pass, e.g." << std::endl
+          << "   /gate/digitizer/Singles/insert adder" << std::endl
+          << "   /gate/digitizer/name LowThreshold" << std::endl
+          << "   /gate/digitizer/insert singleChain" << std::endl
+          << "   /gate/digitizer/LowThreshold/insert adder" << std::endl
+          << "Usage : " << argv[0] << " <hits.root> <singles.root> <options.mac> [hits per batch]" << std::endl;
+
+    // Get user parameters
+    if (argc != 4 && argc != 5) {
+        std::cout << "Need 3 or 4 parameters" << std::endl
+                  << usage.str() << std::endl;
+        exit(0);
+    }
+    std::string hits_filePathName = argv[1];
+    std::string singles_filePathName = argv[2];
+    std::string options_macrofile = argv[3];
+    size_t batchSize = 1000000;
+    if (argc == 5) batchSize = atol(argv[4]);
+    if (batchSize == 0) {
+        std::cout << "The number of hits per batch must be positive" << std::endl
+                  << usage.str() << std::endl;
+        exit(0);
+    }
+
+    // GATE Initialisation
+    // First of all, set the G4cout to our message manager
+    GateMessageManager* theGateMessageManager = GateMessageManager::GetInstance();
+    G4UImanager::GetUIpointer()->SetCoutDestination( theGateMessageManager );
+    GateSignalHandler::Install();
+
+    // The run manager is only needed for the macro commands (geometry, system):
+    // no run is started and no event is generated
+    GateRunManager* runManager = new GateRunManager;
+    GateDetectorConstruction* gateDC = new GateDetectorConstruction();
+    runManager->SetUserInitialization( gateDC );
+    runManager->SetUserInitialization( GatePhysicsList::GetInstance() );
+
+    // Default chain, as in a Gate simulation; others are inserted by the macro
+    GateDigitizer* digitizer = GateDigitizer::GetInstance();
+    digitizer->StoreNewPulseProcessorChain(new GatePulseProcessorChain(digitizer, "Singles"));
+
+    std::cout << "Reading " << options_macrofile << " ..." << std::endl;
+    G4UImanager::GetUIpointer()->ApplyCommand( "/control/execute " + options_macrofile );
+    std::cout << "Done" << std::endl;
+
+    // One tree per chain
+    TFile* pTfile = new TFile(singles_filePathName.c_str(),"RECREATE");
+    size_t nbOfChains = digitizer->GetChainNumber();
+    std::vector<GateSingleTree*> singleTrees(nbOfChains);
+    std::vector<GateRootSingleBuffer> singleBuffers(nbOfChains);
+    std::vector<long> nbOfSingles(nbOfChains,0);
+    for (size_t c=0; c<nbOfChains; c++) {
+        singleTrees[c] = new GateSingleTree(digitizer->GetChain(c)->GetOutputName());
+        singleTrees[c]->Init(singleBuffers[c]);
+        // GateSingleTree::Init() autosaves every 1000 bytes, far too often for this use
+        singleTrees[c]->SetAutoSave(300000000);
+    }
+
+    // Read the hits by batches
+    GateHitBatchReader hitReader(hits_filePathName, batchSize);
+    long nbOfEvents = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    while (hitReader.ReadBatch()) {
+        for (size_t e=0; e<hitReader.GetNumberOfEvents(); e++) {
+            const std::vector<GateCrystalHit*>& hits = hitReader.GetEvent(e);
+            nbOfEvents++;
+            if (hits.empty()) continue;
+            digitizer->Digitize(hits);
+
+            // Save the pulses of each chain
+            for (size_t c=0; c<nbOfChains; c++) {
+                GatePulseList* pPulseList = digitizer->FindPulseList(digitizer->GetChain(c)->GetOutputName());
+                if (!pPulseList) continue;
+                for (GatePulseConstIterator iterIn = pPulseList->begin(); iterIn != pPulseList->end(); ++iterIn) {
+                    GateSingleDigi aSingleDigi(*iterIn);
+                    singleBuffers[c].Fill(&aSingleDigi);
+                    singleTrees[c]->Fill();
+                    singleBuffers[c].Clear();
+                    nbOfSingles[c]++;
+                }
+            }
+        }
+        std::cout << hitReader.GetCurrentEntry() << "/" << hitReader.GetEntries() << " hits processed" << std::endl;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+    std::cout << nbOfEvents << " events digitized in " << elapsed.count() << " s" << std::endl;
+    for (size_t c=0; c<nbOfChains; c++)
+        std::cout << "   " << digitizer->GetChain(c)->GetOutputName() << ": " << nbOfSingles[c] << " singles" << std::endl;
+
+    pTfile->Write();
+    pTfile->Close();
+
+    delete runManager;
+
+    return 0;
+}
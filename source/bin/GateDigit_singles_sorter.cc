@@ -18,6 +18,7 @@
 #include "GateSignalHandler.hh"
 
 #include <cstdlib>
+#include <chrono>
 
 using std::cout;
 using std::endl;
@@ -96,6 +97,10 @@ int main(int argc, char *argv[])
 
      int coincID=0;
 
+     // Sorter throughput, measured on the replayed singles stream
+     long nbSingles=0;
+     std::chrono::duration<double> sorterTime(0);
+
      //Read singles file
      GateCCSinglesFileReader* m_singlesFileReader= GateCCSinglesFileReader::GetInstance(singles_filePathName);
      m_singlesFileReader->PrepareAcquisition();
@@ -105,7 +110,11 @@ int main(int argc, char *argv[])
          // cout<<"ErasepulseListt"<<endl;
          digitizer->ErasePulseListVector();
          //cout<<"ProcessingSingleList"<<endl;
-         coincidenceSorter->ProcessSinglePulseList(m_singlesFileReader->PrepareEndOfEvent());
+         GatePulseList* singlesList=m_singlesFileReader->PrepareEndOfEvent();
+         if(singlesList) nbSingles+=singlesList->size();
+         auto start = std::chrono::high_resolution_clock::now();
+         coincidenceSorter->ProcessSinglePulseList(singlesList);
+         sorterTime += std::chrono::high_resolution_clock::now() - start;
          std::vector<GateCoincidencePulse*> coincPulseVector=digitizer->FindCoincidencePulse("Coincidences");
 
          //std::cout<<" from digitizer coind pulse LsitAlias vetcot="<<digitizer->m_coincidencePulseListAliasVector.size()<<G4endl;
@@ -138,6 +147,12 @@ int main(int argc, char *argv[])
      pTfile->Write();
      m_singlesFileReader->TerminateAfterAcquisition();
 
+     std::cout << "Sorted " << nbSingles << " singles into " << coincID << " coincidences in "
+               << sorterTime.count() << " s";
+     if(sorterTime.count()>0)
+         std::cout << " (" << nbSingles/sorterTime.count() << " singles/s)";
+     std::cout << std::endl;
+
 
     return 0;
 }
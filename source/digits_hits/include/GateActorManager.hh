@@ -39,6 +39,7 @@ See LICENSE.md for further details
 
 class GateVActor;
 class GateMultiSensitiveDetector;
+class GateFilterManager;
 
 class GateActorManager
 {
@@ -115,6 +116,15 @@ protected:
   std::vector<GateVActor*> theListOfActorsEnabledForUserSteppingAction;
   std::vector<GateVActor*> theListOfActorsEnabledForRecordEndOfAcquisition;
 
+  /// Resolve all actor filters and group identical step filter chains
+  void InitializeFilters();
+  /// Distinct filter chains of the stepping actors, evaluated once per step
+  std::vector<GateFilterManager*> theListOfStepFilterChains;
+  /// Index in theListOfStepFilterChains for each stepping actor (-1: no filter)
+  std::vector<G4int> theStepFilterChainIndex;
+  /// Per step result of each chain (-1: not evaluated, 0: rejected, 1: accepted)
+  std::vector<G4int> theStepFilterChainResults;
+
   GateActorManagerMessenger* pActorManagerMessenger;  //pointer to the Messenger
   G4int mCurrentEventId;
 
@@ -46,6 +46,7 @@ protected:
   G4UIcmdWithAString*   pSetVolumeNameCmd;
   G4UIcmdWithAnInteger* pSaveEveryNEventsCmd;
   G4UIcmdWithAnInteger* pSaveEveryNSecondsCmd;
+  G4UIcmdWithABool *    pEnableAsyncSaveCmd;
   G4UIcmdWithABool *    pSetOverWriteFilesFlagCmd;
   G4UIcmdWithABool *    pSetResetDataAtEachRunFlagCmd;
   G4UIcmdWithAString *  pAddFilterCmd;
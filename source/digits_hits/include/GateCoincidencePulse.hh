@@ -39,6 +39,10 @@ class GateCoincidencePulse : public GatePulseList
 
     virtual ~GateCoincidencePulse(){}
 
+    //! Allocation from the coincidence-pulse free-list
+    inline void* operator new(size_t);
+    inline void  operator delete(void*);
+
     inline G4double GetStartTime() const
       { return m_startTime; }
 
@@ -67,4 +71,16 @@ class GateCoincidencePulse : public GatePulseList
     G4int m_coincID;
 };
 
+extern G4Allocator<GateCoincidencePulse> GateCoincidencePulseAllocator;
+
+inline void* GateCoincidencePulse::operator new(size_t)
+{
+  return (void *) GateCoincidencePulseAllocator.MallocSingle();
+}
+
+inline void GateCoincidencePulse::operator delete(void* aPulse)
+{
+  GateCoincidencePulseAllocator.FreeSingle((GateCoincidencePulse*) aPulse);
+}
+
 #endif
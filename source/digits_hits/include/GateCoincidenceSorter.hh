@@ -14,6 +14,7 @@ See LICENSE.md for further details
 #include <iostream>
 #include <list>
 #include <deque>
+#include <vector>
 #include "G4ThreeVector.hh"
 
 #include "GateCoincidencePulse.hh"
@@ -127,7 +128,7 @@ public:
     { return m_outputName; }
 
     void SetPresortBufferSize(G4int size)
-    { m_presortBufferSize = size; }
+    { m_presortBufferSize = size; m_presortBuffer.reserve(size+1); }
 
     inline void SetAbsorberSDVol(G4String val)
     { m_absorberSD = val;
@@ -181,7 +182,23 @@ private:
     //! \name Work storage variable
     //@{
 
-    std::list<GatePulse*> m_presortBuffer;      // incoming pulses are presorted and buffered
+    //! Entry of the presort buffer: the pulse time is cached to keep heap comparisons local,
+    //! the arrival order keeps pulses with equal times in first-in first-out order
+    struct PresortEntry
+    {
+      G4double   time;
+      G4long     order;
+      GatePulse* pulse;
+    };
+    //! Heap ordering: the earliest pulse is at the top of the presort buffer
+    struct PresortLater
+    {
+      inline bool operator()(const PresortEntry& a, const PresortEntry& b) const
+      { return a.time > b.time || (a.time == b.time && a.order > b.order); }
+    };
+
+    std::vector<PresortEntry> m_presortBuffer;  // incoming pulses are presorted and buffered (binary min-heap on time)
+    G4long                m_presortCounter;     // arrival counter of the presort buffer
     G4int                 m_presortBufferSize;
     G4bool                m_presortWarning;     // avoid repeat warnings
     bool                m_CCSorter;     // compton camera sorter
@@ -14,6 +14,7 @@ See LICENSE.md for further details
 #include "G4THitsCollection.hh"
 #include "G4Allocator.hh"
 #include "G4ThreeVector.hh"
+#include "G4TouchableHandle.hh"
 
 #include "globals.hh"
 #include <iostream>
@@ -22,12 +23,21 @@ See LICENSE.md for further details
 
 #include "GateVolumeID.hh"
 #include "GateOutputVolumeID.hh"
+#include "GateNameTable.hh"
+
+class GateVSystem;
 
 /*! \class  GateCrystalHit
     \brief  Stores hit information for a hit taking place in a volume connected to a system
 
     - GateCrystalHit - by Giovanni Santin
 
+    - Process and volume names are stored as GateNameTable IDs.
+
+    - When the hit is created by the GateCrystalSD, the local position, the volumeID and the
+      output volumeID are not computed: the hit keeps the touchable of the step and its system,
+      and these fields are computed on their first access. Hits ignored by the digitizer
+      (e.g. null energy deposition) then never pay for them.
 */
 //    Last modification in 12/2011 by Abdul-Fattah.Mohamad-Hadi@subatech.in2p3.fr, for the multi-system approach.
 
@@ -63,8 +73,8 @@ private:
   G4double m_posy;
   G4double m_posz;
   G4ThreeVector m_momDir;        // momentum Direction of the current hit
-  G4ThreeVector m_localPos;   // position of the current hit
-  G4String m_process;         // process on the current hit
+  mutable G4ThreeVector m_localPos;   // position of the current hit
+  G4int m_processID;          // process on the current hit (GateNameTable ID)
   G4int m_PDGEncoding;        // G4 PDGEncoding
   G4int m_trackID;            // track ID
   G4int m_parentID;           // parent track ID
@@ -75,17 +85,24 @@ private:
   G4int m_nCrystalCompton;    // # of compton processes in the crystal occurred to the photon
   G4int m_nPhantomRayleigh;    // # of Rayleigh processes in the phantom occurred to the photon
   G4int m_nCrystalRayleigh;    // # of Rayleigh processes in the crystal occurred to the photon
-  G4String m_comptonVolumeName; // name of the volume of the last (if any) compton scattering
-  G4String m_RayleighVolumeName; // name of the volume of the last (if any) Rayleigh scattering
+  G4int m_comptonVolumeNameID;  // name of the volume of the last (if any) compton scattering (GateNameTable ID)
+  G4int m_RayleighVolumeNameID; // name of the volume of the last (if any) Rayleigh scattering (GateNameTable ID)
   G4int m_primaryID;          // primary that caused the hit
   G4int m_eventID;            // eventID
   G4int m_runID;              // runID
-  GateVolumeID m_volumeID;    // Volume ID in the world volume tree
+  mutable GateVolumeID m_volumeID;    // Volume ID in the world volume tree
   G4ThreeVector m_scannerPos; // Position of the scanner
   G4double m_scannerRotAngle; // Rotation angle of the scanner
-  GateOutputVolumeID m_outputVolumeID;
+  mutable GateOutputVolumeID m_outputVolumeID;
   G4int m_systemID;           // system ID in for the multi-system approach
 
+  // Sources of the fields computed on demand
+  G4TouchableHandle m_touchable;      // touchable of the step (null if the fields were set)
+  GateVSystem* m_system;              // system computing the output volume ID
+  mutable G4bool m_localPosSet;
+  mutable G4bool m_volumeIDSet;
+  mutable G4bool m_outputVolumeIDSet;
+
   // To use with GateROOTBasicOutput classes
   G4ThreeVector pos;  // position
 
@@ -94,7 +111,7 @@ private:
 
 
 // AE : Added for IdealComptonPhot adder which take into account several Comptons in the same volume
-  G4String m_Postprocess;         // PostStep process 
+  G4int m_PostprocessID;         // PostStep process (GateNameTable ID)
   G4double m_energyIniTrack;         // Initial energy of the track
   G4double m_energyFin;         // final energy of the particle
   G4double m_sourceEnergy;//AE
@@ -130,12 +147,15 @@ private:
       inline void  SetMomentumDir(const G4ThreeVector& xyz)     { m_momDir = xyz; }
       inline const G4ThreeVector& GetMomentumDir() const             { return m_momDir; }
 
-      inline void  SetLocalPos(const G4ThreeVector& xyz)     { m_localPos = xyz; }
-      inline const G4ThreeVector& GetLocalPos() const             { return m_localPos; }
+      inline void  SetLocalPos(const G4ThreeVector& xyz)     { m_localPos = xyz; m_localPosSet = true; }
+      inline const G4ThreeVector& GetLocalPos() const
+      	  { if (!m_localPosSet) ComputeLocalPos(); return m_localPos; }
 
 
-      inline void     SetProcess(G4String proc) { m_process = proc; }
-      inline G4String GetProcess() const             { return m_process; }
+      inline void     SetProcess(const G4String& proc) { m_processID = GateNameTable::GetID(proc); }
+      inline const G4String& GetProcess() const        { return GateNameTable::GetName(m_processID); }
+      inline void  SetProcessID(G4int id)              { m_processID = id; }
+      inline G4int GetProcessID() const                { return m_processID; }
 
       inline void  SetPDGEncoding(G4int j)      { m_PDGEncoding = j; }
       inline G4int GetPDGEncoding() const            { return m_PDGEncoding; }
@@ -167,11 +187,13 @@ private:
       inline void  SetNCrystalRayleigh(G4int j)  { m_nCrystalRayleigh = j; }
       inline G4int GetNCrystalRayleigh() const        { return m_nCrystalRayleigh; }
 
-      inline void     SetComptonVolumeName(G4String name) { m_comptonVolumeName = name; }
-      inline G4String GetComptonVolumeName() const        { return m_comptonVolumeName; }
+      inline void     SetComptonVolumeName(const G4String& name) { m_comptonVolumeNameID = GateNameTable::GetID(name); }
+      inline const G4String& GetComptonVolumeName() const        { return GateNameTable::GetName(m_comptonVolumeNameID); }
+      inline G4int GetComptonVolumeNameID() const                { return m_comptonVolumeNameID; }
 
-      inline void     SetRayleighVolumeName(G4String name) { m_RayleighVolumeName = name; }
-      inline G4String GetRayleighVolumeName() const        { return m_RayleighVolumeName; }
+      inline void     SetRayleighVolumeName(const G4String& name) { m_RayleighVolumeNameID = GateNameTable::GetID(name); }
+      inline const G4String& GetRayleighVolumeName() const        { return GateNameTable::GetName(m_RayleighVolumeNameID); }
+      inline G4int GetRayleighVolumeNameID() const                { return m_RayleighVolumeNameID; }
 
       inline void  SetPrimaryID(G4int j)        { m_primaryID = j; }
       inline G4int GetPrimaryID() const              { return m_primaryID; }
@@ -182,8 +204,9 @@ private:
       inline void  SetRunID(G4int j)            { m_runID = j; }
       inline G4int GetRunID() const                  { return m_runID; }
 
-      inline void  SetVolumeID(const GateVolumeID& volumeID)            { m_volumeID = volumeID; }
-      inline const GateVolumeID& GetVolumeID() const                  	{ return m_volumeID; }
+      inline void  SetVolumeID(const GateVolumeID& volumeID)            { m_volumeID = volumeID; m_volumeIDSet = true; }
+      inline const GateVolumeID& GetVolumeID() const
+      	  { if (!m_volumeIDSet) ComputeVolumeID(); return m_volumeID; }
 
       inline void  SetScannerPos(const G4ThreeVector& xyz)            	{ m_scannerPos = xyz; }
       inline const G4ThreeVector& GetScannerPos() const                   	{ return m_scannerPos; }
@@ -191,15 +214,21 @@ private:
       inline void     SetScannerRotAngle(G4double angle)      	        { m_scannerRotAngle = angle; }
       inline G4double GetScannerRotAngle() const                   	      	{ return m_scannerRotAngle; }
 
-      inline void  SetOutputVolumeID(const GateOutputVolumeID& outputVolumeID)  { m_outputVolumeID = outputVolumeID; }
-      inline const GateOutputVolumeID& GetOutputVolumeID()  const             	{ return m_outputVolumeID; }
-      inline G4int GetComponentID(size_t depth) const    { return (m_outputVolumeID.size()>depth) ? m_outputVolumeID[depth] : -1; }
+      inline void  SetOutputVolumeID(const GateOutputVolumeID& outputVolumeID)  { m_outputVolumeID = outputVolumeID; m_outputVolumeIDSet = true; }
+      inline const GateOutputVolumeID& GetOutputVolumeID()  const
+      	  { if (!m_outputVolumeIDSet) ComputeOutputVolumeID(); return m_outputVolumeID; }
+      inline G4int GetComponentID(size_t depth) const    { return (GetOutputVolumeID().size()>depth) ? m_outputVolumeID[depth] : -1; }
+
+      //! Lets the local position, volumeID and output volumeID be computed on demand from
+      //! the touchable of the step (the transportation hits are in the pre-step volume)
+      void SetTouchable(const G4TouchableHandle& touchable,GateVSystem* system);
 
       inline void  SetSystemID(const G4int systemID) { m_systemID = systemID; }
       inline G4int GetSystemID() const { return m_systemID; }
 
       inline G4bool GoodForAnalysis() const
-      	  { return ( (m_process != "Transportation") || (m_edep!=0.) ); }
+      	  { static const G4int transportationID = GateNameTable::GetID("Transportation");
+      	    return ( (m_processID != transportationID) || (m_edep!=0.) ); }
 
       // HDS : Added in order to record septal penetration
       inline void  SetNSeptal(G4int j)  { m_nSeptal = j; }
@@ -209,8 +238,9 @@ private:
 
 
       // AE : Added for IdealComptonPhot adder which take into account several Comptons in the same volume 
-      inline void     SetPostStepProcess(G4String proc) { m_Postprocess = proc; }
-      inline G4String GetPostStepProcess() const             { return m_Postprocess; }
+      inline void     SetPostStepProcess(const G4String& proc) { m_PostprocessID = GateNameTable::GetID(proc); }
+      inline const G4String& GetPostStepProcess() const        { return GateNameTable::GetName(m_PostprocessID); }
+      inline G4int GetPostStepProcessID() const                { return m_PostprocessID; }
      
       inline void SetEnergyIniTrack(G4double eIni)          { m_energyIniTrack = eIni; }
       inline G4double GetEnergyIniTrack() const                { return m_energyIniTrack; }
@@ -253,6 +283,11 @@ private:
       
       inline void SetGammaType(G4int value){ m_gammaType = value; }
       inline G4int GetGammaType() const { return m_gammaType; }
+
+  private:
+      void ComputeLocalPos() const;
+      void ComputeVolumeID() const;
+      void ComputeOutputVolumeID() const;
 };
 
 typedef G4THitsCollection<GateCrystalHit> GateCrystalHitsCollection;
@@ -12,7 +12,11 @@ See LICENSE.md for further details
 
 #include "G4VSensitiveDetector.hh"
 #include "GateCrystalHit.hh"
+#include <unordered_map>
 class G4Step;
+class G4VProcess;
+class G4VPhysicalVolume;
+class G4VTouchable;
 class G4HCofThisEvent;
 class G4TouchableHistory;
 
@@ -41,6 +45,10 @@ typedef GateSystemList::const_iterator GateSystemConstIterator;
 
     - The GateCrystalSD generates hits of the class GateCrystalHit, which are stored in a regular
       hit collection.
+
+    - Processes and systems are cached by pointer: no string is built or compared for each step.
+      The hits keep the touchable of the step, their local position and volume IDs are only
+      computed if they are used (see GateCrystalHit).
 */
 //    Last modification in 12/2011 by Abdul-Fattah.Mohamad-Hadi@subatech.in2p3.fr, for the multi-system approach.
 
@@ -78,6 +86,8 @@ class GateCrystalSD : public G4VSensitiveDetector
       void AddSystem(GateVSystem* aSystem);
       GateVSystem* FindSystem(GateVolumeID volumeID);
       GateVSystem* FindSystem(G4String& systemName);
+      //! Same as FindSystem(GateVolumeID), cached by the volume of the system
+      GateVSystem* FindSystem(const G4VTouchable* touchable);
 
       G4int PrepareCreatorAttachment(GateVVolume* aCreator);
 
@@ -89,6 +99,13 @@ class GateCrystalSD : public G4VSensitiveDetector
 
       static const G4String theCrystalCollectionName; //! Name of the hit collection
 
+      //! GateNameTable ID of a process name, cached by process
+      G4int GetProcessID(const G4VProcess* process);
+
+      G4int m_transportationID;                                               //! ID of "Transportation"
+      std::unordered_map<const G4VProcess*,G4int> m_processIDs;             //! Process name IDs
+      std::unordered_map<const G4VPhysicalVolume*,GateVSystem*> m_systems;  //! System of each system volume
+
 };
 
 
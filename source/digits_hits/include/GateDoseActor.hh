@@ -30,6 +30,7 @@
 #include "GateImageWithStatistic.hh"
 #include "GateVoxelizedMass.hh"
 #include "GateRegionDoseStat.hh"
+#include "GateStoppingPowerTable.hh"
 
 class G4EmCalculator;
 
@@ -64,6 +65,9 @@ public:
   void EnableDoseToWaterUncertaintyImage(bool b) { mIsDoseToWaterUncertaintyImageEnabled = b; }
   void EnableDoseToWaterNormalisationToMax(bool b);
   void EnableDoseToWaterNormalisationToIntegral(bool b);
+  void SetDoseToWaterTableBinsPerDecade(int n) { mDoseToWaterRatioTable.SetNumberOfBinsPerDecade(n); }
+  void SetDoseToWaterTableValidation(int n) { mDoseToWaterValidationPeriod = n; }
+  void SetDoseToWaterTableTolerance(double t) { mDoseToWaterValidationTolerance = t; }
   //DoseToOtherMaterial
   void EnableDoseToOtherMaterialImage(bool b) { mIsDoseToOtherMaterialImageEnabled = b; }
   void EnableDoseToOtherMaterialSquaredImage(bool b) { mIsDoseToOtherMaterialSquaredImageEnabled = b; }
@@ -79,12 +83,15 @@ public:
   void VolumeFilter(G4String b) { mVolumeFilter = b; }
   void MaterialFilter(G4String b) { mMaterialFilter = b; }
   void setTestFlag(bool b) { mTestFlag = b; }
+  void EnableLeanStatistics(bool b) { mIsLeanStatisticsEnabled = b; }
+  void EnableFloatAccumulators(bool b) { mIsFloatAccumulatorEnabled = b; }
   //Regions
   void SetDoseByRegionsInputFilename(std::string f);
   void SetDoseByRegionsOutputFilename(std::string f);
   void AddRegion(std::string str);
 
   virtual void BeginOfRunAction(const G4Run*r);
+  virtual void EndOfRunAction(const G4Run*r);
   virtual void BeginOfEventAction(const G4Event * event);
 
   virtual void UserSteppingActionInVoxel(const int index, const G4Step* step);
@@ -93,6 +100,7 @@ public:
 
   //  Saves the data collected to the file
   virtual void SaveData();
+  virtual void SaveDataAsync();
   virtual void ResetData();
 
   // Scorer related
@@ -108,6 +116,8 @@ protected:
   StepHitType mUserStepHitType;
 
   bool mIsLastHitEventImageEnabled;
+  bool mIsLeanStatisticsEnabled;
+  bool mIsFloatAccumulatorEnabled;
 
   //Edep
   bool mIsEdepImageEnabled;
@@ -153,6 +163,16 @@ protected:
   //DoseToWater
   G4String mDoseToWaterFilename;
   GateImageWithStatistic mDoseToWaterImage;
+  GateStoppingPowerTable mDoseToWaterRatioTable; // water/material total dedx ratio
+  // Validation: every n-th step, the tabulated ratio is compared to the exact one (0: never);
+  // the run fails if the max relative difference exceeds the tolerance (0: no check)
+  int mDoseToWaterValidationPeriod;
+  double mDoseToWaterValidationTolerance;
+  long mDoseToWaterValidationStepCount;
+  long mDoseToWaterValidationCount;
+  double mDoseToWaterValidationMaxRelDiff;
+  double mDoseToWaterValidationSumRelDiff;
+  void ValidateDoseToWaterRatio(G4double energy, const G4ParticleDefinition* p, const G4Material* m, G4double ratio);
   //DoseToOtherMaterial
   G4String mDoseToOtherMaterialFilename;
   GateImageWithStatistic mDoseToOtherMaterialImage;
@@ -160,6 +180,7 @@ protected:
   //Hits
   G4String mNbOfHitsFilename;
   GateImageInt mNumberOfHitsImage;
+  std::shared_ptr<GateImageCopyOnWrite> mNumberOfHitsCopyOnWrite; // async save in progress
   GateImageInt mLastHitEventImage;
   //Others
   GateImageDouble mMassImage;
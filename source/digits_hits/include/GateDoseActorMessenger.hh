@@ -18,6 +18,8 @@
 
 #include "G4UIcmdWithABool.hh"
 #include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
 #include "GateImageActorMessenger.hh"
 
 class GateDoseActor;
@@ -52,6 +54,9 @@ protected:
   G4UIcmdWithABool * pEnableDoseToWaterUncertaintyCmd;
   G4UIcmdWithABool * pEnableDoseToWaterNormToMaxCmd;
   G4UIcmdWithABool * pEnableDoseToWaterNormToIntegralCmd;
+  G4UIcmdWithAnInteger * pSetDoseToWaterTableBinsCmd;
+  G4UIcmdWithAnInteger * pSetDoseToWaterTableValidationCmd;
+  G4UIcmdWithADouble * pSetDoseToWaterTableToleranceCmd;
   //DoseToOtherMaterial
   G4UIcmdWithABool * pEnableDoseToOtherMaterialCmd;
   G4UIcmdWithABool * pEnableDoseToOtherMaterialSquaredCmd;
@@ -67,6 +72,8 @@ protected:
   G4UIcmdWithAString * pVolumeFilterCmd;
   G4UIcmdWithAString * pMaterialFilterCmd;
   G4UIcmdWithABool * pTestFlagCmd;
+  G4UIcmdWithABool * pEnableLeanStatisticsCmd;
+  G4UIcmdWithABool * pEnableFloatAccumulatorsCmd;
   //Regions
   G4UIcmdWithAString * pDoseRegionInputCmd;
   G4UIcmdWithAString * pDoseRegionOutputCmd;
@@ -206,6 +206,10 @@ public:
     {
     mEnergyResolvedBinSize = e;
     }
+  void SetInteractionBatchSize(const G4int n)
+    {
+    mInteractionBatchSize = n;
+    }
 
   void SetGeometryFromInputRTKGeometryFile(GateVSource *source,
                                            GateVVolume *detector,
@@ -237,6 +241,12 @@ public:
   template<ProcessType VProcess, class TProjectorType>
   void ForceDetectionOfInteraction(TProjectorType *projector,
                                    InputImageType::Pointer &input);
+
+  /* Projection of the queued interactions, one projector update per process */
+  template<ProcessType VProcess, class TProjectorType>
+  void ProjectInteractionBatch(TProjectorType *projector,
+                               InputImageType::Pointer &input);
+  void ProjectInteractionBatches();
   void TestSource(GateSourceMgr * sm);
   void GetEnergyList(std::vector<double> & energyList, std::vector<double> & energyWeightList);
   GateVImageVolume* SearchForVoxelisedVolume();
@@ -401,6 +411,22 @@ protected:
   unsigned int mNumberOfProcessedRayleigh;
   unsigned int mNumberOfProcessedPE;
 
+  /* Batched projection: interactions are queued per process and projected
+   together, one projection slice per interaction */
+  struct QueuedInteraction
+    {
+    PointType position;
+    VectorType direction;
+    double energy;
+    double weight;
+    int Z;
+    int order;
+    };
+  unsigned int mInteractionBatchSize;
+  bool mUseInteractionBatches;
+  std::map<ProcessType, std::vector<QueuedInteraction> > mInteractionQueue;
+  std::vector<InputPixelType> mBatchBuffer;
+
   /* Account for primary fluence weighting */
   InputImageType::Pointer PrimaryFluenceWeighting(const InputImageType::Pointer input);
 
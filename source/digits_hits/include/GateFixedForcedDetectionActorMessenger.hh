@@ -62,6 +62,7 @@ protected:
   G4UIcmdWithAString * pSetInputRTKGeometryFilenameCmd;
   G4UIcmdWithAnInteger * pSetNoisePrimaryCmd;
   G4UIcmdWithADoubleAndUnit * pEnergyResolvedBinSizeCmd;
+  G4UIcmdWithAnInteger * pSetInteractionBatchSizeCmd;
   };
 
 #endif /* end #define GATEFIXEDFORCEDDECTECTIONACTORMESSENGER_HH*/
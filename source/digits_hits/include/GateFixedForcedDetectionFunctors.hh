@@ -109,7 +109,9 @@ namespace GateFixedForcedDetectionFunctor
           m_MuToDeltaImageOffset(0),
           m_EnergyResolvedBinSize(0.),
           m_generatePhotons(false),
-          m_ARF(false)
+          m_ARF(false),
+          m_BatchBuffer(ITK_NULLPTR),
+          m_ProjectionSize(1)
         {
         for (itk::ThreadIdType i = 0; i < ITK_MAX_THREADS; i++)
           {
@@ -463,7 +465,26 @@ namespace GateFixedForcedDetectionFunctor
         m_ARF = boolean;
         }
 
+      /* Batch of interactions projected with one geometry: the projection of
+       interaction i is slice i of the output buffer, which starts at buffer and
+       holds projectionSize pixels per slice. A null buffer means that there is
+       one interaction, set with SetEnergyZAndWeight and SetDirection. */
+      void SetBatchBuffer(const float *buffer, const std::ptrdiff_t projectionSize)
+        {
+        m_BatchBuffer = buffer;
+        m_ProjectionSize = projectionSize;
+        }
+
     protected:
+      inline unsigned int GetInteractionIndex(const float & output) const
+        {
+        if (!m_BatchBuffer)
+          {
+          return 0;
+          }
+        return (&output - m_BatchBuffer) / m_ProjectionSize;
+        }
+
       inline void Accumulate(const rtk::ThreadIdType threadId,
                              float & output,
                              const double valueToAccumulate,
@@ -520,6 +541,8 @@ namespace GateFixedForcedDetectionFunctor
       std::vector<std::vector<newPhoton> > m_PhotonList;
       bool m_generatePhotons;
       bool m_ARF;
+      const float *m_BatchBuffer;
+      std::ptrdiff_t m_ProjectionSize;
       };
 
     /* Most of the computation for the primary is done in this functor. After a ray
@@ -663,15 +686,16 @@ namespace GateFixedForcedDetectionFunctor
           worldVector[i] *= m_VolumeSpacing[i];
           }
         const double worldVectorNorm = worldVector.GetNorm();
+        const Interaction & interaction = m_Interactions[GetInteractionIndex(output)];
 
         /* This is taken from G4LivermoreComptonModel.cc */
-        double cosT = worldVector * m_Direction / worldVectorNorm;
-        double x = std::sqrt(1. - cosT) * m_InvWlPhoton; /* 1-cosT=2*sin(T/2)^2 */
-        double scatteringFunction = m_ScatterFunctionData->FindValue(x, m_Z - 1);
+        double cosT = worldVector * interaction.direction / worldVectorNorm;
+        double x = std::sqrt(1. - cosT) * interaction.invWlPhoton; /* 1-cosT=2*sin(T/2)^2 */
+        double scatteringFunction = m_ScatterFunctionData->FindValue(x, interaction.Z - 1);
 
         /* This is taken from GateDiffCrossSectionActor.cc and simplified */
-        double Eratio = 1. / (1. + m_E0m * (1. - cosT));
-        double DCSKleinNishina = m_eRadiusOverCrossSectionTerm
+        double Eratio = 1. / (1. + interaction.E0m * (1. - cosT));
+        double DCSKleinNishina = interaction.eRadiusOverCrossSectionTerm
                                  * Eratio
                                  * (1. + Eratio * (Eratio - 1. + cosT * cosT));
         double DCScompton = DCSKleinNishina * scatteringFunction;
@@ -695,7 +719,7 @@ namespace GateFixedForcedDetectionFunctor
           {
           m_InterpolationWeights[threadId].back() = worldVectorNorm;
           }
-        const double energy = Eratio * m_Energy;
+        const double energy = Eratio * interaction.energy;
         unsigned int e = itk::Math::Round<double, double>(energy / m_MaterialMu->GetSpacing()[1]);
         double *p = m_MaterialMu->GetPixelContainer()->GetBufferPointer()
                     + e * m_MaterialMu->GetLargestPossibleRegion().GetSize()[0];
@@ -746,31 +770,55 @@ namespace GateFixedForcedDetectionFunctor
 
       void SetDirection(const VectorType &_arg)
         {
-        m_Direction = _arg;
+        m_Interactions.resize(1);
+        m_Interactions[0].direction = _arg;
         }
 
       void SetEnergyZAndWeight(const double &energy, const unsigned int &Z, const double &weight)
         {
-        m_Energy = energy;
-        m_Weight = weight;
-        m_E0m = m_Energy / electron_mass_c2;
-        m_InvWlPhoton = std::sqrt(0.5) * cm * m_Energy / (h_Planck * c_light); /* sqrt(0.5) for trigo reasons, see comment when used */
+        m_Interactions.resize(1);
+        SetInteraction(m_Interactions[0], energy, Z, weight);
+        }
 
-        G4double crossSection = m_CrossSectionHandler->FindValue(Z, energy);
-        m_Z = Z;
-        m_eRadiusOverCrossSectionTerm = weight * (classic_electr_radius * classic_electr_radius)
-                                        / (2. * crossSection);
+      /* Interactions of a batch, see VAccumulation::SetBatchBuffer */
+      void ClearInteractions()
+        {
+        m_Interactions.clear();
+        }
+      void AddInteraction(const double &energy,
+                          const unsigned int &Z,
+                          const double &weight,
+                          const VectorType &direction)
+        {
+        m_Interactions.push_back(Interaction());
+        SetInteraction(m_Interactions.back(), energy, Z, weight);
+        m_Interactions.back().direction = direction;
         }
 
     private:
-      VectorType m_Direction;
-      double m_Energy;
-      double m_E0m;
-      double m_Weight;
-
-      double m_InvWlPhoton;
-      unsigned int m_Z;
-      double m_eRadiusOverCrossSectionTerm;
+      struct Interaction
+        {
+        VectorType direction;
+        double energy;
+        double E0m;
+        double invWlPhoton;
+        unsigned int Z;
+        double eRadiusOverCrossSectionTerm;
+        };
+
+      void SetInteraction(Interaction &interaction, const double &energy, const unsigned int &Z, const double &weight)
+        {
+        interaction.energy = energy;
+        interaction.E0m = energy / electron_mass_c2;
+        interaction.invWlPhoton = std::sqrt(0.5) * cm * energy / (h_Planck * c_light); /* sqrt(0.5) for trigo reasons, see comment when used */
+
+        G4double crossSection = m_CrossSectionHandler->FindValue(Z, energy);
+        interaction.Z = Z;
+        interaction.eRadiusOverCrossSectionTerm = weight * (classic_electr_radius * classic_electr_radius)
+                                                  / (2. * crossSection);
+        }
+
+      std::vector<Interaction> m_Interactions;
       /* Compton data */
       G4VEMDataSet* m_ScatterFunctionData;
       G4VCrossSectionHandler* m_CrossSectionHandler;
@@ -816,13 +864,14 @@ namespace GateFixedForcedDetectionFunctor
           }
 
         const double worldVectorNorm = worldVector.GetNorm();
+        const Interaction & interaction = m_Interactions[GetInteractionIndex(output)];
 
         /* This is taken from GateDiffCrossSectionActor.cc and simplified */
-        double cosT = worldVector * m_Direction / worldVectorNorm;
+        double cosT = worldVector * interaction.direction / worldVectorNorm;
         double DCSThomsonTerm1 = (1 + cosT * cosT);
-        double DCSThomson = m_eRadiusOverCrossSectionTerm * DCSThomsonTerm1;
-        double x = std::sqrt(1. - cosT) * m_InvWlPhoton; /* 1-cosT=2*sin(T/2)^2 */
-        double formFactor = m_FormFactorData->FindValue(x, m_Z - 1);
+        double DCSThomson = interaction.eRadiusOverCrossSectionTerm * DCSThomsonTerm1;
+        double x = std::sqrt(1. - cosT) * interaction.invWlPhoton; /* 1-cosT=2*sin(T/2)^2 */
+        double formFactor = m_FormFactorData->FindValue(x, interaction.Z - 1);
         double DCSrayleigh = DCSThomson * formFactor * formFactor;
 
         /* Multiply interpolation weights by step norm in MM to convert voxel
@@ -841,7 +890,7 @@ namespace GateFixedForcedDetectionFunctor
         double rayIntegral = 0.;
         for (unsigned int j = 0; j < m_InterpolationWeights[threadId].size(); j++)
           {
-          rayIntegral += m_InterpolationWeights[threadId][j] * *(m_MaterialMuPointer + j);
+          rayIntegral += m_InterpolationWeights[threadId][j] * *(interaction.materialMuPointer + j);
           }
 
         /* Final computation */
@@ -855,7 +904,7 @@ namespace GateFixedForcedDetectionFunctor
             photonDirection[i] = worldVector[i] / worldVectorNorm;
             photonPosition[i] = farthestPoint[i] * m_VolumeSpacing[i];
             }
-          SavePhotonsparameters(threadId, photonPosition, photonDirection, weight, m_Energy);
+          SavePhotonsparameters(threadId, photonPosition, photonDirection, weight, interaction.energy);
           }
         else if (m_ARF)
           {
@@ -866,12 +915,12 @@ namespace GateFixedForcedDetectionFunctor
             photonDirection[i] = worldVector[i] / worldVectorNorm;
             photonPosition[i] = sourceToPixel[i] * m_VolumeSpacing[i];
             }
-          SavePhotonsparameters(threadId, photonPosition, photonDirection, weight, m_Energy);
+          SavePhotonsparameters(threadId, photonPosition, photonDirection, weight, interaction.energy);
           }
 
         else
           {
-          Accumulate(threadId, output, weight, m_Energy);
+          Accumulate(threadId, output, weight, interaction.energy);
           }
 
         /* Reset weights for next ray in thread. */
@@ -882,31 +931,56 @@ namespace GateFixedForcedDetectionFunctor
 
       void SetDirection(const VectorType &_arg)
         {
-        m_Direction = _arg;
+        m_Interactions.resize(1);
+        m_Interactions[0].direction = _arg;
         }
       void SetEnergyZAndWeight(const double & energy, const unsigned int & Z, const double & weight)
+        {
+        m_Interactions.resize(1);
+        SetInteraction(m_Interactions[0], energy, Z, weight);
+        }
+
+      /* Interactions of a batch, see VAccumulation::SetBatchBuffer */
+      void ClearInteractions()
+        {
+        m_Interactions.clear();
+        }
+      void AddInteraction(const double &energy,
+                          const unsigned int &Z,
+                          const double &weight,
+                          const VectorType &direction)
+        {
+        m_Interactions.push_back(Interaction());
+        SetInteraction(m_Interactions.back(), energy, Z, weight);
+        m_Interactions.back().direction = direction;
+        }
+
+    private:
+      struct Interaction
+        {
+        VectorType direction;
+        double *materialMuPointer;
+        double invWlPhoton;
+        double energy;
+        unsigned int Z;
+        double eRadiusOverCrossSectionTerm;
+        };
+
+      void SetInteraction(Interaction &interaction, const double &energy, const unsigned int &Z, const double &weight)
         {
         unsigned int e = itk::Math::Round<double, double>(energy / m_MaterialMu->GetSpacing()[1]);
-        m_InvWlPhoton = std::sqrt(0.5) * cm * energy / (h_Planck * c_light); // sqrt(0.5) for trigo reasons, see comment when used
-        m_Energy = energy;
-        m_Weight = weight;
-        m_MaterialMuPointer = m_MaterialMu->GetPixelContainer()->GetBufferPointer();
-        m_MaterialMuPointer += e * m_MaterialMu->GetLargestPossibleRegion().GetSize()[0];
+        interaction.invWlPhoton = std::sqrt(0.5) * cm * energy / (h_Planck * c_light); // sqrt(0.5) for trigo reasons, see comment when used
+        interaction.energy = energy;
+        interaction.materialMuPointer = m_MaterialMu->GetPixelContainer()->GetBufferPointer();
+        interaction.materialMuPointer += e * m_MaterialMu->GetLargestPossibleRegion().GetSize()[0];
 
         G4double crossSection = m_CrossSectionHandler->FindValue(Z, energy);
-        m_Z = Z;
-        m_eRadiusOverCrossSectionTerm = weight * (classic_electr_radius * classic_electr_radius)
-                                        / (2. * crossSection);
+        interaction.Z = Z;
+        interaction.eRadiusOverCrossSectionTerm = weight * (classic_electr_radius * classic_electr_radius)
+                                                  / (2. * crossSection);
         }
 
-    private:
-      VectorType m_Direction;
-      double *m_MaterialMuPointer;
-      double m_InvWlPhoton;
-      double m_Weight;
-      double m_Energy;
-      unsigned int m_Z;
-      double m_eRadiusOverCrossSectionTerm;
+      std::vector<Interaction> m_Interactions;
 
       /* G4 data */
       G4VEMDataSet* m_FormFactorData;
@@ -943,6 +1017,7 @@ namespace GateFixedForcedDetectionFunctor
           worldVector[i] *= m_VolumeSpacing[i];
           }
         const double worldVectorNorm = worldVector.GetNorm();
+        const Interaction & interaction = m_Interactions[GetInteractionIndex(output)];
 
         /* Multiply interpolation weights by step norm in MM to convert voxel
          intersection length to MM. */
@@ -960,11 +1035,11 @@ namespace GateFixedForcedDetectionFunctor
         double rayIntegral = 0.;
         for (unsigned int j = 0; j < m_InterpolationWeights[threadId].size(); j++)
           {
-          rayIntegral += m_InterpolationWeights[threadId][j] * *(m_MaterialMuPointer + j);
+          rayIntegral += m_InterpolationWeights[threadId][j] * *(interaction.materialMuPointer + j);
           }
 
         /* Final computation */
-        double weight = m_Weight * std::exp(-rayIntegral)*GetSolidAngle(sourceToPixel)/(4*itk::Math::pi);
+        double weight = interaction.weight * std::exp(-rayIntegral)*GetSolidAngle(sourceToPixel)/(4*itk::Math::pi);
         if (m_generatePhotons)
           {
           VectorType photonDirection;
@@ -974,7 +1049,7 @@ namespace GateFixedForcedDetectionFunctor
             photonDirection[i] = worldVector[i] / worldVectorNorm;
             photonPosition[i] = farthestPoint[i] * m_VolumeSpacing[i];
             }
-          SavePhotonsparameters(threadId, photonPosition, photonDirection, weight, m_Energy);
+          SavePhotonsparameters(threadId, photonPosition, photonDirection, weight, interaction.energy);
           }
         else if (m_ARF)
           {
@@ -985,12 +1060,12 @@ namespace GateFixedForcedDetectionFunctor
             photonDirection[i] = worldVector[i] / worldVectorNorm;
             photonPosition[i] = sourceToPixel[i] * m_VolumeSpacing[i];
             }
-          SavePhotonsparameters(threadId, photonPosition, photonDirection, weight, m_Energy);
+          SavePhotonsparameters(threadId, photonPosition, photonDirection, weight, interaction.energy);
           }
 
         else
           {
-          Accumulate(threadId, output, weight, m_Energy);
+          Accumulate(threadId, output, weight, interaction.energy);
           }
         /* Reset weights for next ray in thread. */
         std::fill(m_InterpolationWeights[threadId].begin(),
@@ -1006,17 +1081,42 @@ namespace GateFixedForcedDetectionFunctor
                                const unsigned int &itkNotUsed(Z),
                                const double &weight)
         {
-        unsigned int e = itk::Math::Round<double, double>(energy / m_MaterialMu->GetSpacing()[1]);
-        m_Weight = weight;
-        m_Energy = energy;
-        m_MaterialMuPointer = m_MaterialMu->GetPixelContainer()->GetBufferPointer();
-        m_MaterialMuPointer += e * m_MaterialMu->GetLargestPossibleRegion().GetSize()[0];
+        m_Interactions.resize(1);
+        SetInteraction(m_Interactions[0], energy, weight);
+        }
+
+      /* Interactions of a batch, see VAccumulation::SetBatchBuffer */
+      void ClearInteractions()
+        {
+        m_Interactions.clear();
+        }
+      void AddInteraction(const double &energy,
+                          const unsigned int &itkNotUsed(Z),
+                          const double &weight,
+                          const VectorType &itkNotUsed(direction))
+        {
+        m_Interactions.push_back(Interaction());
+        SetInteraction(m_Interactions.back(), energy, weight);
         }
 
     private:
-      double *m_MaterialMuPointer;
-      double m_Weight;
-      double m_Energy;
+      struct Interaction
+        {
+        double *materialMuPointer;
+        double weight;
+        double energy;
+        };
+
+      void SetInteraction(Interaction &interaction, const double &energy, const double &weight)
+        {
+        unsigned int e = itk::Math::Round<double, double>(energy / m_MaterialMu->GetSpacing()[1]);
+        interaction.weight = weight;
+        interaction.energy = energy;
+        interaction.materialMuPointer = m_MaterialMu->GetPixelContainer()->GetBufferPointer();
+        interaction.materialMuPointer += e * m_MaterialMu->GetLargestPossibleRegion().GetSize()[0];
+        }
+
+      std::vector<Interaction> m_Interactions;
       };
 
     class IsotropicPrimaryValueAccumulation: public VAccumulation
@@ -1049,6 +1149,7 @@ namespace GateFixedForcedDetectionFunctor
           worldVector[i] *= m_VolumeSpacing[i];
           }
         const double worldVectorNorm = worldVector.GetNorm();
+        const Interaction & interaction = m_Interactions[GetInteractionIndex(output)];
 
         /* Multiply interpolation weights by step norm in MM to convert voxel
          intersection length to MM. */
@@ -1073,11 +1174,11 @@ namespace GateFixedForcedDetectionFunctor
         double rayIntegral = 0.;
         for (unsigned int j = 0; j < m_InterpolationWeights[threadId].size(); j++)
           {
-          rayIntegral += m_InterpolationWeights[threadId][j] * *(m_MaterialMuPointer + j);
+          rayIntegral += m_InterpolationWeights[threadId][j] * *(interaction.materialMuPointer + j);
           }
 
         /* Final computation */
-        double weight = m_Weight * std::exp(-rayIntegral)*GetSolidAngle(sourceToPixel)/(4*itk::Math::pi);
+        double weight = interaction.weight * std::exp(-rayIntegral)*GetSolidAngle(sourceToPixel)/(4*itk::Math::pi);
         if (m_generatePhotons)
           {
           VectorType photonDirection;
@@ -1087,7 +1188,7 @@ namespace GateFixedForcedDetectionFunctor
             photonDirection[i] = worldVector[i] / worldVectorNorm;
             photonPosition[i] = farthestPoint[i] * m_VolumeSpacing[i];
             }
-          SavePhotonsparameters(threadId, photonPosition, photonDirection, weight, m_Energy);
+          SavePhotonsparameters(threadId, photonPosition, photonDirection, weight, interaction.energy);
           }
         else if (m_ARF)
           {
@@ -1098,12 +1199,12 @@ namespace GateFixedForcedDetectionFunctor
             photonDirection[i] = worldVector[i] / worldVectorNorm;
             photonPosition[i] = sourceToPixel[i] * m_VolumeSpacing[i];
             }
-          SavePhotonsparameters(threadId, photonPosition, photonDirection, weight, m_Energy);
+          SavePhotonsparameters(threadId, photonPosition, photonDirection, weight, interaction.energy);
           }
 
         else
           {
-          Accumulate(threadId, output, weight, m_Energy);
+          Accumulate(threadId, output, weight, interaction.energy);
           }
 
         /* Reset weights for next ray in thread. */
@@ -1119,17 +1220,42 @@ namespace GateFixedForcedDetectionFunctor
                                const unsigned int &itkNotUsed(Z),
                                const double & weight)
         {
-        unsigned int e = itk::Math::Round<double, double>(energy / m_MaterialMu->GetSpacing()[1]);
-        m_Weight = weight;
-        m_Energy = energy;
-        m_MaterialMuPointer = m_MaterialMu->GetPixelContainer()->GetBufferPointer();
-        m_MaterialMuPointer += e * m_MaterialMu->GetLargestPossibleRegion().GetSize()[0];
+        m_Interactions.resize(1);
+        SetInteraction(m_Interactions[0], energy, weight);
+        }
+
+      /* Interactions of a batch, see VAccumulation::SetBatchBuffer */
+      void ClearInteractions()
+        {
+        m_Interactions.clear();
+        }
+      void AddInteraction(const double &energy,
+                          const unsigned int &itkNotUsed(Z),
+                          const double &weight,
+                          const VectorType &itkNotUsed(direction))
+        {
+        m_Interactions.push_back(Interaction());
+        SetInteraction(m_Interactions.back(), energy, weight);
         }
 
     private:
-      double *m_MaterialMuPointer;
-      double m_Weight;
-      double m_Energy;
+      struct Interaction
+        {
+        double *materialMuPointer;
+        double weight;
+        double energy;
+        };
+
+      void SetInteraction(Interaction &interaction, const double &energy, const double &weight)
+        {
+        unsigned int e = itk::Math::Round<double, double>(energy / m_MaterialMu->GetSpacing()[1]);
+        interaction.weight = weight;
+        interaction.energy = energy;
+        interaction.materialMuPointer = m_MaterialMu->GetPixelContainer()->GetBufferPointer();
+        interaction.materialMuPointer += e * m_MaterialMu->GetLargestPossibleRegion().GetSize()[0];
+        }
+
+      std::vector<Interaction> m_Interactions;
       };
 
     template<class TInput1, class TInput2 = TInput1, class TOutput = TInput1>
@@ -0,0 +1,75 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+
+#ifndef GateHitBatchReader_h
+#define GateHitBatchReader_h 1
+
+#include "GateConfiguration.h"
+
+#ifdef G4ANALYSIS_USE_ROOT
+
+#include "globals.hh"
+#include <vector>
+
+#include "TFile.h"
+#include "TTree.h"
+
+#include "GateRootDefs.hh"
+
+class GateCrystalHit;
+
+/*! \class  GateHitBatchReader
+    \brief  Reads the hits of a ROOT simulation-output file by batches of whole events
+
+    - Unlike the GateHitFileReader (DigiGate mode), this reader does not go through
+      the run manager: it is meant for offline digitizers that feed the hits of each
+      event directly to GateDigitizer::Digitize(std::vector<GateCrystalHit*>).
+    - The entries of each batch are fetched by a TTreeCache in a few large reads,
+      and the hits are recycled from one batch to the next.
+    - Hits with a null energy deposition are ignored: online, GateHitConvertor::ProcessHits
+      drops them before ProcessOneHit (whose own check is commented out), so the offline
+      digitizer sees the same pulses as the online one.
+*/
+class GateHitBatchReader
+{
+public:
+  //! batchSize: approximate number of hits per batch; cacheSize: TTreeCache size in bytes
+  GateHitBatchReader(const G4String& fileName,size_t batchSize=1000000,Long64_t cacheSize=256000000);
+  ~GateHitBatchReader();
+
+  //! Reads the next batch of events, returns false at the end of the file
+  bool ReadBatch();
+
+  //! Events of the current batch
+  size_t GetNumberOfEvents() const { return m_eventStart.empty() ? 0 : m_eventStart.size()-1; }
+  //! Hits of an event of the current batch
+  const std::vector<GateCrystalHit*>& GetEvent(size_t i);
+
+  Long64_t GetEntries() const      { return m_entries; }
+  Long64_t GetCurrentEntry() const { return m_currentEntry; }
+
+private:
+  GateCrystalHit* NextHit();
+  void LoadHitData();
+
+  TFile*                       m_hitFile;
+  TTree*                       m_hitTree;
+  Long64_t                     m_entries;
+  Long64_t                     m_currentEntry;
+  size_t                       m_batchSize;
+
+  GateRootHitBuffer            m_hitBuffer;
+  std::vector<GateCrystalHit*> m_hits;          //!< Hits of the current batch (recycled)
+  size_t                       m_nbOfHits;      //!< Hits in use in m_hits
+  std::vector<size_t>          m_eventStart;    //!< First hit of each event, plus the end
+  std::vector<GateCrystalHit*> m_event;         //!< Hits of the event returned by GetEvent()
+};
+
+#endif
+#endif
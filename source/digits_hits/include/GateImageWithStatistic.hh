@@ -18,6 +18,8 @@ See LICENSE.md for further details
 #define GATEIMAGEWITHSTATISTIC_HH
 
 #include "GateImage.hh"
+#include "GateImageCopyOnWrite.hh"
+#include <memory>
 
 //-----------------------------------------------------------------------------
 /// \brief
@@ -49,12 +51,29 @@ class GateImageWithStatistic
 
   void EnableSquaredImage(bool b)     { mIsSquaredImageEnabled = b; }
   void EnableUncertaintyImage(bool b) { mIsUncertaintyImageEnabled = b; }
+
+  // Lean mode: must be set before Allocate. The per-event temp image is
+  // replaced by the list of voxels touched during the current event
+  // (flushed by EndOfEvent), and the scaled and uncertainty images are
+  // only computed, one at a time, when saving. Optionally the values and
+  // squared values are accumulated in single precision.
+  void EnableLeanMode(bool b)          { mIsLeanModeEnabled = b; }
+  void EnableFloatAccumulators(bool b) { mIsFloatAccumulatorEnabled = b; }
+  void EndOfEvent();
   void SetScaleFactor(double s);
   void SetNormalizeToMax(bool b)      { mNormalizedToMax = b; mNormalizedToIntegral = !b; }
   void SetNormalizeToIntegral(bool b) { mNormalizedToMax = !b; mNormalizedToIntegral = b; }
 
   void SetFilename(G4String f);
   void SaveData(int numberOfEvents, bool normalise=false);
+  // Snapshot of the current data (file names resolved), which can be saved
+  // later, e.g. from another thread, while this one keeps accumulating.
+  // The accumulated images are not copied here but copy-on-write, block
+  // by block: SaveSnapshot copies them, and the changes made here in the
+  // meantime first save the blocks they touch.
+  std::shared_ptr<GateImageWithStatistic> CreateSnapshot();
+  // To call on the snapshot
+  void SaveSnapshot(int numberOfEvents, bool normalise=false);
 
   inline G4double GetVoxelVolume() const { return mValueImage.GetVoxelVolume(); }
 
@@ -62,7 +81,10 @@ class GateImageWithStatistic
   virtual void UpdateSquaredImage();
   virtual void UpdateUncertaintyImage(int numberOfEvents);
 
-  GateVImage & GetValueImage() { return mValueImage; }
+  GateVImage & GetValueImage() {
+    if (mIsLeanModeEnabled && mIsFloatAccumulatorEnabled) return mFloatValueImage;
+    return mValueImage;
+  }
   GateVImage & GetUncertaintyImage() { return mUncertaintyImage; }
 
   void SetOrigin(G4ThreeVector v);
@@ -70,12 +92,21 @@ class GateImageWithStatistic
   void SetTransformMatrix(const G4RotationMatrix & m);
 
   protected:
+  inline void CopyBeforeWrite(const int index) { GateImageCopyOnWrite::BeforeWrite(mCopyOnWrite, index); }
+  inline void CopyAllBeforeWrite() { GateImageCopyOnWrite::BeforeWriteAll(mCopyOnWrite); }
+  void SaveLeanData(int numberOfEvents, bool normalise);
+  double GetAccumulatedSquaredValue(const int index) const;
+  static double GetRelativeUncertainty(double sum, double squared, int numberOfEvents);
+
   GateImageDouble mValueImage;
   GateImageDouble mSquaredImage;
   GateImageDouble mTempImage;
   GateImageDouble mUncertaintyImage;
   GateImageDouble mScaledValueImage;
   GateImageDouble mScaledSquaredImage;
+  GateImageFloat mFloatValueImage;
+  GateImageFloat mFloatSquaredImage;
+  std::vector<std::pair<int, double> > mEventValues;
   bool mOverWriteFilesFlag;
   bool mNormalizedToMax;
   bool mNormalizedToIntegral;
@@ -83,6 +114,8 @@ class GateImageWithStatistic
   bool mIsSquaredImageEnabled;
   bool mIsUncertaintyImageEnabled;
   bool mIsValuesMustBeScaled;
+  bool mIsLeanModeEnabled;
+  bool mIsFloatAccumulatorEnabled;
 
   double mScaleFactor;
 
@@ -98,6 +131,9 @@ class GateImageWithStatistic
   int mSquaredFD;
   int mUncertaintyFD;
 
+  std::shared_ptr<GateImageCopyOnWrite> mCopyOnWrite;    // snapshot in progress of these images
+  std::shared_ptr<GateImageCopyOnWrite> mSnapshotSource; // (snapshot) copy of the images to do
+
 }; // end class GateImageWithStatistic
 
 #endif /* end #define GATEIMAGEWITHSTATISTIC_HH */
@@ -23,6 +23,7 @@
 #include "G4UnitsTable.hh"
 #include "GateLETActorMessenger.hh"
 #include "GateImageWithStatistic.hh"
+#include "GateStoppingPowerTable.hh"
 #include "G4VProcess.hh"
 
 class G4EmCalculator;
@@ -48,8 +49,11 @@ public:
   void SetCutVal(G4double d) { mCutVal = d; }
   void SetLETthrMin(G4double d) { mLETthrMin = d; }
   void SetLETthrMax(G4double d) { mLETthrMax = d; }
+  void SetDEDXTableBinsPerDecade(int n) { mDEDXTable.SetNumberOfBinsPerDecade(n); mOtherMaterialDEDXTable.SetNumberOfBinsPerDecade(n); }
+  void SetDEDXTableValidation(int n) { mDEDXValidationPeriod = n; }
 
   virtual void BeginOfRunAction(const G4Run*r);
+  virtual void EndOfRunAction(const G4Run*r);
   virtual void BeginOfEventAction(const G4Event * event);
   virtual void UserSteppingActionInVoxel(const int index, const G4Step* step);
 
@@ -73,6 +77,7 @@ protected:
   
   //virtual void polynomial(double* coefs, double deg, double x) {double yv;}
   virtual double polynomial(double * coefs, int deg, double x);
+  void ValidateDEDX(G4double energy, const G4ParticleDefinition* p, const G4Material* m, G4double dedx);
 
   int mCurrentEvent;
   bool mIsLETtoWaterEnabled;
@@ -116,6 +121,19 @@ protected:
   bool mIsParallelCalculationEnabled;
 
   G4EmCalculator * emcalc;
+
+  // Electronic dedx in the step material and in the other material (LET to water),
+  // interpolated in tables built once per (particle, material) during the run
+  GateStoppingPowerTable mDEDXTable;
+  GateStoppingPowerTable mOtherMaterialDEDXTable;
+  G4Material * mOtherMaterial;
+
+  // Validation: every n-th step, the tabulated dedx is compared to the exact one (0: never)
+  int mDEDXValidationPeriod;
+  long mDEDXValidationStepCount;
+  long mDEDXValidationCount;
+  double mDEDXValidationMaxRelDiff;
+  double mDEDXValidationSumRelDiff;
   
   StepHitType mUserStepHitType;
 };
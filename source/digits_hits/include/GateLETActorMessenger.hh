@@ -15,6 +15,7 @@ See LICENSE.md for further details
 
 #include "G4UIcmdWithABool.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAnInteger.hh"
 #include "GateImageActorMessenger.hh"
 #include "G4SystemOfUnits.hh" 
 
@@ -39,6 +40,8 @@ protected:
   G4UIcmdWithADoubleAndUnit * pCutValCmd;
   G4UIcmdWithADoubleAndUnit * pThrMinCmd;
   G4UIcmdWithADoubleAndUnit * pThrMaxCmd;
+  G4UIcmdWithAnInteger * pSetDEDXTableBinsCmd;
+  G4UIcmdWithAnInteger * pSetDEDXTableValidationCmd;
 };
 
 #endif /* end #define GATELETACTORMESSENGER_HH*/
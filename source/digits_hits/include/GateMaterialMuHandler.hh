@@ -17,6 +17,7 @@ See LICENSE.md for further details
 
 #include "GateMuTables.hh"
 #include "GatePhysicsList.hh"
+#include "GateSharedTableFile.hh"
 
 #include "G4UnitsTable.hh"
 #include "G4MaterialCutsCouple.hh"
@@ -83,6 +84,9 @@ public:
   void SetENumber(int n) { mEnergyNumber = n; }
   void SetAtomicShellEMin(double e) { mAtomicShellEnergyMin = e; }
   void SetPrecision(double p) { mPrecision = p; }
+  // Tables are attached from this file if it matches the materials and options,
+  // otherwise they are built and written to it
+  void SetCacheFileName(G4String name) { mCacheFileName = name; }
 
 private:
 
@@ -99,6 +103,10 @@ private:
   void MergeAtomicShell(std::vector<MuStorageStruct> *);
   double ProcessOneShot(G4VEmModel *,std::vector<G4DynamicParticle*> *, const G4MaterialCutsCouple *, const G4DynamicParticle *);
   double SquaredSigmaOnMean(double , double , double);
+  // - Shared, memory-mapped tables
+  uint64_t ComputeCacheHash();
+  bool AttachCacheFile();
+  void WriteCacheFile();
 
   map<const G4MaterialCutsCouple *, GateMuTable*> mCoupleTable;
   GateMuTable** mElementsTable;
@@ -111,11 +119,16 @@ private:
   int mEnergyNumber;
   double mAtomicShellEnergyMin;
   double mPrecision;
+  G4String mCacheFileName;
+  GateSharedTableFile mCacheFile;
 
   static GateMaterialMuHandler *singleton_MaterialMuHandler;
   
   // - fast acces
   void CheckLastCall(const G4MaterialCutsCouple *);
+  void BuildCoupleIndexTable();
+  // Same tables as mCoupleTable, indexed by G4MaterialCutsCouple::GetIndex()
+  std::vector<GateMuTable*> mCoupleIndexTable;
   const G4MaterialCutsCouple *mLastCouple;
   GateMuTable *mLastMuTable;
 
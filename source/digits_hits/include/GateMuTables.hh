@@ -19,10 +19,14 @@ See LICENSE.md for further details
 #include "G4MaterialCutsCouple.hh"
 #include "G4Material.hh"
 
+#include <vector>
+
 class GateMuTable
 {
 public:
   GateMuTable(const G4MaterialCutsCouple *couple, G4int size);
+  // Table using external (e.g. memory-mapped) values, which it does not own nor modify
+  GateMuTable(const G4MaterialCutsCouple *couple, G4int size, const double *energy, const double *mu, const double *mu_en);
   ~GateMuTable();
   void PutValue(int index, double energy, double mu, double mu_en);
   
@@ -41,7 +45,17 @@ public:
   double* GetMuTable() {return mMu;}
 
 private:
-  
+
+  void Init(const G4MaterialCutsCouple *couple, G4int size);
+
+  // Index of the table interval containing log(energy). Uses a uniform
+  // grid in log(energy) giving, for each bin, the interval of its lower
+  // bound: the search is a few comparisons instead of a bisection, and
+  // the intervals (thus the interpolation and the atomic shell edges)
+  // are unchanged.
+  int FindInterval(double logEnergy);
+  void BuildLogGrid();
+
   const G4MaterialCutsCouple *mCouple;
   const G4Material *mMaterial;
   double mDensity;
@@ -54,6 +68,11 @@ private:
   double lastMu;
   double lastMuen;
   G4int mSize;
+  bool mOwnsValues;
+
+  std::vector<int> mLogGrid;
+  double mLogGridMin;
+  double mLogGridInvBinWidth;
 };
 
 
@@ -21,6 +21,7 @@ class G4UIcmdWithADouble;
 class G4UIcmdWithADoubleAndUnit;
 class G4UIcmdWith3VectorAndUnit;
 class G4UIcmdWithoutParameter;
+class G4UIcmdWithABool;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 
@@ -39,6 +40,8 @@ private:
   G4UIcmdWithoutParameter*             DescribeCmd;
   G4UIcmdWithAnInteger*                VerboseCmd;
   G4UIcmdWithoutParameter*             AllowNoOutputCmd;
+  G4UIcmdWithADouble*                  NumpyBufferSizeCmd;
+  G4UIcmdWithABool*                    NumpyColumnarCmd;
 };
 
 #endif
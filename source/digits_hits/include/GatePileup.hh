@@ -13,12 +13,16 @@ See LICENSE.md for further details
 #include "globals.hh"
 #include <iostream>
 #include <vector>
+#include <deque>
+#include <queue>
+#include <unordered_map>
 #include "G4ThreeVector.hh"
 
+#include "GateOutputVolumeID.hh"
+
 #include "GateVPulseProcessor.hh"
 
 class GatePileupMessenger;
-class GateOutputVolumeID;
 
 /*! \class  GatePileup
     \brief  Pulse-processor modelling a pileup (maximum energy wins) of a crystal-block
@@ -32,6 +36,11 @@ class GateOutputVolumeID;
     - The class is largely inspired from the GateReadout class,
       but is aimed to work by time and not by event.
 
+    - Waiting pulses are indexed by block (truncated output volume ID) in time order, so
+      that a new pulse is only compared with the pulses of its own block within the window
+    - A min-heap of the waiting times gives the pulses whose window is over without
+      looking at the others; they are output in arrival order
+
       \sa GateVPulseProcessor
 */
 class GatePileup : public GateVPulseProcessor
@@ -75,7 +84,26 @@ class GatePileup : public GateVPulseProcessor
     //! taking place in a same block if the first two figures of their volume IDs are identical
     G4int m_depth;
     G4double m_pileup;
-    GatePulseList m_waiting;
+
+    //! A waiting pulse, with its time when the entry was made and its arrival number
+    struct WaitingPulse {
+      GatePulse* pulse;
+      G4double   time;
+      size_t     arrival;
+    };
+    static inline G4bool IsEarlier(const WaitingPulse& a,const WaitingPulse& b)
+    { return a.time<b.time || (a.time==b.time && a.arrival<b.arrival); }
+    struct IsLater {
+      G4bool operator()(const WaitingPulse& a,const WaitingPulse& b) const { return IsEarlier(b,a); }
+    };
+
+    //! Waiting pulses of each block, in time order (owns the pulses)
+    typedef std::unordered_map<GateOutputVolumeID,std::deque<WaitingPulse>,GateOutputVolumeIDHash> BlockIndex;
+    BlockIndex m_waitingPerBlock;
+    //! Waiting pulses by time. Merging pulses can only move their time forward: the pulse
+    //! is then queued again, and its older entry is dropped when it reaches the top
+    std::priority_queue<WaitingPulse,std::vector<WaitingPulse>,IsLater> m_expiryQueue;
+    size_t m_arrivalCount;               //!< Number of waiting pulses created so far
 
     GatePileupMessenger *m_messenger;	  //!< Messenger for this Pileup
 };
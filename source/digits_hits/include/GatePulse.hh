@@ -15,9 +15,11 @@ See LICENSE.md for further details
 #include <iostream>
 #include <vector>
 #include "G4ThreeVector.hh"
+#include "G4Allocator.hh"
 
 #include "GateVolumeID.hh"
 #include "GateOutputVolumeID.hh"
+#include "GateNameTable.hh"
 
 /*! \class  GatePulse
     \brief  Class for storing a 'pulse' (luminous or electronic) derived from one or more hits
@@ -31,6 +33,10 @@ See LICENSE.md for further details
 
     - S. Stute: june2014, add two methods used in the new GateReadout implementation
 
+    - Pulses are allocated from a G4Allocator free-list, and volume/process names are
+      stored as GateNameTable IDs, so that the many pulse copies made along the digitizer
+      chain do not go through malloc for each pulse and each name
+
       \sa GateVPulseProcessor, GatePulseProcessorChain
 */
 class GateVSystem;
@@ -50,6 +56,10 @@ public:
     //! Destructor
     virtual inline ~GatePulse() {}
 
+    //! Allocation from the pulse free-list
+    inline void* operator new(size_t);
+    inline void  operator delete(void*);
+
 public:
     //! \name getters and setters to acces the content of the pulse
     //@{
@@ -96,11 +106,13 @@ public:
     inline void  SetNCrystalRayleigh(G4int j)  { m_nCrystalRayleigh = j; }
     inline G4int GetNCrystalRayleigh() const        { return m_nCrystalRayleigh; }
 
-    inline void     SetComptonVolumeName(const G4String& name) { m_comptonVolumeName = name; }
-    inline G4String GetComptonVolumeName() const        { return m_comptonVolumeName; }
+    inline void     SetComptonVolumeName(const G4String& name) { m_comptonVolumeNameID = GateNameTable::GetID(name); }
+    inline const G4String& GetComptonVolumeName() const        { return GateNameTable::GetName(m_comptonVolumeNameID); }
+    inline void  SetComptonVolumeNameID(G4int id)              { m_comptonVolumeNameID = id; }
 
-    inline void     SetRayleighVolumeName(const G4String& name) { m_RayleighVolumeName = name; }
-    inline G4String GetRayleighVolumeName() const        { return m_RayleighVolumeName; }
+    inline void     SetRayleighVolumeName(const G4String& name) { m_RayleighVolumeNameID = GateNameTable::GetID(name); }
+    inline const G4String& GetRayleighVolumeName() const        { return GateNameTable::GetName(m_RayleighVolumeNameID); }
+    inline void  SetRayleighVolumeNameID(G4int id)              { m_RayleighVolumeNameID = id; }
 
     inline void  SetVolumeID(const GateVolumeID& volumeID)            { m_volumeID = volumeID; }
     inline const GateVolumeID& GetVolumeID() const                  	{ return m_volumeID; }
@@ -135,8 +147,10 @@ public:
 
 
     // AE : Added for IdealComptonPhot adder which take into account several Comptons in the same volume
-    inline void     SetPostStepProcess(G4String proc) { m_Postprocess = proc; }
-    inline G4String GetPostStepProcess() const             { return m_Postprocess; }
+    inline void     SetPostStepProcess(const G4String& proc) { m_PostprocessID = GateNameTable::GetID(proc); }
+    inline const G4String& GetPostStepProcess() const             { return GateNameTable::GetName(m_PostprocessID); }
+    inline void  SetPostStepProcessID(G4int id)                    { m_PostprocessID = id; }
+    inline G4int GetPostStepProcessID() const                      { return m_PostprocessID; }
 
     inline void SetEnergyIniTrack(G4double eIni)          { m_energyIniTrack = eIni; }
     inline G4double GetEnergyIniTrack() const                { return m_energyIniTrack; }
@@ -154,8 +168,10 @@ public:
     inline G4int GetNCrystalConv() const                { return m_nCrystalConv; }
 
 
-    inline void     SetProcessCreator(G4String proc) { m_processCreator = proc; }
-    inline G4String GetProcessCreator() const             { return m_processCreator; }
+    inline void     SetProcessCreator(const G4String& proc) { m_processCreatorID = GateNameTable::GetID(proc); }
+    inline const G4String& GetProcessCreator() const             { return GateNameTable::GetName(m_processCreatorID); }
+    inline void  SetProcessCreatorID(G4int id)                    { m_processCreatorID = id; }
+    inline G4int GetProcessCreatorID() const                      { return m_processCreatorID; }
 
     inline void SetTrackID(G4int trkID)          { m_trackID = trkID; }
     inline G4int GetTrackID() const                { return m_trackID; }
@@ -208,8 +224,8 @@ private:
     G4int m_nCrystalCompton;    	  //!< # of compton processes in the crystal occurred to the photon
     G4int m_nPhantomRayleigh;    	  //!< # of Rayleigh processes in the phantom occurred to the photon
     G4int m_nCrystalRayleigh;    	  //!< # of Rayleigh processes in the crystal occurred to the photon
-    G4String m_comptonVolumeName;   //!< name of the volume of the last (if any) compton scattering
-    G4String m_RayleighVolumeName;   //!< name of the volume of the last (if any) Rayleigh scattering
+    G4int m_comptonVolumeNameID;    //!< name (GateNameTable ID) of the volume of the last (if any) compton scattering
+    G4int m_RayleighVolumeNameID;   //!< name (GateNameTable ID) of the volume of the last (if any) Rayleigh scattering
     GateVolumeID m_volumeID;        //!< Volume ID in the world volume tree
     G4ThreeVector m_scannerPos; 	  //!< Position of the scanner
     G4double m_scannerRotAngle; 	  //!< Rotation angle of the scanner
@@ -221,10 +237,10 @@ private:
 
     // AE : Added for IdealComptonPhot adder which take into account several Comptons in the same volume
     //These variables no sense for a general pulse but I need them to  process idealy the hits. or create another structure
-    G4String m_Postprocess;         // PostStep process
+    G4int m_PostprocessID;          // PostStep process (GateNameTable ID)
     G4double m_energyIniTrack;         // Initial energy of the track
     G4double m_energyFin;         // final energy of the particle
-    G4String m_processCreator;
+    G4int m_processCreatorID;       // creator process (GateNameTable ID)
     G4int m_trackID;
     G4int m_parentID;
 
@@ -266,6 +282,11 @@ public:
     GatePulseList(const GatePulseList& src);
     virtual ~GatePulseList();
 
+    //! Allocation from the pulse-list free-list
+    //! (derived classes must define their own operators)
+    inline void* operator new(size_t);
+    inline void  operator delete(void*);
+
     //! Return the min-time of all pulses
     virtual GatePulse* FindFirstPulse() const ;
     virtual G4double ComputeStartTime() const ;
@@ -291,4 +312,28 @@ typedef GatePulseList::iterator GatePulseIterator;
 typedef GatePulseList::const_iterator GatePulseConstIterator;
 
 
+extern G4Allocator<GatePulse> GatePulseAllocator;
+extern G4Allocator<GatePulseList> GatePulseListAllocator;
+
+inline void* GatePulse::operator new(size_t)
+{
+  return (void *) GatePulseAllocator.MallocSingle();
+}
+
+inline void GatePulse::operator delete(void* aPulse)
+{
+  GatePulseAllocator.FreeSingle((GatePulse*) aPulse);
+}
+
+inline void* GatePulseList::operator new(size_t)
+{
+  return (void *) GatePulseListAllocator.MallocSingle();
+}
+
+inline void GatePulseList::operator delete(void* aList)
+{
+  GatePulseListAllocator.FreeSingle((GatePulseList*) aList);
+}
+
+
 #endif
@@ -0,0 +1,90 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+
+/*!
+  \class  GateStoppingPowerTable
+
+  - Cache of a stopping-power like quantity f(E, particle, material)
+    (dE/dx, stopping-power ratio, ...) computed with G4EmCalculator.
+  - For each (particle, material) pair met during the run, f is tabulated once
+    on a log-uniform energy grid, then each query is a linear interpolation.
+    Generic ions get their own table since each ion has its own particle definition.
+  - Energies outside the tabulated range, or a number of bins per decade set to 0,
+    fall back to the exact computation.
+  - Tables must be cleared (Clear()) at the beginning of each run, since materials
+    and production cuts may change between runs.
+ */
+
+#ifndef GATESTOPPINGPOWERTABLE_HH
+#define GATESTOPPINGPOWERTABLE_HH
+
+#include "globals.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Material.hh"
+
+#include <cmath>
+#include <functional>
+#include <map>
+#include <vector>
+
+class GateStoppingPowerTable
+{
+public:
+  typedef std::function<G4double(G4double, const G4ParticleDefinition*, const G4Material*)> ComputeFunction;
+
+  GateStoppingPowerTable();
+
+  //! Exact computation of the tabulated quantity
+  void SetComputeFunction(ComputeFunction f) { mFunction = f; Clear(); }
+  //! Tabulated energy range
+  void SetEnergyRange(G4double emin, G4double emax);
+  //! Number of log-uniform bins per energy decade (0: no table, exact computation)
+  void SetNumberOfBinsPerDecade(G4int n);
+  G4int GetNumberOfBinsPerDecade() const { return mBinsPerDecade; }
+
+  //! Remove all tables
+  void Clear();
+
+  //! Returns the exact value
+  inline G4double ComputeValue(G4double energy, const G4ParticleDefinition* p, const G4Material* m) const
+  { return mFunction(energy, p, m); }
+
+  //! Returns the interpolated value (exact value outside the tabulated range)
+  inline G4double GetValue(G4double energy, const G4ParticleDefinition* p, const G4Material* m)
+  {
+    if (mBinsPerDecade<=0 || energy<mEmin || energy>=mEmax) return mFunction(energy, p, m);
+    const std::vector<G4double>& table = GetTable(p, m);
+    const G4double x = (std::log(energy)-mLogEmin)*mInvLogStep;
+    size_t i = static_cast<size_t>(x);
+    if (i>=table.size()-1) i = table.size()-2;
+    return table[i] + (table[i+1]-table[i])*(x-i);
+  }
+
+  //! Number of tables built since the last Clear()
+  size_t GetNumberOfTables() const { return mTables.size(); }
+
+protected:
+  typedef std::pair<const G4ParticleDefinition*, const G4Material*> KeyType;
+
+  const std::vector<G4double>& GetTable(const G4ParticleDefinition* p, const G4Material* m);
+  void BuildTable(const G4ParticleDefinition* p, const G4Material* m, std::vector<G4double>& table);
+
+  ComputeFunction mFunction;
+  std::map<KeyType, std::vector<G4double> > mTables;
+  KeyType mLastKey;
+  const std::vector<G4double>* mLastTable;
+
+  G4double mEmin;
+  G4double mEmax;
+  G4int    mBinsPerDecade;
+  G4double mLogEmin;
+  G4double mInvLogStep;
+};
+
+#endif /* end #define GATESTOPPINGPOWERTABLE_HH */
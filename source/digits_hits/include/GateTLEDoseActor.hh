@@ -59,6 +59,8 @@ public:
   //virtual void PostUserTrackingAction(const GateVVolume *, const G4Track* t);
   virtual void UserSteppingAction(const GateVVolume *, const G4Step*);
   virtual void UserSteppingActionInVoxel(const int index, const G4Step* step);
+  virtual bool IsVoxelTraversalSupported() const { return true; }
+  virtual void UserSteppingActionInVoxelSegment(const int index, const G4Step* step, const G4double length);
   virtual void UserPreTrackActionInVoxel(const int /*index*/, const G4Track* /*t*/) {}
   virtual void UserPostTrackActionInVoxel(const int /*index*/, const G4Track* /*t*/) {}
 
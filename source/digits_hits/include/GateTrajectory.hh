@@ -121,7 +121,7 @@ public:
   void SetID(G4int id){mID=id;}
   void SetParentID(G4int id){mParentID=id;}
 
-  G4String GetParticleName(){return mParticleName;}
+  const G4String & GetParticleName() const {return mParticleName;}
   G4int GetID(){return mID;}
   G4int GetParentID(){return mParentID;}
 
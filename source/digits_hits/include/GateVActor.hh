@@ -25,6 +25,10 @@
 #include "G4String.hh"
 #include <iomanip>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <sstream>
 
 #include "GateActorManager.hh"
 #include "GateNamedObject.hh"
@@ -110,6 +114,11 @@ public:
   virtual void ResetData() = 0;
   void EnableSaveEveryNEvents(int n) { mSaveEveryNEvents = n; }
   void EnableSaveEveryNSeconds(int n) { mSaveEveryNSeconds = n; }
+  void EnableAsyncSave(bool b) { mIsAsyncSaveEnabled = b; }
+  // Intermediate save (every n events/seconds) when async save is
+  // enabled. By default it is synchronous; actors able to copy their
+  // data override it and write the copy with StartAsyncSave.
+  virtual void SaveDataAsync() { SaveData(); }
   void SetOverWriteFilesFlag(bool b) { mOverWriteFilesFlag = b; }
   void EnableResetDataAtEachRun(bool b) { mResetDataAtEachRun = b; }
   //-----------------------------------------------------------------------------
@@ -131,6 +140,13 @@ protected:
 
   virtual G4bool ProcessHits(G4Step * step, G4TouchableHistory *) { UserSteppingAction(0, step); return true; }
 
+  // At most one save in flight per actor: StartAsyncSave must only be
+  // called when IsAsyncSaveRunning() is false. SaveData waits for the
+  // running one, so that files are never written twice at the same time.
+  bool IsAsyncSaveRunning() const { return mAsyncSaveRunning; }
+  void StartAsyncSave(std::function<void()> f);
+  void WaitForAsyncSave();
+
   G4int mNumOfFilters;
 
   //-----------------------------------------------------------------------------
@@ -153,6 +169,10 @@ protected:
   G4String mSaveFilename;
   int mSaveFileDescriptor;
   struct timeval mTimeOfLastSaveEvent;
+  bool mIsAsyncSaveEnabled;
+  std::thread mAsyncSaveThread;
+  std::atomic<bool> mAsyncSaveRunning;
+  std::ostringstream mAsyncSaveLog; // messages of the save thread, printed by WaitForAsyncSave
   //-----------------------------------------------------------------------------
 
 };
@@ -22,6 +22,8 @@ See LICENSE.md for further details
 #include "GateImageWithStatistic.hh"
 #include "Randomize.hh"
 
+#include <vector>
+
 //-----------------------------------------------------------------------------
 /// \brief Base (virtual) class for sensor storing data in a 3D matrix
 /// (GateImage)
@@ -29,7 +31,7 @@ class GateVImageActor: public GateVActor
 {
 public :
   //-----------------------------------------------------------------------------
-  enum StepHitType {PreStepHitType, PostStepHitType, MiddleStepHitType, RandomStepHitType, RandomStepHitTypeCylindricalCS, PostStepHitTypeCylindricalCS};
+  enum StepHitType {PreStepHitType, PostStepHitType, MiddleStepHitType, RandomStepHitType, RandomStepHitTypeCylindricalCS, PostStepHitTypeCylindricalCS, TraversalStepHitType};
 
   //-----------------------------------------------------------------------------
   /// Constructs the class
@@ -79,6 +81,13 @@ public :
   virtual void UserSteppingActionInVoxel(const int index, const G4Step* step) = 0;
   virtual void UserPreTrackActionInVoxel(const int index, const G4Track* t) = 0;
   virtual void UserPostTrackActionInVoxel(const int index, const G4Track* t) = 0;
+
+  /// With the 'traversal' step hit type, the straight segment of the
+  /// step is split among all the crossed voxels and this callback is
+  /// called for each of them with the length of the step inside the
+  /// voxel. Actors supporting it must override both functions.
+  virtual bool IsVoxelTraversalSupported() const { return false; }
+  virtual void UserSteppingActionInVoxelSegment(const int /*index*/, const G4Step* /*step*/, const G4double /*length*/) {}
   //-----------------------------------------------------------------------------
 
   virtual void ResetData();
@@ -90,6 +99,13 @@ public :
                                        const G4ThreeVector mPosition,
                                        const StepHitType mStepHitType);
 
+  static bool GetStepPositionsInVolume(const GateVVolume *,
+                                       const G4Step  * step,
+                                       const bool mPositionIsSet,
+                                       const G4ThreeVector mPosition,
+                                       G4ThreeVector & prePosition,
+                                       G4ThreeVector & postPosition);
+
 protected:
 
   //-----------------------------------------------------------------------------
@@ -109,9 +125,12 @@ protected:
   bool           mResolutionIsSet;
   bool           mHalfSizeIsSet;
   bool           mPositionIsSet;
+  std::vector<std::pair<int, G4double> > mVoxelSegments;
 
   int GetIndexFromTrackPosition(const GateVVolume *, const G4Track * track);
   int GetIndexFromStepPosition(const GateVVolume *, const G4Step  * step);
+  void GetVoxelSegmentsFromStep(const GateVVolume *, const G4Step * step,
+                                std::vector<std::pair<int, G4double> > & segments);
 
 }; // end class GateVImageActor
 
@@ -13,6 +13,9 @@
 #include "GateActorManager.hh"
 #include "GateVActor.hh"
 #include "GateMultiSensitiveDetector.hh"
+#include "GateFilterManager.hh"
+
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 GateActorManager::GateActorManager()
@@ -151,6 +154,7 @@ void GateActorManager::BeginOfRunAction(const G4Run* run)
   std::vector<GateVActor*>::iterator sit;
 
   //GateMessage("Core", 0, "Run " << run->GetRunID() << " is starting.\n");
+  InitializeFilters();
   for (sit = theListOfActorsEnabledForBeginOfRun.begin(); sit!=theListOfActorsEnabledForBeginOfRun.end(); ++sit)
     (*sit)->BeginOfRunAction(run);
 
@@ -217,16 +221,61 @@ void GateActorManager::PostUserTrackingAction(const G4Track* track)
 //-----------------------------------------------------------------------------
 void GateActorManager::UserSteppingAction(const G4Step* step)
 {
-  std::vector<GateVActor*>::iterator sit;
+  if (theStepFilterChainIndex.size() != theListOfActorsEnabledForUserSteppingAction.size())
+    InitializeFilters();
+  std::fill(theStepFilterChainResults.begin(), theStepFilterChainResults.end(), -1);
+
   // GateDebugMessage("Actor", 1, "list = " << theListOfActorsEnabledForUserSteppingAction.size() << Gateendl);
+  for (size_t i = 0; i < theListOfActorsEnabledForUserSteppingAction.size(); ++i)
+    {
+      GateVActor * actor = theListOfActorsEnabledForUserSteppingAction[i];
+      // GateDebugMessage("Actor", 1, "Step for " << actor->GetObjectName());
+      G4int chain = theStepFilterChainIndex[i];
+      if (chain >= 0) {
+        G4int & result = theStepFilterChainResults[chain];
+        if (result < 0) result = theListOfStepFilterChains[chain]->Accept(step) ? 1 : 0;
+        if (!result) continue;
+      }
+      actor->UserSteppingAction(0, step);
+    }
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateActorManager::InitializeFilters()
+{
+  std::vector<GateVActor*>::iterator sit;
+  for (sit = theListOfActors.begin(); sit!=theListOfActors.end(); ++sit)
+    if ((*sit)->GetNumberOfFilters()!=0) (*sit)->GetFilterManager()->Initialize();
+
+  // Stepping actors with the same (shareable) filter chain use a single
+  // evaluation per step
+  theListOfStepFilterChains.clear();
+  theStepFilterChainIndex.clear();
+  std::map<G4String, G4int> chainOfSignature;
   for (sit = theListOfActorsEnabledForUserSteppingAction.begin(); sit!=theListOfActorsEnabledForUserSteppingAction.end(); ++sit)
     {
-      // GateDebugMessage("Actor", 1, "Step for " << (*sit)->GetObjectName());
-      if ((*sit)->GetNumberOfFilters()!=0){
-        if (!(*sit)->GetFilterManager()->Accept(step) ) continue;
+      if ((*sit)->GetNumberOfFilters()==0) {
+        theStepFilterChainIndex.push_back(-1);
+        continue;
+      }
+      GateFilterManager * filters = (*sit)->GetFilterManager();
+      G4String signature = filters->GetSignature();
+      if (signature != "") {
+        std::map<G4String, G4int>::iterator it = chainOfSignature.find(signature);
+        if (it != chainOfSignature.end()) {
+          GateMessage("Actor", 1, "Actor " << (*sit)->GetObjectName()
+                      << " reuses the result of filter chain " << theListOfStepFilterChains[it->second]->GetName() << Gateendl);
+          filters->SetShared(true);
+          theStepFilterChainIndex.push_back(it->second);
+          continue;
+        }
+        chainOfSignature[signature] = theListOfStepFilterChains.size();
       }
-      (*sit)->UserSteppingAction(0, step);
+      theStepFilterChainIndex.push_back(theListOfStepFilterChains.size());
+      theListOfStepFilterChains.push_back(filters);
     }
+  theStepFilterChainResults.assign(theListOfStepFilterChains.size(), -1);
 }
 //-----------------------------------------------------------------------------
 
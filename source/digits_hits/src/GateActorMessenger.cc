@@ -37,6 +37,7 @@ GateActorMessenger::~GateActorMessenger()
   delete pSetVolumeNameCmd;
   delete pSaveEveryNEventsCmd;
   delete pSaveEveryNSecondsCmd;
+  delete pEnableAsyncSaveCmd;
   delete pAddFilterCmd;
   delete pSetOverWriteFilesFlagCmd;
 }
@@ -83,6 +84,11 @@ void GateActorMessenger::BuildCommands(G4String base)
   pSaveEveryNSecondsCmd->SetGuidance(guidance);
   pSaveEveryNSecondsCmd->SetParameterName("Number of seconds between next save",false);
 
+  bb = base+"/enableAsyncSave";
+  pEnableAsyncSaveCmd = new G4UIcmdWithABool(bb,this);
+  guidance = "Write the intermediate saves (saveEveryNEvents/saveEveryNSeconds) in a background thread, from a copy of the data.";
+  pEnableAsyncSaveCmd->SetGuidance(guidance);
+
   bb = base+"/addFilter";
   pAddFilterCmd = new G4UIcmdWithAString(bb,this);
   guidance = "Add a new filter";
@@ -109,6 +115,9 @@ void GateActorMessenger::SetNewValue(G4UIcommand* command, G4String param)
   if (command == pSaveEveryNSecondsCmd)
     pActor->EnableSaveEveryNSeconds(pSaveEveryNSecondsCmd->GetNewIntValue(param));
 
+  if (command == pEnableAsyncSaveCmd)
+    pActor->EnableAsyncSave(pEnableAsyncSaveCmd->GetNewBoolValue(param));
+
   if (command == pSetOverWriteFilesFlagCmd)
     pActor->SetOverWriteFilesFlag(pSetOverWriteFilesFlagCmd->GetNewBoolValue(param));
 
@@ -11,6 +11,8 @@ See LICENSE.md for further details
 
 #include "G4UnitsTable.hh"
 
+G4Allocator<GateCoincidencePulse> GateCoincidencePulseAllocator;
+
 GateCoincidencePulse::GateCoincidencePulse(const GateCoincidencePulse& src)
    :GatePulseList(src)
 {
@@ -24,6 +24,7 @@ See LICENSE.md for further details
 #include "GateVSystem.hh"
 #include "GateCoincidenceDigiMaker.hh"
 
+#include <algorithm>
 //#include <map>
 
 //------------------------------------------------------------------------------------------------------
@@ -46,6 +47,7 @@ GateCoincidenceSorter::GateCoincidenceSorter(GateDigitizer* itsDigitizer,
     m_multiplesPolicy(kKeepIfAllAreGoods),
     m_allPulseOpenCoincGate(false),
     m_depth(1),
+    m_presortCounter(0),
     m_presortBufferSize(256),
     m_presortWarning(false),
     m_CCSorter(IsCCSorter),
@@ -54,6 +56,7 @@ GateCoincidenceSorter::GateCoincidenceSorter(GateDigitizer* itsDigitizer,
 
   // Create the messenger
   m_messenger = new GateCoincidenceSorterMessenger(this);
+  m_presortBuffer.reserve(m_presortBufferSize+1);
   //if(m_CCSorter==true)
 
   coincID_CC=0;
@@ -69,7 +72,7 @@ GateCoincidenceSorter::~GateCoincidenceSorter()
   while(m_presortBuffer.size() > 0)
   {
      // G4cout<<"[GateCoincidenceSorter::~GateCoincidenceSorter()] m_presortBuffer.size="<<m_presortBuffer.size()<<G4endl;
-    delete m_presortBuffer.back();
+    delete m_presortBuffer.back().pulse;
     m_presortBuffer.pop_back();
   }
 
@@ -151,7 +154,6 @@ void GateCoincidenceSorter::SetAcceptancePolicy4CC(const G4String &policy)
 void GateCoincidenceSorter::ProcessSinglePulseList(GatePulseList* inp)
 {
   GatePulse* pulse;
-  std::list<GatePulse*>::iterator buf_iter;                // presort buffer iterator
   std::deque<GateCoincidencePulse*>::iterator coince_iter; // coincidence list iterator
 
   G4bool inCoincidence;
@@ -195,31 +197,24 @@ void GateCoincidenceSorter::ProcessSinglePulseList(GatePulseList* inp)
     return ;
 
   // put input pulses in sorted input buffer
+  // The buffer is a binary heap whose top is the earliest pulse, so that each insertion
+  // costs O(log n) whatever the presort buffer size
   for(gpl_iter = inputPulseList->begin();gpl_iter != inputPulseList->end();gpl_iter++)
   {
       // make a copy of the pulse
       pulse = new GatePulse(**gpl_iter);
 
-      if(m_presortBuffer.empty())
-          m_presortBuffer.push_back(pulse);
-      else if(pulse->GetTime() < m_presortBuffer.back()->GetTime())    // check that even isn't earlier than the earliest event in the buffer
+      // check that even isn't earlier than the earliest event in the buffer
+      if(!m_presortBuffer.empty() && pulse->GetTime() < m_presortBuffer.front().time)
       {
           if(!m_presortWarning)
               GateWarning("Event is earlier than earliest event in coincidence presort buffer. Consider using a larger buffer.");
-          m_presortWarning = true;
-          m_presortBuffer.push_back(pulse); // this will probably not cause a problem, but coincidences may be missed
-      }
-      else // put the event into the presort buffer in the right place
-      {
-          buf_iter = m_presortBuffer.begin();
-          while(pulse->GetTime() < (*buf_iter)->GetTime())
-              buf_iter++;
-          m_presortBuffer.insert(buf_iter, pulse);
-          //      G4cout<<"presortBuffer filled in position "<<std::distance(m_presortBuffer.begin(),buf_iter)<<G4endl;
-          //      G4cout<<"pulseTime "<<pulse->GetTime()<<G4endl;
-          //      G4cout<<"pulseTime "<<pulse->GetTime()/ns<<G4endl;
+          m_presortWarning = true; // this will probably not cause a problem, but coincidences may be missed
       }
 
+      PresortEntry entry = { pulse->GetTime(), m_presortCounter++, pulse };
+      m_presortBuffer.push_back(entry);
+      std::push_heap(m_presortBuffer.begin(), m_presortBuffer.end(), PresortLater());
   }
 
 
@@ -227,7 +222,8 @@ void GateCoincidenceSorter::ProcessSinglePulseList(GatePulseList* inp)
   for(G4int i = m_presortBuffer.size();i > m_presortBufferSize;i--)
   {
 
-    pulse = m_presortBuffer.back();
+    std::pop_heap(m_presortBuffer.begin(), m_presortBuffer.end(), PresortLater());
+    pulse = m_presortBuffer.back().pulse;
     m_presortBuffer.pop_back();
 
     // process completed coincidence pulse window at front of list
@@ -13,8 +13,11 @@ See LICENSE.md for further details
 #include "G4VisAttributes.hh"
 #include "G4UnitsTable.hh"
 #include "G4ios.hh"
+#include "G4NavigationHistory.hh"
+#include "G4TouchableHistory.hh"
 
 #include "GateCrystalHit.hh"
+#include "GateVSystem.hh"
 
 
 G4Allocator<GateCrystalHit> GateCrystalHitAllocator;
@@ -24,10 +27,18 @@ GateCrystalHit::GateCrystalHit()
 : m_edep(0),
   m_stepLength(0),
   m_time(0.),
+  m_processID(0),
   m_PDGEncoding(0),
   m_trackID(0),
   m_parentID(0),
+  m_comptonVolumeNameID(0),
+  m_RayleighVolumeNameID(0),
   m_systemID(-1),
+  m_system(0),
+  m_localPosSet(false),
+  m_volumeIDSet(false),
+  m_outputVolumeIDSet(false),
+  m_PostprocessID(0),
   m_sourceEnergy(-1),
   m_sourcePDG(0),
   m_nCrystalConv(0)
@@ -41,6 +52,50 @@ GateCrystalHit::~GateCrystalHit()
 //---------------------------------------------------------------------
 
 
+//---------------------------------------------------------------------
+void GateCrystalHit::SetTouchable(const G4TouchableHandle& touchable,GateVSystem* system)
+{
+  m_touchable = touchable;
+  m_system = system;
+  m_localPosSet = false;
+  m_volumeIDSet = false;
+  m_outputVolumeIDSet = false;
+}
+//---------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------
+// The navigation history of the touchable holds the global-to-local transform
+// of the step volume: no need to go through the volumeID
+void GateCrystalHit::ComputeLocalPos() const
+{
+  if (m_touchable())
+    m_localPos = m_touchable->GetHistory()->GetTopTransform().TransformPoint(m_pos);
+  m_localPosSet = true;
+}
+//---------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------
+void GateCrystalHit::ComputeVolumeID() const
+{
+  if (m_touchable())
+    m_volumeID = GateVolumeID((const G4TouchableHistory*)m_touchable());
+  m_volumeIDSet = true;
+}
+//---------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------
+void GateCrystalHit::ComputeOutputVolumeID() const
+{
+  if (m_system)
+    m_outputVolumeID = m_system->ComputeOutputVolumeID(GetVolumeID());
+  m_outputVolumeIDSet = true;
+}
+//---------------------------------------------------------------------
+
+
 //---------------------------------------------------------------------
 void GateCrystalHit::Draw()
 {
@@ -73,11 +128,11 @@ std::ostream& operator<<(std::ostream& flux, const GateCrystalHit& hit)
 {
   flux   << "("
 	 << "E=" << G4BestUnit(hit.m_edep,"Energy") << ", "
-	 << "proc=" << hit.m_process << ", "
+	 << "proc=" << hit.GetProcess() << ", "
 	 << "particle= " << ( (hit.m_PDGEncoding == 22) ? "gamma" : ( (hit.m_PDGEncoding == 11) ? "e-" : "?" ) ) << ", "
 	 << "track=" << hit.m_trackID  << " (son of " << hit.m_parentID    << ") " << ", "
 //	 << "outputID= " << hit.GetOutputVolumeID() << ", "
-	 << "localPos= [" << G4BestUnit(hit.m_localPos,"Length")    << "], "
+	 << "localPos= [" << G4BestUnit(hit.GetLocalPos(),"Length")    << "], "
 	 << "Pos= ["      << G4BestUnit(hit.m_pos,"Length")         << "], "
 	 << "Step=  " << G4BestUnit(hit.m_stepLength,"Length")  << ", "
 	 << "Time= " << G4BestUnit(hit.m_time,"Time") << ", "
@@ -110,9 +165,9 @@ std::ofstream& operator<<(std::ofstream& flux, GateCrystalHit* hit)
 	 << " " << std::setw(3) << hit->m_photonID
 	 << " " << std::setw(4) << hit->m_nPhantomCompton
 	 << " " << std::setw(4) << hit->m_nPhantomRayleigh
-	 << " " << hit->m_process
-	 << " " << hit->m_comptonVolumeName
-	 << " " << hit->m_RayleighVolumeName
+	 << " " << hit->GetProcess()
+	 << " " << hit->GetComptonVolumeName()
+	 << " " << hit->GetRayleighVolumeName()
 	 << Gateendl;
 
   return flux;
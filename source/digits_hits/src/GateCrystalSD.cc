@@ -38,7 +38,7 @@ const G4String GateCrystalSD::theCrystalCollectionName = "crystalCollection";
 //------------------------------------------------------------------------------
 // Constructor
 GateCrystalSD::GateCrystalSD(const G4String& name)
-:G4VSensitiveDetector(name),m_system(0)
+:G4VSensitiveDetector(name),m_system(0),m_transportationID(GateNameTable::GetID("Transportation"))
 {
   collectionName.insert(theCrystalCollectionName);
 }
@@ -107,7 +107,6 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
   G4double trackLength  = aTrack->GetTrackLength();
   G4double trackLocalTime = aTrack->GetLocalTime();
 
-  G4String partName     = aTrack->GetDefinition()->GetParticleName();
   G4int    PDGEncoding  = aTrack->GetDefinition()->GetPDGEncoding();
 
   //Get information about gamma ( generated by ExtendedVSource )
@@ -131,23 +130,15 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
       	       *newStepPoint = aStep->GetPostStepPoint();
 
 
-  //  Get the process name
-  const G4VProcess* process = newStepPoint->GetProcessDefinedStep();
-  G4String processName = ( (process != NULL) ? process->GetProcessName() : G4String() ) ;
+  //  Get the process
+  G4int processID = GetProcessID( newStepPoint->GetProcessDefinedStep() );
 
   //  For all processes except transportation, we select the PostStepPoint volume
   //  For the transportation, we select the PreStepPoint volume
-  const G4TouchableHistory* touchable;
-  if ( processName == "Transportation" )
-      touchable = (const G4TouchableHistory*)(oldStepPoint->GetTouchable() );
-  else
-      touchable = (const G4TouchableHistory*)(newStepPoint->GetTouchable() );
+  const G4TouchableHandle& touchable = ( processID == m_transportationID ) ?
+      oldStepPoint->GetTouchableHandle() : newStepPoint->GetTouchableHandle();
 
-
-  GateVolumeID volumeID(touchable);
-
-
-  if (volumeID.IsInvalid())
+  if ( !touchable() || !touchable->GetVolume() )
     G4Exception( "GateCrystalSD::ProcessHits", "ProcessHits", FatalException, "could not get the volume ID! Aborting!\n");
 
   // Get the hit global position
@@ -158,14 +149,9 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
   // Get the hit momentumDirecton
   G4ThreeVector momentumDirection = newStepPoint->GetMomentumDirection();
 
-  // Compute the hit local position
-  // (It will be in the reference frame of the PreStepPoint volume for a transportation hit)
-  G4ThreeVector localPosition = volumeID.MoveToBottomVolumeFrame(position);
-
-
   // Get the scanner position and rotation angle
 /*  GateSystemComponent* baseComponent = GetSystem()->GetBaseComponent();*/
-  GateVSystem* system = FindSystem(volumeID);
+  GateVSystem* system = FindSystem(touchable());
   GateSystemComponent* baseComponent = system->GetBaseComponent();
   G4ThreeVector scannerPos = baseComponent->GetCurrentTranslation();
   G4double scannerRotAngle = 0;
@@ -188,7 +174,7 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
   G4double stepLength = aStep->GetStepLength();
   // time of the current step
   G4double aTime = newStepPoint->GetGlobalTime();
-  // Create a new crystal hit
+  // Create a new crystal hit (from the G4Allocator free-list of the hits)
   GateCrystalHit* aHit = new GateCrystalHit();
 
   // Store the data already obtained into the hit
@@ -197,15 +183,13 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
   aHit->SetStepLength( stepLength );
   aHit->SetTime( aTime );
   aHit->SetGlobalPos( position );
-  aHit->SetLocalPos( localPosition );
-  aHit->SetProcess( processName );
+  aHit->SetProcessID( processID );
   aHit->SetTrackID( trackID );
  // Seb Modif 5/4/2016 
   aHit->SetTrackLength( trackLength );
   aHit->SetTrackLocalTime( trackLocalTime );
   aHit->SetMomentumDir( momentumDirection );
   aHit->SetParentID( parentID );
-  aHit->SetVolumeID( volumeID );
   aHit->SetScannerPos( scannerPos );
   aHit->SetScannerRotAngle( scannerRotAngle );
   aHit->SetSystemID(system->GetItsNumber());
@@ -213,12 +197,10 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
   aHit->SetDecayType( decay_type );
   aHit->SetGammaType( gamma_type );
 
-  // Ask the system to compute the output volume ID and store it into the hit
-
-//Seb Modif 24/02/2009
-/*  GateOutputVolumeID outputVolumeID = GetSystem()->ComputeOutputVolumeID(aHit->GetVolumeID());*/
-  GateOutputVolumeID outputVolumeID = system->ComputeOutputVolumeID(aHit->GetVolumeID());
-  aHit->SetOutputVolumeID(outputVolumeID);
+  // The local position, the volume ID and the output volume ID (computed by the system)
+  // are computed from the touchable when they are first needed
+  // (It will be in the reference frame of the PreStepPoint volume for a transportation hit)
+  aHit->SetTouchable( touchable, system );
 
   // Insert the new hit into the hit collection
   crystalCollection->insert( aHit );
@@ -298,6 +280,37 @@ GateVSystem* GateCrystalSD::FindSystem(GateVolumeID volumeID)
 //------------------------------------------------------------------------------
 
 
+//------------------------------------------------------------------------------
+GateVSystem* GateCrystalSD::FindSystem(const G4VTouchable* touchable)
+{
+   // The system volume is the one just below the world (level 1 of the volumeID)
+   const G4VPhysicalVolume* systemVolume = touchable->GetVolume(touchable->GetHistoryDepth()-1);
+   std::unordered_map<const G4VPhysicalVolume*,GateVSystem*>::const_iterator it = m_systems.find(systemVolume);
+   if (it != m_systems.end()) return it->second;
+
+   G4String hitSystemName = systemVolume->GetName();
+   size_t n = hitSystemName.size();
+   hitSystemName.erase(n-5,5);
+   GateVSystem* system = FindSystem(hitSystemName);
+   m_systems[systemVolume] = system;
+   return system;
+}
+//------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------
+G4int GateCrystalSD::GetProcessID(const G4VProcess* process)
+{
+   if (!process) return 0;
+   std::unordered_map<const G4VProcess*,G4int>::const_iterator it = m_processIDs.find(process);
+   if (it != m_processIDs.end()) return it->second;
+   G4int id = GateNameTable::GetID(process->GetProcessName());
+   m_processIDs[process] = id;
+   return id;
+}
+//------------------------------------------------------------------------------
+
+
 //------------------------------------------------------------------------------
 GateVSystem* GateCrystalSD::FindSystem(G4String& systemName)
 {
@@ -425,7 +425,7 @@ void GateDigitizer::Digitize()
 }
 
 
-void GateDigitizer::Digitize(std::vector<GateCrystalHit*> vHitsCollection)
+void GateDigitizer::Digitize(const std::vector<GateCrystalHit*>& vHitsCollection)
 {
   if ( !IsEnabled() )
     return;
@@ -16,6 +16,7 @@
 #include "GateMiscFunctions.hh"
 
 // g4
+#include <memory>
 #include <G4EmCalculator.hh>
 #include <G4VoxelLimits.hh>
 #include <G4NistManager.hh>
@@ -63,6 +64,8 @@ GateDoseActor::GateDoseActor(G4String name, G4int depth):
   //Others
   mIsNumberOfHitsImageEnabled = false;
   mIsLastHitEventImageEnabled = false;
+  mIsLeanStatisticsEnabled = false;
+  mIsFloatAccumulatorEnabled = false;
   mDoseAlgorithmType = "VolumeWeighting";
   mImportMassImage = "";
   mExportMassImage = "";
@@ -70,10 +73,28 @@ GateDoseActor::GateDoseActor(G4String name, G4int depth):
   mMaterialFilter = "";
   mTestFlag = false;
   mDoseByRegionsFlag = false;
+  mDoseToWaterValidationPeriod = 0;
+  mDoseToWaterValidationTolerance = 0;
+  mDoseToWaterValidationStepCount = 0;
+  mDoseToWaterValidationCount = 0;
+  mDoseToWaterValidationMaxRelDiff = 0;
+  mDoseToWaterValidationSumRelDiff = 0;
 
   pMessenger = new GateDoseActorMessenger(this);
   GateDebugMessageDec("Actor",4,"GateDoseActor() -- end\n");
   emcalc = new G4EmCalculator;
+
+  // Ratio of the total dedx in water to the total dedx in the material (no cut),
+  // 0 for particles without dedx (neutrons)
+  mDoseToWaterRatioTable.SetComputeFunction([this](G4double energy,
+                                                   const G4ParticleDefinition * particle,
+                                                   const G4Material * material) {
+      static G4Material * water = G4NistManager::Instance()->FindOrBuildMaterial("G4_WATER");
+      double DEDX = emcalc->ComputeTotalDEDX(energy, particle, material, DBL_MAX);
+      double DEDX_Water = emcalc->ComputeTotalDEDX(energy, particle, water, DBL_MAX);
+      if (DEDX==0 || DEDX_Water==0) return 0.0;
+      return DEDX_Water/DEDX;
+    });
 }
 //-----------------------------------------------------------------------------
 
@@ -81,6 +102,8 @@ GateDoseActor::GateDoseActor(G4String name, G4int depth):
 //-----------------------------------------------------------------------------
 /// Destructor
 GateDoseActor::~GateDoseActor()  {
+  // a save in progress must not read the hits image once deleted
+  GateImageCopyOnWrite::BeforeWriteAll(mNumberOfHitsCopyOnWrite);
   delete pMessenger;
 }
 //-----------------------------------------------------------------------------
@@ -214,10 +237,12 @@ void GateDoseActor::Construct() {
   SetOriginTransformAndFlagToImage(mMassImage);
 
   // Resize and allocate images
-  if (mIsEdepSquaredImageEnabled || mIsEdepUncertaintyImageEnabled ||
-      mIsDoseSquaredImageEnabled || mIsDoseUncertaintyImageEnabled ||
-      mIsDoseToWaterSquaredImageEnabled || mIsDoseToWaterUncertaintyImageEnabled ||
-      mIsDoseToOtherMaterialSquaredImageEnabled || mIsDoseToOtherMaterialUncertaintyImageEnabled)
+  // (with lean statistics, events are separated by EndOfEvent instead)
+  if (!mIsLeanStatisticsEnabled &&
+      (mIsEdepSquaredImageEnabled || mIsEdepUncertaintyImageEnabled ||
+       mIsDoseSquaredImageEnabled || mIsDoseUncertaintyImageEnabled ||
+       mIsDoseToWaterSquaredImageEnabled || mIsDoseToWaterUncertaintyImageEnabled ||
+       mIsDoseToOtherMaterialSquaredImageEnabled || mIsDoseToOtherMaterialUncertaintyImageEnabled))
     {
       mLastHitEventImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
       mLastHitEventImage.Allocate();
@@ -228,6 +253,8 @@ void GateDoseActor::Construct() {
     //  mEdepImage.SetLastHitEventImage(&mLastHitEventImage);
     mEdepImage.EnableSquaredImage(mIsEdepSquaredImageEnabled);
     mEdepImage.EnableUncertaintyImage(mIsEdepUncertaintyImageEnabled);
+    mEdepImage.EnableLeanMode(mIsLeanStatisticsEnabled);
+    mEdepImage.EnableFloatAccumulators(mIsFloatAccumulatorEnabled);
     // Force the computation of squared image if uncertainty is enabled
     if (mIsEdepUncertaintyImageEnabled) mEdepImage.EnableSquaredImage(true);
     mEdepImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
@@ -239,6 +266,8 @@ void GateDoseActor::Construct() {
     // mDoseImage.SetLastHitEventImage(&mLastHitEventImage);
     mDoseImage.EnableSquaredImage(mIsDoseSquaredImageEnabled);
     mDoseImage.EnableUncertaintyImage(mIsDoseUncertaintyImageEnabled);
+    mDoseImage.EnableLeanMode(mIsLeanStatisticsEnabled);
+    mDoseImage.EnableFloatAccumulators(mIsFloatAccumulatorEnabled);
     mDoseImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
     // Force the computation of squared image if uncertainty is enabled
     if (mIsDoseUncertaintyImageEnabled) mDoseImage.EnableSquaredImage(true);
@@ -249,6 +278,8 @@ void GateDoseActor::Construct() {
   if (mIsDoseToWaterImageEnabled) {
     mDoseToWaterImage.EnableSquaredImage(mIsDoseToWaterSquaredImageEnabled);
     mDoseToWaterImage.EnableUncertaintyImage(mIsDoseToWaterUncertaintyImageEnabled);
+    mDoseToWaterImage.EnableLeanMode(mIsLeanStatisticsEnabled);
+    mDoseToWaterImage.EnableFloatAccumulators(mIsFloatAccumulatorEnabled);
     // Force the computation of squared image if uncertainty is enabled
     if (mIsDoseToWaterUncertaintyImageEnabled) mDoseToWaterImage.EnableSquaredImage(true);
     mDoseToWaterImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
@@ -259,6 +290,8 @@ void GateDoseActor::Construct() {
   if (mIsDoseToOtherMaterialImageEnabled) {
     mDoseToOtherMaterialImage.EnableSquaredImage(mIsDoseToOtherMaterialSquaredImageEnabled);
     mDoseToOtherMaterialImage.EnableUncertaintyImage(mIsDoseToOtherMaterialUncertaintyImageEnabled);
+    mDoseToOtherMaterialImage.EnableLeanMode(mIsLeanStatisticsEnabled);
+    mDoseToOtherMaterialImage.EnableFloatAccumulators(mIsFloatAccumulatorEnabled);
     // Force the computation of squared image if uncertainty is enabled
     if (mIsDoseToOtherMaterialUncertaintyImageEnabled) mDoseToOtherMaterialImage.EnableSquaredImage(true);
     mDoseToOtherMaterialImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
@@ -478,6 +511,58 @@ void GateDoseActor::SaveData() {
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateDoseActor::SaveDataAsync() {
+  // Dose by regions is not part of the copy, and ROOT output is not
+  // thread safe: save synchronously
+  if (mDoseByRegionsFlag || getExtension(mSaveFilename) == "root") {
+    SaveData();
+    return;
+  }
+  if (IsAsyncSaveRunning()) {
+    GateMessage("Actor", 1, "DoseActor " << GetObjectName()
+                << ": previous save still in progress, skip this one" << Gateendl);
+    return;
+  }
+  GateVActor::SaveData();
+
+  // Snapshots of the images (copy-on-write): the live ones keep accumulating
+  // while the snapshots are copied, normalized and written
+  typedef std::pair<std::shared_ptr<GateImageWithStatistic>, bool> Snapshot;
+  std::vector<Snapshot> snapshots;
+  if (mIsEdepImageEnabled)
+    snapshots.push_back(Snapshot(mEdepImage.CreateSnapshot(), false));
+  if (mIsDoseImageEnabled)
+    snapshots.push_back(Snapshot(mDoseImage.CreateSnapshot(), mIsDoseNormalisationEnabled));
+  if (mIsDoseToWaterImageEnabled)
+    snapshots.push_back(Snapshot(mDoseToWaterImage.CreateSnapshot(), mIsDoseToWaterNormalisationEnabled));
+  if (mIsDoseToOtherMaterialImageEnabled)
+    snapshots.push_back(Snapshot(mDoseToOtherMaterialImage.CreateSnapshot(),
+                                 mIsDoseToOtherMaterialNormalisationEnabled));
+  std::shared_ptr<GateImageInt> hits;
+  std::shared_ptr<GateImageCopyOnWrite> hitsCopy;
+  G4String hitsFilename = mNbOfHitsFilename;
+  if (mIsNumberOfHitsImageEnabled) {
+    GateImageCopyOnWrite::BeforeWriteAll(mNumberOfHitsCopyOnWrite);
+    hits = std::make_shared<GateImageInt>();
+    hitsCopy = std::make_shared<GateImageCopyOnWrite>(mNumberOfHitsImage.GetNumberOfValues());
+    hitsCopy->AddImage(mNumberOfHitsImage, *hits);
+    mNumberOfHitsCopyOnWrite = hitsCopy;
+    if (!mOverWriteFilesFlag) hitsFilename = GetSaveCurrentFilename(mNbOfHitsFilename);
+  }
+  int numberOfEvents = mCurrentEvent+1;
+
+  StartAsyncSave([snapshots, hits, hitsCopy, hitsFilename, numberOfEvents]() {
+      for(auto & s:snapshots) s.first->SaveSnapshot(numberOfEvents, s.second);
+      if (hits) {
+        hitsCopy->CopyImages();
+        hits->Write(hitsFilename);
+      }
+    });
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateDoseActor::ResetData() {
   if (mIsLastHitEventImageEnabled) mLastHitEventImage.Fill(-1);
@@ -485,7 +570,10 @@ void GateDoseActor::ResetData() {
   if (mIsDoseImageEnabled) mDoseImage.Reset();
   if (mIsDoseToWaterImageEnabled) mDoseToWaterImage.Reset();
   if (mIsDoseToOtherMaterialImageEnabled) mDoseToOtherMaterialImage.Reset();
-  if (mIsNumberOfHitsImageEnabled) mNumberOfHitsImage.Fill(0);
+  if (mIsNumberOfHitsImageEnabled) {
+    GateImageCopyOnWrite::BeforeWriteAll(mNumberOfHitsCopyOnWrite);
+    mNumberOfHitsImage.Fill(0);
+  }
 }
 //-----------------------------------------------------------------------------
 
@@ -495,15 +583,58 @@ void GateDoseActor::BeginOfRunAction(const G4Run * r) {
   GateVActor::BeginOfRunAction(r);
   GateDebugMessage("Actor", 3, "GateDoseActor -- Begin of Run\n");
   mDose2WaterWarningFlag = true;
+  // Stopping power ratio tables are rebuilt on demand (materials and cuts may change between runs)
+  mDoseToWaterRatioTable.Clear();
+  mDoseToWaterValidationStepCount = 0;
+  mDoseToWaterValidationCount = 0;
+  mDoseToWaterValidationMaxRelDiff = 0;
+  mDoseToWaterValidationSumRelDiff = 0;
   // ResetData(); // Do no reset here !! (when multiple run);
 }
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateDoseActor::EndOfRunAction(const G4Run * r) {
+  GateVActor::EndOfRunAction(r);
+  if (mDoseToWaterValidationCount > 0) {
+    GateMessage("Actor", 0, "DoseActor '" << GetObjectName() << "': dose to water ratio table validated on "
+                << mDoseToWaterValidationCount << " steps, relative difference to the exact ratio: mean "
+                << mDoseToWaterValidationSumRelDiff/mDoseToWaterValidationCount
+                << ", max " << mDoseToWaterValidationMaxRelDiff << Gateendl);
+    if (mDoseToWaterValidationTolerance > 0 && mDoseToWaterValidationMaxRelDiff > mDoseToWaterValidationTolerance)
+      GateError("DoseActor '" << GetObjectName() << "': the max relative difference of the dose to water ratio table ("
+                << mDoseToWaterValidationMaxRelDiff << ") exceeds the tolerance (" << mDoseToWaterValidationTolerance << ")");
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateDoseActor::ValidateDoseToWaterRatio(G4double energy, const G4ParticleDefinition* p,
+                                             const G4Material* m, G4double ratio) {
+  G4double exactRatio = mDoseToWaterRatioTable.ComputeValue(energy, p, m);
+  G4double relDiff = (exactRatio != 0 ? std::fabs(ratio-exactRatio)/exactRatio : std::fabs(ratio));
+  mDoseToWaterValidationCount++;
+  mDoseToWaterValidationSumRelDiff += relDiff;
+  if (relDiff > mDoseToWaterValidationMaxRelDiff) mDoseToWaterValidationMaxRelDiff = relDiff;
+  GateMessage("Actor", 2, "Particle : " << p->GetParticleName() << "\t energy : " << energy
+              << "\t material : " << m->GetName() << "\t dedx ratio (table) : " << ratio
+              << "\t dedx ratio (exact) : " << exactRatio << "\t relative difference : " << relDiff << Gateendl);
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 // Callback at each event
 void GateDoseActor::BeginOfEventAction(const G4Event * e) {
   GateVActor::BeginOfEventAction(e);
+  if (mIsLeanStatisticsEnabled) {
+    if (mIsEdepImageEnabled) mEdepImage.EndOfEvent();
+    if (mIsDoseImageEnabled) mDoseImage.EndOfEvent();
+    if (mIsDoseToWaterImageEnabled) mDoseToWaterImage.EndOfEvent();
+    if (mIsDoseToOtherMaterialImageEnabled) mDoseToOtherMaterialImage.EndOfEvent();
+  }
   mCurrentEvent++;
   GateDebugMessage("Actor", 3, "GateDoseActor -- Begin of Event: "<< mCurrentEvent << Gateendl);
 }
@@ -680,28 +811,19 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
   double doseToWater = 0;
   if (mIsDoseToWaterImageEnabled)
     {
-      double cut =  DBL_MAX;
-      // dedx
-      double DEDX=0, DEDX_Water=0;
-      //other material
-      static G4Material * water = G4NistManager::Instance()->FindOrBuildMaterial("G4_WATER");
-
-
       //Accounting for particles with dedx=0; i.e. gamma and neutrons
       //For gamma we consider the dedx of electrons instead - testing with 1.3 MeV photon beam or 150 MeV protons or 1500 MeV carbon ion beam showed that the error induced is 0
       //		when comparing dose and dosetowater in the material G4_WATER
       //For neutrons the dose is neglected - testing with 1.3 MeV photon beam or 150 MeV protons or 1500 MeV carbon ion beam showed that the error induced is < 0.01%
       //		when comparing dose and dosetowater in the material G4_WATER (we are systematically missing a little bit of dose of course with this solution)
       if (p == G4Gamma::Gamma())  p = G4Electron::Electron();
-      DEDX = emcalc->ComputeTotalDEDX(energy, p, current_material, cut);
-      DEDX_Water = emcalc->ComputeTotalDEDX(energy, p, water, cut);
-      //In current implementation, dose deposited directly by neutrons is neglected - the below lines prevent "inf or NaN"
-      if (DEDX==0 || DEDX_Water==0){
-      	doseToWater=0;
-      }
-      else{
-        doseToWater = dose*(DEDX_Water/1.0)/(DEDX/(density*e_SI));
-      }
+      //The water/material dedx ratio is interpolated in tables built once per (particle, material)
+      //In current implementation, dose deposited directly by neutrons is neglected (ratio is 0) - this prevents "inf or NaN"
+      double ratio = mDoseToWaterRatioTable.GetValue(energy, p, current_material);
+      doseToWater = dose*ratio*(density*e_SI);
+
+      if (mDoseToWaterValidationPeriod > 0 && ++mDoseToWaterValidationStepCount % mDoseToWaterValidationPeriod == 0)
+        ValidateDoseToWaterRatio(energy, p, current_material, ratio);
 
 //G4cout<<"Dose To Water " << doseToWater << G4endl;
 
@@ -868,7 +990,10 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
       else mDoseToOtherMaterialImage.AddValue(index, DoseToOtherMaterial);
     }
 
-  if (mIsNumberOfHitsImageEnabled) mNumberOfHitsImage.AddValue(index, weight);
+  if (mIsNumberOfHitsImageEnabled) {
+    GateImageCopyOnWrite::BeforeWrite(mNumberOfHitsCopyOnWrite, index);
+    mNumberOfHitsImage.AddValue(index, weight);
+  }
 
   //Dose regions
   if (mDoseByRegionsFlag) {
@@ -36,6 +36,9 @@ GateDoseActorMessenger::GateDoseActorMessenger(GateDoseActor* sensor)
   pEnableDoseToWaterNormToIntegralCmd= 0;
   pEnableDoseToWaterSquaredCmd= 0;
   pEnableDoseToWaterUncertaintyCmd= 0;
+  pSetDoseToWaterTableBinsCmd= 0;
+  pSetDoseToWaterTableValidationCmd= 0;
+  pSetDoseToWaterTableToleranceCmd= 0;
   //DoseToOtherMaterial
   pEnableDoseToOtherMaterialCmd = 0;
   pEnableDoseToOtherMaterialNormToMaxCmd= 0;
@@ -50,6 +53,8 @@ GateDoseActorMessenger::GateDoseActorMessenger(GateDoseActor* sensor)
   pVolumeFilterCmd= 0;
   pMaterialFilterCmd= 0;
   pTestFlagCmd= 0;
+  pEnableLeanStatisticsCmd= 0;
+  pEnableFloatAccumulatorsCmd= 0;
   //Dose in regions
   pDoseRegionInputCmd = 0;
   pDoseRegionOutputCmd = 0;
@@ -81,6 +86,9 @@ GateDoseActorMessenger::~GateDoseActorMessenger()
   if(pEnableDoseToWaterNormToIntegralCmd) delete pEnableDoseToWaterNormToIntegralCmd;
   if(pEnableDoseToWaterSquaredCmd) delete pEnableDoseToWaterSquaredCmd;
   if(pEnableDoseToWaterUncertaintyCmd) delete pEnableDoseToWaterUncertaintyCmd;
+  if(pSetDoseToWaterTableBinsCmd) delete pSetDoseToWaterTableBinsCmd;
+  if(pSetDoseToWaterTableValidationCmd) delete pSetDoseToWaterTableValidationCmd;
+  if(pSetDoseToWaterTableToleranceCmd) delete pSetDoseToWaterTableToleranceCmd;
   //DoseToOtherMaterial
   if(pEnableDoseToOtherMaterialCmd) delete pEnableDoseToOtherMaterialCmd;
   if(pEnableDoseToOtherMaterialNormToMaxCmd) delete pEnableDoseToOtherMaterialNormToMaxCmd;
@@ -96,6 +104,8 @@ GateDoseActorMessenger::~GateDoseActorMessenger()
 
   if(pVolumeFilterCmd) delete pVolumeFilterCmd;
   if(pMaterialFilterCmd) delete pMaterialFilterCmd;
+  if(pEnableLeanStatisticsCmd) delete pEnableLeanStatisticsCmd;
+  if(pEnableFloatAccumulatorsCmd) delete pEnableFloatAccumulatorsCmd;
 
   if(pDoseRegionOutputCmd) delete pDoseRegionOutputCmd;
   if(pDoseRegionInputCmd) delete pDoseRegionInputCmd;
@@ -180,6 +190,25 @@ void GateDoseActorMessenger::BuildCommands(G4String base)
   guid = G4String("Enable uncertainty dose to water computation");
   pEnableDoseToWaterUncertaintyCmd->SetGuidance(guid);
 
+  n = base+"/setDoseToWaterTableBinsPerDecade";
+  pSetDoseToWaterTableBinsCmd = new G4UIcmdWithAnInteger(n, this);
+  guid = G4String("Set the number of bins per energy decade of the tabulated water/material stopping power ratio (default 50, 0 = exact computation at each step)");
+  pSetDoseToWaterTableBinsCmd->SetGuidance(guid);
+  pSetDoseToWaterTableBinsCmd->SetParameterName("N", false);
+  pSetDoseToWaterTableBinsCmd->SetRange("N>=0");
+  n = base+"/setDoseToWaterTableValidation";
+  pSetDoseToWaterTableValidationCmd = new G4UIcmdWithAnInteger(n, this);
+  guid = G4String("Compare the tabulated water/material stopping power ratio to the exact one every N steps, the differences are reported at the end of the run (default 0 = no comparison)");
+  pSetDoseToWaterTableValidationCmd->SetGuidance(guid);
+  pSetDoseToWaterTableValidationCmd->SetParameterName("N", false);
+  pSetDoseToWaterTableValidationCmd->SetRange("N>=0");
+  n = base+"/setDoseToWaterTableTolerance";
+  pSetDoseToWaterTableToleranceCmd = new G4UIcmdWithADouble(n, this);
+  guid = G4String("Stop with an error at the end of the run if the max relative difference found by setDoseToWaterTableValidation exceeds this value (default 0 = no check)");
+  pSetDoseToWaterTableToleranceCmd->SetGuidance(guid);
+  pSetDoseToWaterTableToleranceCmd->SetParameterName("Tolerance", false);
+  pSetDoseToWaterTableToleranceCmd->SetRange("Tolerance>=0");
+
   //DoseToOtherMaterial
   n = base+"/enableDoseToOtherMaterial";
   pEnableDoseToOtherMaterialCmd = new G4UIcmdWithABool(n, this);
@@ -248,6 +277,16 @@ void GateDoseActorMessenger::BuildCommands(G4String base)
   guid = G4String("Set Test Flag for debug/validation purposes");
   pTestFlagCmd->SetGuidance(guid);
 
+  n = base+"/enableLeanStatistics";
+  pEnableLeanStatisticsCmd = new G4UIcmdWithABool(n, this);
+  guid = G4String("Reduce the memory used by squared/uncertainty images: no per-event temporary images, scaled and uncertainty images computed when saving");
+  pEnableLeanStatisticsCmd->SetGuidance(guid);
+
+  n = base+"/enableFloatAccumulators";
+  pEnableFloatAccumulatorsCmd = new G4UIcmdWithABool(n, this);
+  guid = G4String("With lean statistics, accumulate values and squared values in single precision");
+  pEnableFloatAccumulatorsCmd->SetGuidance(guid);
+
   n = base+"/inputDoseByRegions";
   pDoseRegionInputCmd = new G4UIcmdWithAString(n, this);
   guid = G4String("Image filename to read the region labels.");
@@ -293,6 +332,9 @@ void GateDoseActorMessenger::SetNewValue(G4UIcommand* cmd, G4String newValue)
   if (cmd == pEnableDoseToWaterUncertaintyCmd) pDoseActor->EnableDoseToWaterUncertaintyImage(pEnableDoseToWaterUncertaintyCmd->GetNewBoolValue(newValue));
   if (cmd == pEnableDoseToWaterNormToMaxCmd) pDoseActor->EnableDoseToWaterNormalisationToMax(pEnableDoseToWaterNormToMaxCmd->GetNewBoolValue(newValue));
   if (cmd == pEnableDoseToWaterNormToIntegralCmd) pDoseActor->EnableDoseToWaterNormalisationToIntegral(pEnableDoseToWaterNormToIntegralCmd->GetNewBoolValue(newValue));
+  if (cmd == pSetDoseToWaterTableBinsCmd) pDoseActor->SetDoseToWaterTableBinsPerDecade(pSetDoseToWaterTableBinsCmd->GetNewIntValue(newValue));
+  if (cmd == pSetDoseToWaterTableValidationCmd) pDoseActor->SetDoseToWaterTableValidation(pSetDoseToWaterTableValidationCmd->GetNewIntValue(newValue));
+  if (cmd == pSetDoseToWaterTableToleranceCmd) pDoseActor->SetDoseToWaterTableTolerance(pSetDoseToWaterTableToleranceCmd->GetNewDoubleValue(newValue));
   //DoseToOtherMaterial
   if (cmd == pEnableDoseToOtherMaterialCmd) pDoseActor->EnableDoseToOtherMaterialImage(pEnableDoseToOtherMaterialCmd->GetNewBoolValue(newValue));
   if (cmd == pEnableDoseToOtherMaterialSquaredCmd) pDoseActor->EnableDoseToOtherMaterialSquaredImage(pEnableDoseToOtherMaterialSquaredCmd->GetNewBoolValue(newValue));
@@ -308,6 +350,8 @@ void GateDoseActorMessenger::SetNewValue(G4UIcommand* cmd, G4String newValue)
   if (cmd == pVolumeFilterCmd) pDoseActor->VolumeFilter(newValue);
   if (cmd == pMaterialFilterCmd) pDoseActor->MaterialFilter(newValue);
   if (cmd ==pTestFlagCmd) pDoseActor->setTestFlag(pTestFlagCmd->GetNewBoolValue(newValue));
+  if (cmd == pEnableLeanStatisticsCmd) pDoseActor->EnableLeanStatistics(pEnableLeanStatisticsCmd->GetNewBoolValue(newValue));
+  if (cmd == pEnableFloatAccumulatorsCmd) pDoseActor->EnableFloatAccumulators(pEnableFloatAccumulatorsCmd->GetNewBoolValue(newValue));
   //Regions
   if (cmd == pDoseRegionInputCmd) pDoseActor->SetDoseByRegionsInputFilename(newValue);
   if (cmd == pDoseRegionOutputCmd) pDoseActor->SetDoseByRegionsOutputFilename(newValue);
@@ -56,7 +56,9 @@ GateFixedForcedDetectionActor::GateFixedForcedDetectionActor(G4String name, G4in
     mNumberOfProcessedSecondaries(0),
     mNumberOfProcessedCompton(0),
     mNumberOfProcessedRayleigh(0),
-    mNumberOfProcessedPE(0)
+    mNumberOfProcessedPE(0),
+    mInteractionBatchSize(1),
+    mUseInteractionBatches(false)
 {
   GateDebugMessageInc("Actor",4,"GateFixedForcedDetectionActor() -- begin"<<G4endl);
   pActorMessenger = new GateFixedForcedDetectionActorMessenger(this);
@@ -331,6 +333,16 @@ void GateFixedForcedDetectionActor::BeginOfRunAction(const G4Run*r)
     for (unsigned int i = 0; i < PRIMARY; i++)
       mEventImage[ProcessType(i)] = CreateVoidProjectionImage();
     }
+
+  /* Batched projection needs the projections of the batch only summed in the
+   process images: not possible when each interaction has its own output */
+  mUseInteractionBatches = (mInteractionBatchSize > 1);
+  if (mUseInteractionBatches && (mARF || mGeneratePhotons || mPhaseSpaceFile))
+    {
+    GateWarning("Batched projection of interactions is not available with ARF, photon generation or phase space output, it is disabled." << G4endl);
+    mUseInteractionBatches = false;
+    }
+  mInteractionQueue.clear();
 }
 
 void GateFixedForcedDetectionActor::ComputeFlatField(std::vector<double> & energyList,
@@ -654,6 +666,9 @@ void GateFixedForcedDetectionActor::EndOfEventAction(const G4Event *e)
 {
   if (mIsSecondarySquaredImageEnabled || mIsSecondaryUncertaintyImageEnabled)
     {
+    /* The contribution of the event must be complete */
+    ProjectInteractionBatches();
+
     typedef itk::AddImageFilter<OutputImageType, OutputImageType, OutputImageType> AddImageFilterType;
     AddImageFilterType::Pointer addFilter = AddImageFilterType::New();
     typedef itk::MultiplyImageFilter<OutputImageType, OutputImageType, OutputImageType> MultiplyImageFilterType;
@@ -1008,6 +1023,24 @@ void GateFixedForcedDetectionActor::ForceDetectionOfInteraction(TProjectorType *
     direction[i] = interactionDirectionInCT[i];
     }
 
+  /* Queue the interaction, projected with the others of the batch */
+  if (mUseInteractionBatches)
+    {
+    QueuedInteraction interaction;
+    interaction.position = mInteractionITKPosition;
+    interaction.direction = direction;
+    interaction.energy = mInteractionEnergy;
+    interaction.weight = mInteractionWeight;
+    interaction.Z = mInteractionZ;
+    interaction.order = mInteractionOrder;
+    mInteractionQueue[VProcess].push_back(interaction);
+    if (mInteractionQueue[VProcess].size() >= mInteractionBatchSize)
+      {
+      ProjectInteractionBatch<VProcess>(projector, input);
+      }
+    return;
+    }
+
   /* Create interaction geometry */
   GeometryType::Pointer oneProjGeometry = GeometryType::New();
   oneProjGeometry->AddProjection(mInteractionITKPosition,
@@ -1050,6 +1083,113 @@ void GateFixedForcedDetectionActor::ForceDetectionOfInteraction(TProjectorType *
     }
 }
 
+template<ProcessType VProcess, class TProjectorType>
+void GateFixedForcedDetectionActor::ProjectInteractionBatch(TProjectorType *projector,
+                                                            InputImageType::Pointer & input)
+{
+  std::vector<QueuedInteraction> & queue = mInteractionQueue[VProcess];
+  if (queue.empty())
+    {
+    return;
+    }
+  const unsigned int nInteractions = queue.size();
+  const InputImageType::RegionType inputRegion = input->GetLargestPossibleRegion();
+  const unsigned int nPixOneSlice = inputRegion.GetSize(0) * inputRegion.GetSize(1);
+  const unsigned int nEnergySlices = inputRegion.GetSize(2);
+
+  /* One projection per interaction. The projections are the slices of a buffer
+   ordered by energy slice, then interaction, so that the energy resolved
+   accumulation finds energy slice e of interaction i at the offset
+   e * nInteractions * nPixOneSlice. */
+  mBatchBuffer.assign((size_t) nEnergySlices * nInteractions * nPixOneSlice, 0.);
+  GeometryType::Pointer batchGeometry = GeometryType::New();
+  projector->GetProjectedValueAccumulation().ClearInteractions();
+  for (unsigned int i = 0; i < nInteractions; i++)
+    {
+    batchGeometry->AddProjection(queue[i].position,
+                                 mDetectorPosition,
+                                 mDetectorRowVector,
+                                 mDetectorColVector);
+    projector->GetProjectedValueAccumulation().AddInteraction(queue[i].energy,
+                                                              queue[i].Z,
+                                                              queue[i].weight,
+                                                              queue[i].direction);
+    }
+  InputImageType::RegionType region = inputRegion;
+  region.SetSize(2, nInteractions);
+  rtk::ImportImageFilter<InputImageType>::Pointer batchFilter = rtk::ImportImageFilter<
+      InputImageType>::New();
+  batchFilter->SetRegion(region);
+  batchFilter->SetImportPointer(&(mBatchBuffer[0]), region.GetNumberOfPixels(), false);
+  batchFilter->SetSpacing(input->GetSpacing());
+  batchFilter->SetOrigin(input->GetOrigin());
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(batchFilter->Update());
+
+  /* The interactions are split between the threads like the projections of a
+   stack */
+  mProcessTimeProbe[VProcess].Start();
+  projector->SetInput(batchFilter->GetOutput());
+  projector->SetGeometry(batchGeometry.GetPointer());
+  projector->GetProjectedValueAccumulation().SetBatchBuffer(&(mBatchBuffer[0]), nPixOneSlice);
+  projector->GetProjectedValueAccumulation().SetEnergyResolvedParameters(mEnergyResolvedBinSize,
+                                                                         nInteractions * nPixOneSlice);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION(projector->Update());
+  projector->GetProjectedValueAccumulation().SetBatchBuffer(ITK_NULLPTR, 1);
+  projector->GetProjectedValueAccumulation().SetEnergyResolvedParameters(mEnergyResolvedBinSize,
+                                                                         nPixOneSlice);
+  projector->GetProjectedValueAccumulation().GetIntegralOverDetectorAndReset();
+
+  /* Sum the projections in the process image and in the scatter order images */
+  InputPixelType * processBuffer = input->GetBufferPointer();
+  for (unsigned int i = 0; i < nInteractions; i++)
+    {
+    InputPixelType * orderBuffer = ITK_NULLPTR;
+    if (mPerOrderImagesBaseName != "")
+      {
+      while (queue[i].order > (int) mPerOrderImages[VProcess].size())
+        {
+        mPerOrderImages[VProcess].push_back(CreateVoidProjectionImage());
+        }
+      orderBuffer = mPerOrderImages[VProcess][queue[i].order - 1]->GetBufferPointer();
+      }
+    for (unsigned int e = 0; e < nEnergySlices; e++)
+      {
+      const InputPixelType * projection = &(mBatchBuffer[((size_t) e * nInteractions + i) * nPixOneSlice]);
+      InputPixelType * out = processBuffer + (size_t) e * nPixOneSlice;
+      for (unsigned int k = 0; k < nPixOneSlice; k++)
+        {
+        out[k] += projection[k];
+        }
+      if (orderBuffer)
+        {
+        out = orderBuffer + (size_t) e * nPixOneSlice;
+        for (unsigned int k = 0; k < nPixOneSlice; k++)
+          {
+          out[k] += projection[k];
+          }
+        }
+      }
+    }
+  mProcessTimeProbe[VProcess].Stop();
+  /* Update time stamp, used to detect the images modified during an event */
+  input->Modified();
+  queue.clear();
+}
+
+void GateFixedForcedDetectionActor::ProjectInteractionBatches()
+{
+  if (!mUseInteractionBatches)
+    {
+    return;
+    }
+  ProjectInteractionBatch<COMPTON>(mComptonProjector.GetPointer(), mProcessImage[COMPTON]);
+  ProjectInteractionBatch<RAYLEIGH>(mRayleighProjector.GetPointer(), mProcessImage[RAYLEIGH]);
+  ProjectInteractionBatch<PHOTOELECTRIC>(mFluorescenceProjector.GetPointer(),
+                                         mProcessImage[PHOTOELECTRIC]);
+  ProjectInteractionBatch<ISOTROPICPRIMARY>(mIsotropicPrimaryProjector.GetPointer(),
+                                            mProcessImage[ISOTROPICPRIMARY]);
+}
+
 void GateFixedForcedDetectionActor::SaveData()
 {
   SaveData("");
@@ -1060,6 +1200,8 @@ void GateFixedForcedDetectionActor::SaveData(const G4String prefix)
   typedef itk::BinaryFunctorImageFilter<InputImageType, InputImageType, InputImageType,
       GateFixedForcedDetectionFunctor::Chetty<InputImageType::PixelType> > ChettyType;
 
+  ProjectInteractionBatches();
+
   GateVActor::SaveData();
 
   std::cout << "  Number of primaries " << mNumberOfProcessedPrimaries << std::endl;
@@ -169,6 +169,13 @@ void GateFixedForcedDetectionActorMessenger::BuildCommands(G4String base)
   guidance = "Set energy bin size for having an energy resolved output. Default is 0, i.e., off.";
   pEnergyResolvedBinSizeCmd->SetGuidance(guidance);
 
+  bb = base + "/interactionBatchSize";
+  pSetInteractionBatchSizeCmd = new G4UIcmdWithAnInteger(bb, this);
+  guidance = "Set the number of interactions projected together. Default is 1, i.e., each interaction is projected when it occurs.";
+  pSetInteractionBatchSizeCmd->SetGuidance(guidance);
+  pSetInteractionBatchSizeCmd->SetParameterName("N", false);
+  pSetInteractionBatchSizeCmd->SetRange("N>=1");
+
   }
 
 void GateFixedForcedDetectionActorMessenger::SetNewValue(G4UIcommand* command, G4String param)
@@ -280,6 +287,10 @@ void GateFixedForcedDetectionActorMessenger::SetNewValue(G4UIcommand* command, G
     {
     pActor->SetEnergyResolvedBinSize(pEnergyResolvedBinSizeCmd->GetNewDoubleValue(param));
     }
+  if (command == pSetInteractionBatchSizeCmd)
+    {
+    pActor->SetInteractionBatchSize(pSetInteractionBatchSizeCmd->GetNewIntValue(param));
+    }
 
   GateActorMessenger::SetNewValue(command, param);
   }
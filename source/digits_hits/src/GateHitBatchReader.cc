@@ -0,0 +1,122 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+#include "GateHitBatchReader.hh"
+
+#ifdef G4ANALYSIS_USE_ROOT
+
+#include "GateCrystalHit.hh"
+#include "GateHitConvertor.hh"
+#include "GateMessageManager.hh"
+
+//-----------------------------------------------------------------
+GateHitBatchReader::GateHitBatchReader(const G4String& fileName,size_t batchSize,Long64_t cacheSize)
+  : m_hitFile(0)
+  , m_hitTree(0)
+  , m_entries(0)
+  , m_currentEntry(0)
+  , m_batchSize(batchSize)
+  , m_nbOfHits(0)
+{
+  m_hitBuffer.Clear();
+
+  m_hitFile = TFile::Open(fileName.c_str(),"READ");
+  if (!m_hitFile || !m_hitFile->IsOpen()) {
+    GateError("Could not open the hit file '" << fileName << "'");
+  }
+  m_hitTree = (TTree*)( m_hitFile->Get(GateHitConvertor::GetOutputAlias()) );
+  if (!m_hitTree) {
+    GateError("Could not find a tree of hits in the ROOT file '" << fileName << "'");
+  }
+  m_entries = m_hitTree->GetEntries();
+  GateHitTree::SetBranchAddresses(m_hitTree,m_hitBuffer);
+
+  // All the branches are read: let the cache fetch the baskets of the coming
+  // entries in large sequential reads
+  m_hitTree->SetCacheSize(cacheSize);
+  m_hitTree->AddBranchToCache("*",kTRUE);
+  m_hitTree->StopCacheLearningPhase();
+
+  // Load the first hit into the root-hit structure
+  LoadHitData();
+}
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+GateHitBatchReader::~GateHitBatchReader()
+{
+  for (size_t i=0; i<m_hits.size(); i++) delete m_hits[i];
+  // the tree belongs to the file
+  delete m_hitFile;
+}
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+// The batch ends on an event boundary once batchSize hits are read
+bool GateHitBatchReader::ReadBatch()
+{
+  m_nbOfHits = 0;
+  m_eventStart.clear();
+
+  // end-of-file
+  if ( (m_hitBuffer.eventID==-1) && (m_hitBuffer.runID==-1) )
+    return false;
+
+  while ( m_nbOfHits<m_batchSize && !((m_hitBuffer.eventID==-1) && (m_hitBuffer.runID==-1)) ) {
+    G4int currentEventID = m_hitBuffer.eventID;
+    G4int currentRunID = m_hitBuffer.runID;
+    m_eventStart.push_back(m_nbOfHits);
+    while ( (currentEventID == m_hitBuffer.eventID) && (currentRunID == m_hitBuffer.runID) ) {
+      if (m_hitBuffer.edep!=0) m_hitBuffer.FillHit(NextHit());
+      LoadHitData();
+    }
+  }
+  m_eventStart.push_back(m_nbOfHits);
+  return true;
+}
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+const std::vector<GateCrystalHit*>& GateHitBatchReader::GetEvent(size_t i)
+{
+  m_event.assign(m_hits.begin()+m_eventStart[i],m_hits.begin()+m_eventStart[i+1]);
+  return m_event;
+}
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+GateCrystalHit* GateHitBatchReader::NextHit()
+{
+  if (m_nbOfHits==m_hits.size()) m_hits.push_back(new GateCrystalHit());
+  return m_hits[m_nbOfHits++];
+}
+//-----------------------------------------------------------------
+
+
+//-----------------------------------------------------------------
+// Same end-of-file convention as GateHitFileReader::LoadHitData()
+void GateHitBatchReader::LoadHitData()
+{
+  if (m_currentEntry>=m_entries) {
+    m_hitBuffer.runID=-1;
+    m_hitBuffer.eventID=-1;
+    return;
+  }
+  if (m_hitTree->GetEntry(m_currentEntry++)<=0) {
+    GateWarning("Could not read the hit entry " << m_currentEntry-1 << Gateendl);
+    m_hitBuffer.runID=-1;
+    m_hitBuffer.eventID=-1;
+  }
+}
+//-----------------------------------------------------------------
+
+#endif
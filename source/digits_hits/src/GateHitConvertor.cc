@@ -89,7 +89,7 @@ GatePulseList* GateHitConvertor::ProcessHits(const GateCrystalHitsCollection* hi
 }
 
 
- GatePulseList* GateHitConvertor::ProcessHits(std::vector<GateCrystalHit*> vhitCollection){
+ GatePulseList* GateHitConvertor::ProcessHits(const std::vector<GateCrystalHit*>& vhitCollection){
 
     size_t n_hit = vhitCollection.size();
     if (nVerboseLevel==1)
@@ -151,8 +151,8 @@ void GateHitConvertor::ProcessOneHit(const GateCrystalHit* hit,GatePulseList* pu
   pulse->SetNCrystalCompton( hit->GetNCrystalCompton() );
   pulse->SetNPhantomRayleigh( hit->GetNPhantomRayleigh() );
   pulse->SetNCrystalRayleigh( hit->GetNCrystalRayleigh() );
-  pulse->SetComptonVolumeName( hit->GetComptonVolumeName() );
-  pulse->SetRayleighVolumeName( hit->GetRayleighVolumeName() );
+  pulse->SetComptonVolumeNameID( hit->GetComptonVolumeNameID() );
+  pulse->SetRayleighVolumeNameID( hit->GetRayleighVolumeNameID() );
   pulse->SetVolumeID( hit->GetVolumeID() );
   pulse->SetScannerPos( hit->GetScannerPos() );
   pulse->SetScannerRotAngle( hit->GetScannerRotAngle() );
@@ -162,10 +162,10 @@ void GateHitConvertor::ProcessOneHit(const GateCrystalHit* hit,GatePulseList* pu
   pulse->SetNSeptal( hit->GetNSeptal() );  // HDS : septal penetration
 
   // AE : Added for IdealComptonPhot adder which take into account several Comptons in the same volume
-  pulse->SetPostStepProcess(hit->GetPostStepProcess());
+  pulse->SetPostStepProcessID(hit->GetPostStepProcessID());
   pulse->SetEnergyIniTrack(hit->GetEnergyIniTrack());
   pulse->SetEnergyFin(hit->GetEnergyFin());
-  pulse->SetProcessCreator(hit->GetProcess());
+  pulse->SetProcessCreatorID(hit->GetProcessID());
   pulse->SetTrackID(hit->GetTrackID());
   pulse->SetParentID(hit->GetParentID());
   pulse->SetSourceEnergy(hit->GetSourceEnergy());
@@ -178,12 +178,12 @@ void GateHitConvertor::ProcessOneHit(const GateCrystalHit* hit,GatePulseList* pu
      
 
 
-  if (hit->GetComptonVolumeName().empty()) {
+  if (hit->GetComptonVolumeNameID()==0) {
     pulse->SetComptonVolumeName( "NULL" );
     pulse->SetSourceID( -1 );
   }
 
-  if (hit->GetRayleighVolumeName().empty()) {
+  if (hit->GetRayleighVolumeNameID()==0) {
     pulse->SetRayleighVolumeName( "NULL" );
     pulse->SetSourceID( -1 );
   }
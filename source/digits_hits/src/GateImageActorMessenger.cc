@@ -80,7 +80,7 @@ void GateImageActorMessenger::BuildCommands(G4String base)
 
   bb = base +"/stepHitType";
   pStepHitTypeCmd = new G4UIcmdWithAString(bb,this);
-  guidance = G4String("Sets  hit type ('pre', 'post', 'random' or 'middle'). Default is 'middle'.");
+  guidance = G4String("Sets  hit type ('pre', 'post', 'random', 'middle' or 'traversal'). Default is 'middle'. 'traversal' splits the step among all the crossed voxels (only for some actors).");
   pStepHitTypeCmd->SetGuidance(guidance);
 
 }
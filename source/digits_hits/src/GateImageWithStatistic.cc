@@ -14,6 +14,7 @@
 #include "GateImageWithStatistic.hh"
 #include "GateMessageManager.hh"
 #include "GateMiscFunctions.hh"
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 /// Constructor
@@ -24,6 +25,8 @@ GateImageWithStatistic::GateImageWithStatistic()  {
   mOverWriteFilesFlag = true;
   mNormalizedToMax = false;
   mNormalizedToIntegral = false;
+  mIsLeanModeEnabled = false;
+  mIsFloatAccumulatorEnabled = false;
 }
 //-----------------------------------------------------------------------------
 
@@ -31,6 +34,7 @@ GateImageWithStatistic::GateImageWithStatistic()  {
 //-----------------------------------------------------------------------------
 /// Destructor
 GateImageWithStatistic::~GateImageWithStatistic()  {
+  CopyAllBeforeWrite();
 }
 //-----------------------------------------------------------------------------
 
@@ -43,6 +47,8 @@ void GateImageWithStatistic::SetOrigin(G4ThreeVector o) {
   mUncertaintyImage.SetOrigin(o);
   mScaledValueImage.SetOrigin(o);
   mScaledSquaredImage.SetOrigin(o);
+  mFloatValueImage.SetOrigin(o);
+  mFloatSquaredImage.SetOrigin(o);
 }
 //-----------------------------------------------------------------------------
 
@@ -55,6 +61,8 @@ void GateImageWithStatistic::SetTransformMatrix(const G4RotationMatrix & m) {
   mUncertaintyImage.SetTransformMatrix(m);
   mScaledValueImage.SetTransformMatrix(m);
   mScaledSquaredImage.SetTransformMatrix(m);
+  mFloatValueImage.SetTransformMatrix(m);
+  mFloatSquaredImage.SetTransformMatrix(m);
 }
 //-----------------------------------------------------------------------------
 
@@ -88,6 +96,8 @@ void GateImageWithStatistic::SetResolutionAndHalfSize(const G4ThreeVector & reso
   }
 
   mScaledValueImage.SetResolutionAndHalfSize(resolution, halfSize, position);
+  mFloatValueImage.SetResolutionAndHalfSize(resolution, halfSize, position);
+  mFloatSquaredImage.SetResolutionAndHalfSize(resolution, halfSize, position);
 }
 //-----------------------------------------------------------------------------
 
@@ -121,12 +131,27 @@ void GateImageWithStatistic::SetResolutionAndHalfSizeCylinder(const G4ThreeVecto
   }
 
   mScaledValueImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
+  mFloatValueImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
+  mFloatSquaredImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
 }
 //-----------------------------------------------------------------------------
 
 
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::Allocate() {
+  CopyAllBeforeWrite();
+  if (mIsLeanModeEnabled) {
+    bool squared = mIsSquaredImageEnabled || mIsUncertaintyImageEnabled;
+    if (mIsFloatAccumulatorEnabled) {
+      mFloatValueImage.Allocate();
+      if (squared) mFloatSquaredImage.Allocate();
+    }
+    else {
+      mValueImage.Allocate();
+      if (squared) mSquaredImage.Allocate();
+    }
+    return;
+  }
   mValueImage.Allocate();
   if (mIsUncertaintyImageEnabled) {
     mUncertaintyImage.Allocate();
@@ -148,6 +173,20 @@ void GateImageWithStatistic::Allocate() {
 
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::Reset(double val) {
+  CopyAllBeforeWrite();
+  if (mIsLeanModeEnabled) {
+    mEventValues.clear();
+    bool squared = mIsSquaredImageEnabled || mIsUncertaintyImageEnabled;
+    if (mIsFloatAccumulatorEnabled) {
+      mFloatValueImage.Fill(val);
+      if (squared) mFloatSquaredImage.Fill(val*val);
+    }
+    else {
+      mValueImage.Fill(val);
+      if (squared) mSquaredImage.Fill(val*val);
+    }
+    return;
+  }
   mValueImage.Fill(val);
   if (mIsUncertaintyImageEnabled) {
     mUncertaintyImage.Fill(0.0);
@@ -169,13 +208,16 @@ void GateImageWithStatistic::Reset(double val) {
 
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::Fill(double value) {
-  mValueImage.Fill(value);
+  CopyAllBeforeWrite();
+  if (mIsLeanModeEnabled && mIsFloatAccumulatorEnabled) mFloatValueImage.Fill(value);
+  else mValueImage.Fill(value);
 }
 //-----------------------------------------------------------------------------
 
 
 //-----------------------------------------------------------------------------
 double GateImageWithStatistic::GetValue(const int index) {
+  if (mIsLeanModeEnabled && mIsFloatAccumulatorEnabled) return mFloatValueImage.GetValue(index);
   return mValueImage.GetValue(index);
 }
 //-----------------------------------------------------------------------------
@@ -183,7 +225,9 @@ double GateImageWithStatistic::GetValue(const int index) {
 
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::SetValue(const int index, double value) {
-  mValueImage.SetValue(index, value);
+  CopyBeforeWrite(index);
+  if (mIsLeanModeEnabled && mIsFloatAccumulatorEnabled) mFloatValueImage.SetValue(index, value);
+  else mValueImage.SetValue(index, value);
 }
 //-----------------------------------------------------------------------------
 
@@ -191,7 +235,9 @@ void GateImageWithStatistic::SetValue(const int index, double value) {
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::AddValue(const int index, double value) {
   GateDebugMessage("Actor", 2, "AddValue index=" << index << " value=" << value << Gateendl);
-  mValueImage.AddValue(index, value);
+  CopyBeforeWrite(index);
+  if (mIsLeanModeEnabled && mIsFloatAccumulatorEnabled) mFloatValueImage.AddValue(index, value);
+  else mValueImage.AddValue(index, value);
 }
 //-----------------------------------------------------------------------------
 
@@ -199,7 +245,11 @@ void GateImageWithStatistic::AddValue(const int index, double value) {
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::AddTempValue(const int index, double value) {
   GateDebugMessage("Actor", 2, "AddTempValue index=" << index << " value=" << value << Gateendl);
-  mTempImage.AddValue(index, value);
+  if (mIsLeanModeEnabled) mEventValues.push_back(std::make_pair(index, value));
+  else {
+    CopyBeforeWrite(index);
+    mTempImage.AddValue(index, value);
+  }
 }
 //-----------------------------------------------------------------------------
 
@@ -207,7 +257,14 @@ void GateImageWithStatistic::AddTempValue(const int index, double value) {
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::AddValueAndUpdate(const int index, double value) {
 
+  // In lean mode the event boundary is given by EndOfEvent
+  if (mIsLeanModeEnabled) {
+    mEventValues.push_back(std::make_pair(index, value));
+    return;
+  }
+
   GateDebugMessageInc("Actor", 2, "AddValue and update -- start: "<<mTempImage.GetSize() << Gateendl);
+  CopyBeforeWrite(index);
   double tmp = mTempImage.GetValue(index);
   mValueImage.AddValue(index, tmp);
   if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) mSquaredImage.AddValue(index, tmp*tmp);
@@ -217,6 +274,42 @@ void GateImageWithStatistic::AddValueAndUpdate(const int index, double value) {
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::EndOfEvent() {
+  if (!mIsLeanModeEnabled || mEventValues.empty()) return;
+
+  // Sum the contributions of the event per voxel before squaring them
+  std::sort(mEventValues.begin(), mEventValues.end());
+  bool squared = mIsSquaredImageEnabled || mIsUncertaintyImageEnabled;
+  size_t i = 0;
+  while (i < mEventValues.size()) {
+    int index = mEventValues[i].first;
+    double v = 0.0;
+    for(; i < mEventValues.size() && mEventValues[i].first == index; i++)
+      v += mEventValues[i].second;
+    CopyBeforeWrite(index);
+    if (mIsFloatAccumulatorEnabled) {
+      mFloatValueImage.AddValue(index, v);
+      if (squared) mFloatSquaredImage.AddValue(index, v*v);
+    }
+    else {
+      mValueImage.AddValue(index, v);
+      if (squared) mSquaredImage.AddValue(index, v*v);
+    }
+  }
+  mEventValues.clear();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+double GateImageWithStatistic::GetAccumulatedSquaredValue(const int index) const {
+  if (mIsFloatAccumulatorEnabled) return mFloatSquaredImage.GetValue(index);
+  return mSquaredImage.GetValue(index);
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::SetFilename(G4String f) {
   mFilename = f;
@@ -233,6 +326,9 @@ void GateImageWithStatistic::SetFilename(G4String f) {
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::SaveData(int numberOfEvents, bool normalise) {
 
+  // The accumulated images are updated below
+  CopyAllBeforeWrite();
+
   // Filename
   if (!mOverWriteFilesFlag) {
     mFilename = GetSaveCurrentFilename(mInitialFilename);
@@ -240,6 +336,11 @@ void GateImageWithStatistic::SaveData(int numberOfEvents, bool normalise) {
     mUncertaintyFilename = GetSaveCurrentFilename(mUncertaintyInitialFilename);
   }
 
+  if (mIsLeanModeEnabled) {
+    SaveLeanData(numberOfEvents, normalise);
+    return;
+  }
+
   double factor=1.0;
   if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) { UpdateImage(); }
   if (mIsSquaredImageEnabled) { UpdateSquaredImage(); }
@@ -308,6 +409,126 @@ void GateImageWithStatistic::SaveData(int numberOfEvents, bool normalise) {
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+std::shared_ptr<GateImageWithStatistic> GateImageWithStatistic::CreateSnapshot() {
+  // Only one snapshot at a time: the previous one is completed first
+  CopyAllBeforeWrite();
+
+  std::shared_ptr<GateImageWithStatistic> snapshot(new GateImageWithStatistic);
+  snapshot->mEventValues = mEventValues;
+  snapshot->mOverWriteFilesFlag = true;
+  snapshot->mNormalizedToMax = mNormalizedToMax;
+  snapshot->mNormalizedToIntegral = mNormalizedToIntegral;
+  snapshot->mIsSquaredImageEnabled = mIsSquaredImageEnabled;
+  snapshot->mIsUncertaintyImageEnabled = mIsUncertaintyImageEnabled;
+  snapshot->mIsValuesMustBeScaled = mIsValuesMustBeScaled;
+  snapshot->mIsLeanModeEnabled = mIsLeanModeEnabled;
+  snapshot->mIsFloatAccumulatorEnabled = mIsFloatAccumulatorEnabled;
+  snapshot->mScaleFactor = mScaleFactor;
+  snapshot->mFilename = mFilename;
+  snapshot->mSquaredFilename = mSquaredFilename;
+  snapshot->mUncertaintyFilename = mUncertaintyFilename;
+  if (!mOverWriteFilesFlag) {
+    snapshot->mFilename = GetSaveCurrentFilename(mInitialFilename);
+    snapshot->mSquaredFilename = GetSaveCurrentFilename(mSquaredInitialFilename);
+    snapshot->mUncertaintyFilename = GetSaveCurrentFilename(mUncertaintyInitialFilename);
+  }
+
+  // Geometry only, the data is allocated by SaveSnapshot
+  static_cast<GateVImage&>(snapshot->mValueImage) = mValueImage;
+  static_cast<GateVImage&>(snapshot->mSquaredImage) = mSquaredImage;
+  static_cast<GateVImage&>(snapshot->mTempImage) = mTempImage;
+  static_cast<GateVImage&>(snapshot->mUncertaintyImage) = mUncertaintyImage;
+  static_cast<GateVImage&>(snapshot->mScaledValueImage) = mScaledValueImage;
+  static_cast<GateVImage&>(snapshot->mScaledSquaredImage) = mScaledSquaredImage;
+  static_cast<GateVImage&>(snapshot->mFloatValueImage) = mFloatValueImage;
+  static_cast<GateVImage&>(snapshot->mFloatSquaredImage) = mFloatSquaredImage;
+
+  // The accumulators (the allocated ones) are copy-on-write
+  mCopyOnWrite.reset(new GateImageCopyOnWrite(GetValueImage().GetNumberOfValues()));
+  if (mValueImage.begin() != mValueImage.end())
+    mCopyOnWrite->AddImage(mValueImage, snapshot->mValueImage);
+  if (mSquaredImage.begin() != mSquaredImage.end())
+    mCopyOnWrite->AddImage(mSquaredImage, snapshot->mSquaredImage);
+  if (mTempImage.begin() != mTempImage.end())
+    mCopyOnWrite->AddImage(mTempImage, snapshot->mTempImage);
+  if (mFloatValueImage.begin() != mFloatValueImage.end())
+    mCopyOnWrite->AddImage(mFloatValueImage, snapshot->mFloatValueImage);
+  if (mFloatSquaredImage.begin() != mFloatSquaredImage.end())
+    mCopyOnWrite->AddImage(mFloatSquaredImage, snapshot->mFloatSquaredImage);
+  snapshot->mSnapshotSource = mCopyOnWrite;
+  return snapshot;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::SaveSnapshot(int numberOfEvents, bool normalise) {
+  Allocate();
+  mSnapshotSource->CopyImages();
+  mSnapshotSource.reset();
+  SaveData(numberOfEvents, normalise);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::SaveLeanData(int numberOfEvents, bool normalise) {
+
+  // Voxels touched by the last event
+  EndOfEvent();
+
+  bool isFloat = mIsFloatAccumulatorEnabled;
+  int n = GetValueImage().GetNumberOfValues();
+
+  double scale = 1.0;
+  if (mIsValuesMustBeScaled) scale = mScaleFactor;
+  if (normalise) {
+    double sum = 0.0;
+    double max = 0.0;
+    for(int i=0; i<n; i++) {
+      double v = GetValue(i);
+      if (v > max) max = v;
+      sum += v*scale;
+    }
+    if (mNormalizedToMax) scale = scale/max;
+    if (mNormalizedToIntegral) scale = scale/sum;
+  }
+  bool isScaled = normalise || mIsValuesMustBeScaled;
+
+  GateMessage("Actor", 1, "Save " << mFilename << " with scaling = "
+              << scale << "(" << isScaled << ")\n");
+
+  // Output images are computed one after the other in the same buffer,
+  // which is released at the end.
+  GateImageDouble & output = mScaledValueImage;
+  if (isScaled || isFloat || mIsUncertaintyImageEnabled) output.Allocate();
+
+  if (!isScaled && !isFloat) mValueImage.Write(mFilename);
+  else {
+    for(int i=0; i<n; i++) output.SetValue(i, GetValue(i)*scale);
+    output.Write(mFilename);
+  }
+
+  if (mIsSquaredImageEnabled) {
+    if (!isScaled && !isFloat) mSquaredImage.Write(mSquaredFilename);
+    else {
+      for(int i=0; i<n; i++) output.SetValue(i, GetAccumulatedSquaredValue(i)*scale*scale);
+      output.Write(mSquaredFilename);
+    }
+  }
+
+  if (mIsUncertaintyImageEnabled) {
+    for(int i=0; i<n; i++)
+      output.SetValue(i, GetRelativeUncertainty(GetValue(i), GetAccumulatedSquaredValue(i), numberOfEvents));
+    output.Write(mUncertaintyFilename);
+  }
+
+  output.Deallocate();
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::UpdateImage() {
   GateImageDouble::iterator pi = mValueImage.begin();
@@ -337,6 +558,43 @@ void GateImageWithStatistic::UpdateSquaredImage() {
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+double GateImageWithStatistic::GetRelativeUncertainty(double sum, double squared, int numberOfEvents)
+{
+  int N = numberOfEvents;
+  double mean = sum;
+
+  // Ma2002 p1679 : relative statistical uncertainty
+  /*	if (mean != 0.0)
+   return sqrt( (N*squared - mean*mean) / ((N-1)*(mean*mean)) );
+   else return 1;*/
+
+  // Chetty2006 p1250 : relative statistical uncertainty
+  // exactly same than Ma2002
+  if (mean != 0.0 && N != 1 && squared != 0.0){
+    return sqrt( (1.0/(N-1))*(squared/N - pow(mean/N, 2)))/(mean/N);
+  }
+  else return 1;
+
+  /*
+  // Ma2002 p1679 : relative statistical uncertainty (estimation)
+  if (mean != 0.0)
+  return sqrt( squared/(mean*mean) );
+  else return 1;
+  */
+
+  /*
+  // Walters2002 p2745 : statistical uncertainty
+  if (mean != 0.0) {
+  return sqrt((1.0/((double)N-1.0)) *
+  (squared/(double)N - pow(mean/(double)N, 2)));
+  }
+  else return 1.0;
+  */
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::UpdateUncertaintyImage(int numberOfEvents)
 {
@@ -349,39 +607,8 @@ void GateImageWithStatistic::UpdateUncertaintyImage(int numberOfEvents)
   pii = mSquaredImage.begin();
   pe = mValueImage.end();
 
-  int N = numberOfEvents;
-
   while (pi != pe) {
-    double squared = (*pii);
-    double mean = (*pi);
-
-    // Ma2002 p1679 : relative statistical uncertainty
-    /*	if (mean != 0.0)
-     *po = sqrt( (N*squared - mean*mean) / ((N-1)*(mean*mean)) );
-     else *po = 1;*/
-
-    // Chetty2006 p1250 : relative statistical uncertainty
-    // exactly same than Ma2002
-    if (mean != 0.0 && N != 1 && squared != 0.0){
-      *po = sqrt( (1.0/(N-1))*(squared/N - pow(mean/N, 2)))/(mean/N);
-    }
-    else *po = 1;
-
-    /*
-    // Ma2002 p1679 : relative statistical uncertainty (estimation)
-    if (mean != 0.0)
-    *po = sqrt( squared/(mean*mean) );
-    else *po = 1;
-    */
-
-    /*
-    // Walters2002 p2745 : statistical uncertainty
-    if (mean != 0.0) {
-    *po = sqrt((1.0/((double)N-1.0)) *
-    (squared/(double)N - pow(mean/(double)N, 2)));
-    }
-    else *po = 1.0;
-    */
+    *po = GetRelativeUncertainty(*pi, *pii, numberOfEvents);
     ++po;
     ++pi;
     ++pii;
@@ -52,6 +52,22 @@ GateLETActor::GateLETActor(G4String name, G4int depth):
   pMessenger = new GateLETActorMessenger(this);
   GateDebugMessageDec("Actor",4,"GateLETActor() -- end\n");
   emcalc = new G4EmCalculator;
+
+  // Electronic dedx, restricted to mCutVal; the tables are cleared at each run,
+  // so the cut may be changed between runs
+  GateStoppingPowerTable::ComputeFunction dedx = [this](G4double energy,
+                                                        const G4ParticleDefinition * particle,
+                                                        const G4Material * material) {
+    return emcalc->ComputeElectronicDEDX(energy, particle, material, mCutVal);
+  };
+  mDEDXTable.SetComputeFunction(dedx);
+  mOtherMaterialDEDXTable.SetComputeFunction(dedx);
+  mOtherMaterial = 0;
+  mDEDXValidationPeriod = 0;
+  mDEDXValidationStepCount = 0;
+  mDEDXValidationCount = 0;
+  mDEDXValidationMaxRelDiff = 0;
+  mDEDXValidationSumRelDiff = 0;
 }
 //-----------------------------------------------------------------------------
 
@@ -73,7 +89,9 @@ void GateLETActor::Construct() {
   // Find G4_WATER. This it needed here because we will used this
   // material for dedx computation for LETtoWater.
   G4cout << "Build material: " << mSetMaterial << G4endl;
-  G4NistManager::Instance()->FindOrBuildMaterial(mSetMaterial);
+  mOtherMaterial = G4NistManager::Instance()->FindOrBuildMaterial(mSetMaterial);
+  if (!mOtherMaterial) GateError("The LET actor " << GetObjectName()
+                                 << " cannot find the material '" << mSetMaterial << "'");
 
   // Enable callbacks
   EnableBeginOfRunAction(true);
@@ -294,6 +312,45 @@ void GateLETActor::BeginOfRunAction(const G4Run * r) {
   GateVActor::BeginOfRunAction(r);
   GateDebugMessage("Actor", 3, "GateLETActor -- Begin of Run\n");
   // ResetData(); // Do no reset here !! (when multiple run);
+
+  // Materials and cuts may have changed since the previous run
+  mDEDXTable.Clear();
+  mOtherMaterialDEDXTable.Clear();
+  mDEDXValidationStepCount = 0;
+  mDEDXValidationCount = 0;
+  mDEDXValidationMaxRelDiff = 0;
+  mDEDXValidationSumRelDiff = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateLETActor::EndOfRunAction(const G4Run * r) {
+  GateVActor::EndOfRunAction(r);
+  GateMessage("Actor", 1, "LET actor '" << GetObjectName() << "': "
+              << mDEDXTable.GetNumberOfTables() + mOtherMaterialDEDXTable.GetNumberOfTables()
+              << " dedx tables built" << Gateendl);
+  if (mDEDXValidationCount > 0) {
+    GateMessage("Actor", 0, "LET actor '" << GetObjectName() << "': dedx table validated on "
+                << mDEDXValidationCount << " steps, relative difference to the exact dedx: mean "
+                << mDEDXValidationSumRelDiff/mDEDXValidationCount
+                << ", max " << mDEDXValidationMaxRelDiff << Gateendl);
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateLETActor::ValidateDEDX(G4double energy, const G4ParticleDefinition* p,
+                                const G4Material* m, G4double dedx) {
+  G4double exactDEDX = mDEDXTable.ComputeValue(energy, p, m);
+  G4double relDiff = (exactDEDX != 0 ? std::fabs(dedx-exactDEDX)/exactDEDX : std::fabs(dedx));
+  mDEDXValidationCount++;
+  mDEDXValidationSumRelDiff += relDiff;
+  if (relDiff > mDEDXValidationMaxRelDiff) mDEDXValidationMaxRelDiff = relDiff;
+  GateMessage("Actor", 2, "Particle : " << p->GetParticleName() << "\t energy : " << energy
+              << "\t material : " << m->GetName() << "\t dedx (table) : " << dedx
+              << "\t dedx (exact) : " << exactDEDX << "\t relative difference : " << relDiff << Gateendl);
 }
 //-----------------------------------------------------------------------------
 
@@ -349,7 +406,10 @@ void GateLETActor::UserSteppingActionInVoxel(const int index, const G4Step* step
   double weightedLET =0;
   double normalizationVal = 0;
   
-  G4double dedx = emcalc->ComputeElectronicDEDX(energy, partname, material,mCutVal);
+  // Interpolated in a table built at the first step of this (particle, material)
+  G4double dedx = mDEDXTable.GetValue(energy, partname, material);
+  if (mDEDXValidationPeriod > 0 && ++mDEDXValidationStepCount % mDEDXValidationPeriod == 0)
+    ValidateDEDX(energy, partname, material, dedx);
   //if (mRestrictedLET){
       //dedx = emcalc->ComputeElectronicDEDX(energy, partname, material,mCutVal);
   //}
@@ -357,7 +417,7 @@ void GateLETActor::UserSteppingActionInVoxel(const int index, const G4Step* step
   G4double SPR_ToWater =1.0;
   
   if (mIsLETtoWaterEnabled){
-    G4double dedx_Water = emcalc->ComputeElectronicDEDX(energy, partname->GetParticleName(), mSetMaterial, mCutVal) ;
+    G4double dedx_Water = mOtherMaterialDEDXTable.GetValue(energy, partname, mOtherMaterial);
     
     //if (mRestrictedLET){
         //dedx_Water = emcalc->ComputeElectronicDEDX(energy, partname->GetParticleName(), mSetMaterial, mCutVal) ;
@@ -22,6 +22,8 @@ GateLETActorMessenger::GateLETActorMessenger(GateLETActor* sensor)
   pAveragingTypeCmd = 0;
   pSetParallelCalculationCmd = 0;
   pSetOtherMaterialCmd = 0;
+  pSetDEDXTableBinsCmd = 0;
+  pSetDEDXTableValidationCmd = 0;
   BuildCommands(baseName+sensor->GetObjectName());
 }
 //-----------------------------------------------------------------------------
@@ -34,6 +36,8 @@ GateLETActorMessenger::~GateLETActorMessenger()
   if(pAveragingTypeCmd) delete pAveragingTypeCmd;
   if(pSetParallelCalculationCmd) delete pSetParallelCalculationCmd;
   if(pSetOtherMaterialCmd) delete pSetOtherMaterialCmd;
+  if(pSetDEDXTableBinsCmd) delete pSetDEDXTableBinsCmd;
+  if(pSetDEDXTableValidationCmd) delete pSetDEDXTableValidationCmd;
 }
 //-----------------------------------------------------------------------------
 
@@ -81,6 +85,20 @@ void GateLETActorMessenger::BuildCommands(G4String base)
   pThrMaxCmd->SetGuidance(guid);
   pThrMaxCmd->SetParameterName("LETthresholdMax", false);
   pThrMaxCmd->SetDefaultUnit("MeV/mm");
+
+  n = base+"/setDEDXTableBinsPerDecade";
+  pSetDEDXTableBinsCmd = new G4UIcmdWithAnInteger(n, this);
+  guid = G4String("Set the number of bins per energy decade of the tabulated electronic dedx (default 50, 0 = exact computation at each step)");
+  pSetDEDXTableBinsCmd->SetGuidance(guid);
+  pSetDEDXTableBinsCmd->SetParameterName("N", false);
+  pSetDEDXTableBinsCmd->SetRange("N>=0");
+
+  n = base+"/setDEDXTableValidation";
+  pSetDEDXTableValidationCmd = new G4UIcmdWithAnInteger(n, this);
+  guid = G4String("Compare the tabulated dedx to the exact one every N steps, the differences are reported at the end of the run (default 0 = no comparison)");
+  pSetDEDXTableValidationCmd->SetGuidance(guid);
+  pSetDEDXTableValidationCmd->SetParameterName("N", false);
+  pSetDEDXTableValidationCmd->SetRange("N>=0");
 }
 //-----------------------------------------------------------------------------
 
@@ -96,6 +114,8 @@ void GateLETActorMessenger::SetNewValue(G4UIcommand* cmd, G4String newValue)
   if (cmd == pCutValCmd) pLETActor->SetCutVal(pCutValCmd->GetNewDoubleValue(newValue));
   if (cmd == pThrMinCmd) pLETActor->SetLETthrMin(pThrMinCmd->GetNewDoubleValue(newValue));
   if (cmd == pThrMaxCmd) pLETActor->SetLETthrMax(pThrMaxCmd->GetNewDoubleValue(newValue));
+  if (cmd == pSetDEDXTableBinsCmd) pLETActor->SetDEDXTableBinsPerDecade(pSetDEDXTableBinsCmd->GetNewIntValue(newValue));
+  if (cmd == pSetDEDXTableValidationCmd) pLETActor->SetDEDXTableValidation(pSetDEDXTableValidationCmd->GetNewIntValue(newValue));
 
   GateImageActorMessenger::SetNewValue( cmd, newValue);
 }
@@ -122,12 +122,19 @@ GatePulseList* GateLocalMultipleRejection::ProcessPulseList(const GatePulseList*
            }
       }
       else if (flagDeleteAll==false && posErase.size()>1){
-           std::sort (posErase.begin(), posErase.end());
-          for(unsigned int i=0; i<posErase.size(); i++){
-              // G4cout<<" position to delte="<<posErase.at(i)<<G4endl;
-              delete outputPulseList->at(posErase.at(i)-i);
-              outputPulseList->erase(outputPulseList->begin()+posErase.at(i)-i);
+          // Remove the rejected pulses in a single pass over the list
+          std::vector<bool> toErase(outputPulseList->size(),false);
+          for(unsigned int i=0; i<posErase.size(); i++)
+              toErase[posErase.at(i)]=true;
+          GatePulseIterator kept = outputPulseList->begin();
+          for(unsigned int i=0; i<toErase.size(); i++){
+              GatePulse* pulse = (*outputPulseList)[i];
+              if(toErase[i])
+                  delete pulse;
+              else
+                  *kept++ = pulse;
           }
+          outputPulseList->erase(kept, outputPulseList->end());
       }
   }
 
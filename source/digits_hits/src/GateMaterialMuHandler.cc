@@ -6,6 +6,8 @@
 #include "GateMuDatabase.hh"
 #include "GateMiscFunctions.hh"
 #include "GateConfiguration.h"
+#include "G4Version.hh"
+#include <cstdlib>
 #include <string>
 #include <sstream>
 #include <iostream>
@@ -51,7 +53,30 @@ void GateMaterialMuHandler::CheckLastCall(const G4MaterialCutsCouple* couple)
 
   if(couple != mLastCouple) {
     mLastCouple = couple;
-    mLastMuTable = mCoupleTable[mLastCouple];
+    unsigned int index = couple->GetIndex();
+    if(index < mCoupleIndexTable.size() && mCoupleIndexTable[index]) {
+      mLastMuTable = mCoupleIndexTable[index];
+    }
+    else {
+      map<const G4MaterialCutsCouple *, GateMuTable *>::iterator it = mCoupleTable.find(couple);
+      if(it == mCoupleTable.end()) {
+        GateError("GateMaterialMuHandler -- no mu/muen table for material '" << couple->GetMaterial()->GetName() << "'");
+      }
+      mLastMuTable = it->second;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateMaterialMuHandler::BuildCoupleIndexTable()
+{
+  mCoupleIndexTable.clear();
+  map<const G4MaterialCutsCouple *, GateMuTable *>::iterator it;
+  for(it = mCoupleTable.begin(); it != mCoupleTable.end(); it++) {
+    unsigned int index = it->first->GetIndex();
+    if(index >= mCoupleIndexTable.size()) { mCoupleIndexTable.resize(index+1, 0); }
+    mCoupleIndexTable[index] = it->second;
   }
 }
 //-----------------------------------------------------------------------------
@@ -113,6 +138,13 @@ inline double interpolation(double Xa,double Xb,double Ya,double Yb,double x){
 //-----------------------------------------------------------------------------
 void GateMaterialMuHandler::Initialize()
 {
+  if(mCacheFileName != "" && AttachCacheFile())
+    {
+      BuildCoupleIndexTable();
+      mIsInitialized = true;
+      return;
+    }
+
   if(mDatabaseName == "simulated")
     {
       SimulateMaterialTable();
@@ -154,10 +186,168 @@ void GateMaterialMuHandler::Initialize()
       GateError("GateMaterialMuHandler -- mu/muen database option '" << mDatabaseName << "' doesn't exist. Available database are 'NIST', 'EPDL' and 'user'");
     }
 
+  if(mCacheFileName != "") { WriteCacheFile(); }
+
+  BuildCoupleIndexTable();
   mIsInitialized = true;
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+// Everything the tables depend on: options, the data of the database (the
+// NIST/EPDL values built into GateMuDatabase, or the Geant4 version and low
+// energy data for the 'simulated' one), and for each couple its material
+// composition and gamma cut (used by the 'simulated' database)
+uint64_t GateMaterialMuHandler::ComputeCacheHash()
+{
+  GateSharedTableFile::Hash hash;
+  hash.Add(mDatabaseName);
+  if(mDatabaseName == "NIST")
+    {
+      hash.Add(NIST_mu_muen_data_energyNumber, sizeof(NIST_mu_muen_data_energyNumber));
+      hash.Add(NIST_mu_muen_data, sizeof(NIST_mu_muen_data));
+    }
+  else if(mDatabaseName == "EPDL")
+    {
+      hash.Add(EPDL_mu_muen_data_energyNumber, sizeof(EPDL_mu_muen_data_energyNumber));
+      hash.Add(EPDL_mu_muen_data, sizeof(EPDL_mu_muen_data));
+    }
+  else
+    {
+      hash.Add(G4VERSION_NUMBER);
+      const char *ledata = getenv("G4LEDATA");
+      hash.Add(G4String(ledata ? ledata : ""));
+    }
+  hash.Add(mEnergyMin);
+  hash.Add(mEnergyMax);
+  hash.Add(mEnergyNumber);
+  hash.Add(mAtomicShellEnergyMin);
+  hash.Add(mPrecision);
+
+  G4ProductionCutsTable *productionCutList = G4ProductionCutsTable::GetProductionCutsTable();
+  hash.Add(uint64_t(productionCutList->GetTableSize()));
+  for(unsigned int m=0; m<productionCutList->GetTableSize(); m++)
+    {
+      const G4MaterialCutsCouple *couple = productionCutList->GetMaterialCutsCouple(m);
+      const G4Material *material = couple->GetMaterial();
+      hash.Add(material->GetName());
+      hash.Add(material->GetDensity());
+      hash.Add(uint64_t(material->GetNumberOfElements()));
+      const G4double* fractionMass = material->GetFractionVector();
+      for(unsigned int i=0; i<material->GetNumberOfElements(); i++)
+        {
+          hash.Add(material->GetElement(i)->GetZ());
+          hash.Add(fractionMass[i]);
+        }
+      hash.Add(couple->GetProductionCuts()->GetProductionCut("gamma"));
+    }
+  return hash.GetValue();
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Payload: number of couples and of tables, table index of each couple (in the
+// production cuts table order), size of each table, then the energy, mu and muen
+// values of each table. Everything is 8 bytes wide, so the values are aligned.
+static const uint32_t muHandlerCacheVersion = 1;
+
+bool GateMaterialMuHandler::AttachCacheFile()
+{
+  if(!mCacheFile.Attach(mCacheFileName, ComputeCacheHash(), muHandlerCacheVersion)) { return false; }
+
+  const uint64_t *header = reinterpret_cast<const uint64_t *>(mCacheFile.GetPayload());
+  uint64_t payloadSize = mCacheFile.GetPayloadSize() / sizeof(uint64_t);
+  G4ProductionCutsTable *productionCutList = G4ProductionCutsTable::GetProductionCutsTable();
+  if(payloadSize < 2 || header[0] != productionCutList->GetTableSize() || 2 + header[0] + header[1] > payloadSize)
+    {
+      GateWarning("GateMaterialMuHandler -- inconsistent mu/muen table file '" << mCacheFileName << "', tables are rebuilt" << Gateendl);
+      mCacheFile.Detach();
+      return false;
+    }
+  uint64_t nbCouples = header[0];
+  uint64_t nbTables = header[1];
+  const uint64_t *coupleTable = header + 2;
+  const uint64_t *sizes = coupleTable + nbCouples;
+  const double *values = reinterpret_cast<const double *>(sizes + nbTables);
+  std::vector<uint64_t> offsets(nbTables, 0);
+  uint64_t nbValues = 0;
+  for(uint64_t t=0; t<nbTables; t++)
+    {
+      offsets[t] = nbValues;
+      nbValues += 3*sizes[t];
+    }
+  if(2 + nbCouples + nbTables + nbValues != payloadSize)
+    {
+      GateWarning("GateMaterialMuHandler -- inconsistent mu/muen table file '" << mCacheFileName << "', tables are rebuilt" << Gateendl);
+      mCacheFile.Detach();
+      return false;
+    }
+
+  std::vector<GateMuTable *> tables(nbTables, 0);
+  for(unsigned int m=0; m<nbCouples; m++)
+    {
+      const G4MaterialCutsCouple *couple = productionCutList->GetMaterialCutsCouple(m);
+      uint64_t t = coupleTable[m];
+      if(t >= nbTables) { GateError("GateMaterialMuHandler -- corrupted mu/muen table file '" << mCacheFileName << "'"); }
+      if(!tables[t])
+        {
+          const double *v = values + offsets[t];
+          // the couple of a table shared by several couples is the first one, as when built
+          tables[t] = new GateMuTable(couple, sizes[t], v, v+sizes[t], v+2*sizes[t]);
+        }
+      mCoupleTable.insert(std::pair<const G4MaterialCutsCouple *, GateMuTable *>(couple,tables[t]));
+    }
+
+  GateMessage("Physic",1,"mu/mu_en tables attached from " << mCacheFileName << Gateendl);
+  return true;
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateMaterialMuHandler::WriteCacheFile()
+{
+  G4ProductionCutsTable *productionCutList = G4ProductionCutsTable::GetProductionCutsTable();
+  std::vector<uint64_t> coupleTable;
+  std::vector<GateMuTable *> tables;
+  map<GateMuTable *, uint64_t> tableIndex;
+  for(unsigned int m=0; m<productionCutList->GetTableSize(); m++)
+    {
+      map<const G4MaterialCutsCouple *, GateMuTable *>::iterator it = mCoupleTable.find(productionCutList->GetMaterialCutsCouple(m));
+      if(it == mCoupleTable.end()) { return; }
+      GateMuTable *table = it->second;
+      if(tableIndex.find(table) == tableIndex.end())
+        {
+          tableIndex[table] = tables.size();
+          tables.push_back(table);
+        }
+      coupleTable.push_back(tableIndex[table]);
+    }
+
+  std::vector<uint64_t> header;
+  header.push_back(coupleTable.size());
+  header.push_back(tables.size());
+  header.insert(header.end(), coupleTable.begin(), coupleTable.end());
+  for(unsigned int t=0; t<tables.size(); t++) { header.push_back(tables[t]->GetSize()); }
+
+  std::vector<char> payload(reinterpret_cast<const char *>(&header[0]), reinterpret_cast<const char *>(&header[0] + header.size()));
+  for(unsigned int t=0; t<tables.size(); t++)
+    {
+      size_t size = tables[t]->GetSize() * sizeof(double);
+      const char *e = reinterpret_cast<const char *>(tables[t]->GetEnergies());
+      const char *mu = reinterpret_cast<const char *>(tables[t]->GetMuTable());
+      const char *muen = reinterpret_cast<const char *>(tables[t]->GetMuEnTable());
+      payload.insert(payload.end(), e, e+size);
+      payload.insert(payload.end(), mu, mu+size);
+      payload.insert(payload.end(), muen, muen+size);
+    }
+
+  if(GateSharedTableFile::Write(mCacheFileName, ComputeCacheHash(), muHandlerCacheVersion, payload))
+    {
+      GateMessage("Physic",1,"mu/mu_en tables written to " << mCacheFileName << Gateendl);
+    }
+}
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 void GateMaterialMuHandler::ConstructMaterial(const G4MaterialCutsCouple *couple)
 {
@@ -9,11 +9,34 @@ GateMuTable::GateMuTable(const G4MaterialCutsCouple *couple, G4int size)
   mEnergy = new double[size];
   mMu = new double[size];
   mMu_en = new double[size];
+  mOwnsValues = true;
+  Init(couple, size);
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+GateMuTable::GateMuTable(const G4MaterialCutsCouple *couple, G4int size,
+                         const double *energy, const double *mu, const double *mu_en)
+{
+  // the values are only read (PutValue is not used on such a table)
+  mEnergy = const_cast<double*>(energy);
+  mMu = const_cast<double*>(mu);
+  mMu_en = const_cast<double*>(mu_en);
+  mOwnsValues = false;
+  Init(couple, size);
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateMuTable::Init(const G4MaterialCutsCouple *couple, G4int size)
+{
   mSize = size;
   lastMu = -1.0;
   lastMuen = -1.0;
   lastEnergyMu = -1.0;
   lastEnergyMuen = -1.0;
+  mLogGridMin = 0.;
+  mLogGridInvBinWidth = 0.;
 
   mCouple = couple;
   mDensity = -1;
@@ -28,9 +51,11 @@ GateMuTable::GateMuTable(const G4MaterialCutsCouple *couple, G4int size)
 //-----------------------------------------------------------------------------
 GateMuTable::~GateMuTable()
 {
-  delete[] mEnergy;
-  delete[] mMu;
-  delete[] mMu_en;
+  if(mOwnsValues) {
+    delete[] mEnergy;
+    delete[] mMu;
+    delete[] mMu_en;
+  }
 }
 //-----------------------------------------------------------------------------
 
@@ -52,6 +77,44 @@ inline double interpol(double x1, double x, double x2,
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+void GateMuTable::BuildLogGrid()
+{
+  // A few bins per table interval, so that FindInterval rarely needs
+  // more than one step from the bin start
+  int nbBins = 8*mSize;
+  mLogGridMin = mEnergy[0];
+  double width = (mEnergy[mSize-1] - mEnergy[0]) / nbBins;
+  mLogGridInvBinWidth = (width > 0.) ? 1./width : 0.;
+  mLogGrid.resize(nbBins);
+  int inf = 0;
+  for(int b = 0; b < nbBins; b++) {
+    double e = mLogGridMin + b*width;
+    while(inf+1 < mSize-1 && mEnergy[inf+1] <= e) inf++;
+    mLogGrid[b] = inf;
+  }
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+int GateMuTable::FindInterval(double energy)
+{
+  if(mLogGrid.empty()) BuildLogGrid();
+
+  // Same interval as a bisection: the last one (at most mSize-2) whose
+  // lower bound is <= energy, so that an energy exactly on an atomic
+  // shell edge (duplicated in the table) gets the value above the edge
+  double x = (energy - mLogGridMin) * mLogGridInvBinWidth;
+  int nbBins = mLogGrid.size();
+  int b = 0;
+  if(x > 0.) b = (x < nbBins) ? int(x) : nbBins-1;
+  int inf = mLogGrid[b];
+  while(inf > 0 && mEnergy[inf] > energy) inf--; // rounding of the bin index
+  while(inf+1 < mSize-1 && mEnergy[inf+1] <= energy) inf++;
+  return inf;
+}
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 double GateMuTable::GetMuEnOverRho(double energy)
 {
@@ -59,16 +122,13 @@ double GateMuTable::GetMuEnOverRho(double energy)
   {
     lastEnergyMuen = energy;
 
+    // a single-point table has no interval: its only value is used
+    if(mSize < 2) { lastMuen = exp(mMu_en[0]); return lastMuen; }
+
     energy = log(energy);
 
-    int inf = 0;
-    int sup = mSize-1;
-    while(sup - inf > 1)
-    {
-      int tmp_bound = (inf + sup)/2;
-      if(mEnergy[tmp_bound] > energy) { sup = tmp_bound; }
-      else { inf = tmp_bound; }
-    }
+    int inf = FindInterval(energy);
+    int sup = inf+1;
     double e_inf = mEnergy[inf];
     double e_sup = mEnergy[sup];
 
@@ -94,16 +154,13 @@ double GateMuTable::GetMuOverRho(double energy)
   {
     lastEnergyMu = energy;
 
+    // a single-point table has no interval: its only value is used
+    if(mSize < 2) { lastMu = exp(mMu[0]); return lastMu; }
+
     energy = log(energy);
 
-    int inf = 0;
-    int sup = mSize-1;
-    while(sup - inf > 1)
-    {
-      int tmp_bound = (inf + sup)/2;
-      if(mEnergy[tmp_bound] > energy) { sup = tmp_bound; }
-      else { inf = tmp_bound; }
-    }
+    int inf = FindInterval(energy);
+    int sup = inf+1;
     double e_inf = mEnergy[inf];
     double e_sup = mEnergy[sup];
 
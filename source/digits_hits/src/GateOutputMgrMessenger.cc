@@ -8,6 +8,7 @@
 
 #include "GateOutputMgrMessenger.hh"
 #include "GateOutputMgr.hh"
+#include "GateNumpyFile.hh"
 
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithAString.hh"
@@ -16,6 +17,7 @@
 #include "G4UIcmdWithADoubleAndUnit.hh"
 #include "G4UIcmdWith3VectorAndUnit.hh"
 #include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcmdWithABool.hh"
 
 //------------------------------------------------------------------------------
 GateOutputMgrMessenger::GateOutputMgrMessenger(GateOutputMgr* outputMgr)
@@ -43,6 +45,16 @@ GateOutputMgrMessenger::GateOutputMgrMessenger(GateOutputMgr* outputMgr)
   cmdName = GetDirectoryName()+"allowNoOutput";
   AllowNoOutputCmd = new G4UIcmdWithoutParameter(cmdName,this);
   AllowNoOutputCmd->SetGuidance("Allow to launch a simulation without any output nor actor");
+
+  cmdName = GetDirectoryName()+"setNumpyBufferSize";
+  NumpyBufferSizeCmd = new G4UIcmdWithADouble(cmdName,this);
+  NumpyBufferSizeCmd->SetGuidance("Size (in MB) of the memory buffer used to write .npy files (default 16 MB, 0 = one entry)");
+  NumpyBufferSizeCmd->SetParameterName("size",false);
+  NumpyBufferSizeCmd->SetRange("size>=0");
+
+  cmdName = GetDirectoryName()+"enableNumpyColumns";
+  NumpyColumnarCmd = new G4UIcmdWithABool(cmdName,this);
+  NumpyColumnarCmd->SetGuidance("Write each variable of a .npy output to its own file <name>_<variable>.npy instead of a single structured array");
 }
 //------------------------------------------------------------------------------
 
@@ -53,6 +65,8 @@ GateOutputMgrMessenger::~GateOutputMgrMessenger()
   delete DescribeCmd;
   delete VerboseCmd;
   delete AllowNoOutputCmd;
+  delete NumpyBufferSizeCmd;
+  delete NumpyColumnarCmd;
   delete pGateOutputMess;
 }
 //------------------------------------------------------------------------------
@@ -67,6 +81,10 @@ void GateOutputMgrMessenger::SetNewValue(G4UIcommand* command, G4String newValue
     m_outputMgr->Describe();
   } else if( command == AllowNoOutputCmd ) {
     m_outputMgr->AllowNoOutput();
+  } else if( command == NumpyBufferSizeCmd ) {
+    GateOutputNumpyTreeFile::set_buffer_size(NumpyBufferSizeCmd->GetNewDoubleValue(newValue)*1024*1024);
+  } else if( command == NumpyColumnarCmd ) {
+    GateOutputNumpyTreeFile::set_columnar(NumpyColumnarCmd->GetNewBoolValue(newValue));
   } else
   GateMessenger::SetNewValue(command, newValue);
 }
@@ -15,13 +15,15 @@ See LICENSE.md for further details
 #include "GatePileupMessenger.hh"
 #include "GateTools.hh"
 
+#include <algorithm>
+
 
 GatePileup::GatePileup(GatePulseProcessorChain* itsChain,
       	      	      	 const G4String& itsName)
   : GateVPulseProcessor(itsChain,itsName),
     m_depth(1),
     m_pileup(0),
-    m_waiting("")
+    m_arrivalCount(0)
 {
   m_messenger = new GatePileupMessenger(this);
 }
@@ -31,6 +33,9 @@ GatePileup::GatePileup(GatePulseProcessorChain* itsChain,
 
 GatePileup::~GatePileup()
 {
+  for (BlockIndex::iterator block = m_waitingPerBlock.begin() ; block != m_waitingPerBlock.end() ; ++block)
+    for (size_t i = 0 ; i < block->second.size() ; ++i)
+      delete block->second[i].pulse;
   delete m_messenger;
 }
 
@@ -39,26 +44,37 @@ GatePulseList* GatePileup::ProcessPulseList(const GatePulseList* inputPulseList)
 {
   G4double minTime = inputPulseList->ComputeStartTime();
   GatePulseList* ans = new GatePulseList(GetObjectName());
-  std::vector<GatePulseIterator> toDel;
-  GatePulseIterator iter;
-  for (iter = m_waiting.begin() ; iter != m_waiting.end() ; ++iter ){
-    if ( (*iter)->GetTime()+m_pileup<minTime) {
-    	ans->push_back( (*iter) );
-	toDel.push_back(iter);
-    }
-  }
-  for (int i= (int)toDel.size()-1;i>=0;i--){
-    m_waiting.erase( toDel[i] );
+
+  // Flush the pulses whose pileup window is over: they come out of the expiry queue
+  // in time order, so each one is also the earliest waiting pulse of its block
+  std::vector<WaitingPulse> expired;
+  while (!m_expiryQueue.empty() && m_expiryQueue.top().time+m_pileup<minTime) {
+    WaitingPulse entry = m_expiryQueue.top();
+    m_expiryQueue.pop();
+    if (entry.pulse->GetTime()!=entry.time)
+      continue; // the pulse time has moved forward, it is queued again with its new time
+    BlockIndex::iterator block = m_waitingPerBlock.find(entry.pulse->GetOutputVolumeID().Top(m_depth));
+    block->second.pop_front();
+    if (block->second.empty())
+      m_waitingPerBlock.erase(block);
+    expired.push_back(entry);
   }
 
+  // The output keeps the arrival order of the pulses
+  std::sort(expired.begin(), expired.end(),
+            [](const WaitingPulse& a,const WaitingPulse& b) { return a.arrival<b.arrival; });
+  for (size_t i = 0 ; i < expired.size() ; ++i)
+    ans->push_back(expired[i].pulse);
+
   GatePulseConstIterator itr;
   for (itr = inputPulseList->begin() ; itr != inputPulseList->end() ; ++itr)
-      	ProcessOnePulse( *itr, m_waiting);
+      	ProcessOnePulse( *itr, *ans); // the pulses go to the waiting pulses, not to ans
   return ans;
 }
 
 
-void GatePileup::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outputPulseList)
+// The input pulse goes to the waiting pulses (m_waitingPerBlock), outputPulseList is not used
+void GatePileup::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& )
 {
   const GateOutputVolumeID& blockID  = inputPulse->GetOutputVolumeID().Top(m_depth);
 
@@ -70,31 +86,52 @@ void GatePileup::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outp
     return;
   }
 
-  GatePulseIterator iter;
-  for (iter = outputPulseList.begin() ; iter != outputPulseList.end() ; ++iter )
-    if ( ((*iter)->GetOutputVolumeID().Top(m_depth) == blockID )
-         &&  (std::abs((*iter)->GetTime()-inputPulse->GetTime())<m_pileup) )
-      break;
-
-  if ( iter != outputPulseList.end() ){
-     G4double energySum = (*iter)->GetEnergy() + inputPulse->GetEnergy();
-     if ( inputPulse->GetEnergy() > (*iter)->GetEnergy() ){
-     	G4double time = std::max( (*iter)->GetTime() ,inputPulse->GetTime());
-      	**iter = *inputPulse;
-	(*iter)->SetTime(time);
+  // Only the waiting pulses of the same block within the window are candidates.
+  // The first one to have arrived is used, as when the block was searched in arrival order.
+  std::deque<WaitingPulse>& blockPulses = m_waitingPerBlock[blockID];
+  G4double inputTime = inputPulse->GetTime();
+  std::deque<WaitingPulse>::iterator iter = std::partition_point(blockPulses.begin(), blockPulses.end(),
+      [&](const WaitingPulse& w) { return inputTime-w.time>=m_pileup; });
+  std::deque<WaitingPulse>::iterator match = blockPulses.end();
+  for ( ; iter != blockPulses.end() && iter->time-inputTime<m_pileup ; ++iter )
+    if ( match == blockPulses.end() || iter->arrival<match->arrival )
+      match = iter;
+
+  if ( match != blockPulses.end() ){
+     GatePulse* pulse = match->pulse;
+     G4double energySum = pulse->GetEnergy() + inputPulse->GetEnergy();
+     if ( inputPulse->GetEnergy() > pulse->GetEnergy() ){
+     	G4double time = std::max( pulse->GetTime() ,inputPulse->GetTime());
+      	*pulse = *inputPulse;
+	pulse->SetTime(time);
+     }
+     pulse->SetEnergy(energySum);
+     if (pulse->GetTime()!=match->time) {
+       // The time moved forward: keep the block in time order and queue the new time
+       match->time = pulse->GetTime();
+       while ( match+1 != blockPulses.end() && IsEarlier(*(match+1),*match) ) {
+         std::iter_swap(match, match+1);
+         ++match;
+       }
+       m_expiryQueue.push(*match);
      }
-     (*iter)->SetEnergy(energySum);
      if (nVerboseLevel>1)
       	  G4cout  << "Overwritten previous pulse for block " << blockID << " with new pulse with higer energy.\n"
       	          << "Resulting pulse is: \n"
-		  << **iter << Gateendl << Gateendl ;
+		  << *pulse << Gateendl << Gateendl ;
   } else {
     GatePulse* outputPulse = new GatePulse(*inputPulse);
     if (nVerboseLevel>1)
       	G4cout << "Created new pulse for block " << blockID << ".\n"
       	       << "Resulting pulse is: \n"
 	       << *outputPulse << Gateendl << Gateendl ;
-    outputPulseList.push_back(outputPulse);
+    WaitingPulse entry = { outputPulse, outputPulse->GetTime(), m_arrivalCount++ };
+    // Pulses mostly arrive in time order: the place is found from the end of the block
+    std::deque<WaitingPulse>::iterator pos = blockPulses.end();
+    while ( pos != blockPulses.begin() && IsEarlier(entry,*(pos-1)) )
+      --pos;
+    blockPulses.insert(pos, entry);
+    m_expiryQueue.push(entry);
   }
 }
 
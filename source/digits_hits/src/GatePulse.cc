@@ -12,6 +12,16 @@ See LICENSE.md for further details
 
 #include "G4UnitsTable.hh"
 
+G4Allocator<GatePulse> GatePulseAllocator;
+G4Allocator<GatePulseList> GatePulseListAllocator;
+
+// ID of the "NULL" name used to flag merged pulses
+static inline G4int NullNameID()
+{
+    static const G4int nullID = GateNameTable::GetID("NULL");
+    return nullID;
+}
+
 GatePulse::GatePulse(const void* itsMother)
     : m_runID(-1),
       m_eventID(-1),
@@ -20,9 +30,13 @@ GatePulse::GatePulse(const void* itsMother)
       m_energy(0),
       m_nPhantomCompton(-1),
       m_nPhantomRayleigh(-1),
+      m_comptonVolumeNameID(0),
+      m_RayleighVolumeNameID(0),
       #ifdef GATE_USE_OPTICAL
       m_optical(false),
       #endif
+      m_PostprocessID(0),
+      m_processCreatorID(0),
       m_energyError(0.0),
       m_globalPosError(0.0),
       m_localPosError(0.0),
@@ -41,10 +55,10 @@ const GatePulse& GatePulse::CentroidMerge(const GatePulse* right)
 
 
     // AE : Added in a real pulse no sense
-    m_Postprocess="NULL";         // PostStep process
+    m_PostprocessID=NullNameID();   // PostStep process
     m_energyIniTrack=-1;         // Initial energy of the track
     m_energyFin=-1;         // final energy of the particle
-    m_processCreator="NULL";
+    m_processCreatorID=NullNameID();
     m_trackID=0;
     //-----------------
 
@@ -88,14 +102,14 @@ const GatePulse& GatePulse::CentroidMerge(const GatePulse* right)
     if ( right->m_nPhantomCompton > m_nPhantomCompton )
     {
         m_nPhantomCompton 	= right->m_nPhantomCompton;
-        m_comptonVolumeName = right->m_comptonVolumeName;
+        m_comptonVolumeNameID = right->m_comptonVolumeNameID;
     }
 
     // # of Rayleigh process: store the max nb
     if ( right->m_nPhantomRayleigh > m_nPhantomRayleigh )
     {
         m_nPhantomRayleigh 	= right->m_nPhantomRayleigh;
-        m_RayleighVolumeName = right->m_RayleighVolumeName;
+        m_RayleighVolumeNameID = right->m_RayleighVolumeNameID;
     }
 
     // HDS : # of septal hits: store the max nb
@@ -116,10 +130,10 @@ const GatePulse & GatePulse::MergePositionEnergyWin(const GatePulse* right){
 
 
     // AE : Added in a real pulse no sense
-    m_Postprocess="NULL";         // PostStep process
+    m_PostprocessID=NullNameID();   // PostStep process
     m_energyIniTrack=0;         // Initial energy of the track
     m_energyFin=0;         // final energy of the particle
-    m_processCreator="NULL";
+    m_processCreatorID=NullNameID();
     m_trackID=0;
     //-----------------
 
@@ -153,14 +167,14 @@ const GatePulse & GatePulse::MergePositionEnergyWin(const GatePulse* right){
     if ( right->m_nPhantomCompton > m_nPhantomCompton )
     {
         m_nPhantomCompton 	= right->m_nPhantomCompton;
-        m_comptonVolumeName = right->m_comptonVolumeName;
+        m_comptonVolumeNameID = right->m_comptonVolumeNameID;
     }
 
     // # of Rayleigh process: store the max nb
     if ( right->m_nPhantomRayleigh > m_nPhantomRayleigh )
     {
         m_nPhantomRayleigh 	= right->m_nPhantomRayleigh;
-        m_RayleighVolumeName = right->m_RayleighVolumeName;
+        m_RayleighVolumeNameID = right->m_RayleighVolumeNameID;
     }
 
     // HDS : # of septal hits: store the max nb
@@ -213,14 +227,14 @@ const GatePulse& GatePulse::CentroidMergeComptPhotIdeal(const GatePulse* right)
     if ( right->m_nPhantomCompton > m_nPhantomCompton )
     {
         m_nPhantomCompton 	= right->m_nPhantomCompton;
-        m_comptonVolumeName = right->m_comptonVolumeName;
+        m_comptonVolumeNameID = right->m_comptonVolumeNameID;
     }
 
     // # of Rayleigh process: store the max nb
     if ( right->m_nPhantomRayleigh > m_nPhantomRayleigh )
     {
         m_nPhantomRayleigh 	= right->m_nPhantomRayleigh;
-        m_RayleighVolumeName = right->m_RayleighVolumeName;
+        m_RayleighVolumeNameID = right->m_RayleighVolumeNameID;
     }
 
     // HDS : # of septal hits: store the max nb
@@ -275,14 +289,14 @@ const GatePulse& GatePulse::CentroidMergeCompton(const GatePulse* right)
     if ( right->m_nPhantomCompton > m_nPhantomCompton )
     {
         m_nPhantomCompton 	= right->m_nPhantomCompton;
-        m_comptonVolumeName = right->m_comptonVolumeName;
+        m_comptonVolumeNameID = right->m_comptonVolumeNameID;
     }
 
     // # of Rayleigh process: store the max nb
     if ( right->m_nPhantomRayleigh > m_nPhantomRayleigh )
     {
         m_nPhantomRayleigh 	= right->m_nPhantomRayleigh;
-        m_RayleighVolumeName = right->m_RayleighVolumeName;
+        m_RayleighVolumeNameID = right->m_RayleighVolumeNameID;
     }
 
     // HDS : # of septal hits: store the max nb
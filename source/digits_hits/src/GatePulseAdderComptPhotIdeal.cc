@@ -27,6 +27,11 @@ GatePulseAdderComptPhotIdeal::~GatePulseAdderComptPhotIdeal()
 
 void GatePulseAdderComptPhotIdeal::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outputPulseList)
 {
+    // process names are compared by their GateNameTable IDs
+    static const G4int comptID = GateNameTable::GetID("compt");
+    static const G4int photID = GateNameTable::GetID("phot");
+    static const G4int convID = GateNameTable::GetID("conv");
+    static const G4int transportationID = GateNameTable::GetID("Transportation");
 #ifdef GATE_USE_OPTICAL
     // ignore pulses based on optical photons. These can be added using the opticaladder
     if (!inputPulse->IsOptical())
@@ -38,8 +43,8 @@ void GatePulseAdderComptPhotIdeal::ProcessOnePulse(const GatePulse* inputPulse,G
 
         if(inputPulse->GetParentID()==0)
         {
-            if(inputPulse->GetPostStepProcess()=="compt" ||inputPulse->GetPostStepProcess()=="phot" ||inputPulse->GetPostStepProcess()=="conv"  ){
-                if(inputPulse->GetPostStepProcess()=="conv"){
+            if(inputPulse->GetPostStepProcessID()==comptID ||inputPulse->GetPostStepProcessID()==photID ||inputPulse->GetPostStepProcessID()==convID  ){
+                if(inputPulse->GetPostStepProcessID()==convID){
                     flgEvtRej=1;
                 }
                 PulsePushBack(inputPulse, outputPulseList);
@@ -47,7 +52,7 @@ void GatePulseAdderComptPhotIdeal::ProcessOnePulse(const GatePulse* inputPulse,G
                 //G4cout << "inserting a pulse";
             }
             else{
-                if(inputPulse->GetPostStepProcess()!="Transportation" )flgEvtRej=1;
+                if(inputPulse->GetPostStepProcessID()!=transportationID )flgEvtRej=1;
             }
             //. La Eini de los primaries es su Eini antes de la primera interacci'on en SD of the layers no la Eini del track. This has been changed in the comptoncameraactor in where the hit coletion is saved
 
@@ -88,7 +93,7 @@ void GatePulseAdderComptPhotIdeal::ProcessOnePulse(const GatePulse* inputPulse,G
                     {
 
                         //first order secondaries
-                        if(inputPulse->GetParentID()==1 && inputPulse->GetProcessCreator()==(*iter)->GetPostStepProcess()){
+                        if(inputPulse->GetParentID()==1 && inputPulse->GetProcessCreatorID()==(*iter)->GetPostStepProcessID()){
                             if( (*iter)->GetTrackID()==1){
                                  //first secondary for the pulse
 
@@ -88,6 +88,10 @@ GatePulseList* GatePulseAdderComptPhotIdealLocal::ProcessPulseList(const GatePul
 
 void GatePulseAdderComptPhotIdealLocal::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outputPulseList)
 {
+    // process names are compared by their GateNameTable IDs
+    static const G4int comptID = GateNameTable::GetID("compt");
+    static const G4int photID = GateNameTable::GetID("phot");
+    static const G4int convID = GateNameTable::GetID("conv");
 
 
 
@@ -98,7 +102,7 @@ void GatePulseAdderComptPhotIdealLocal::ProcessOnePulse(const GatePulse* inputPu
     {
         if(inputPulse->GetParentID()==0)
         {
-            if(inputPulse->GetPostStepProcess()=="compt" ||inputPulse->GetPostStepProcess()=="phot" || inputPulse->GetPostStepProcess()=="conv"  ){
+            if(inputPulse->GetPostStepProcessID()==comptID ||inputPulse->GetPostStepProcessID()==photID || inputPulse->GetPostStepProcessID()==convID  ){
                 primaryPulses.push_back(*inputPulse);
                 if(((inputPulse->GetVolumeID()).GetBottomCreator())->GetObjectName()==m_name){
                     indexPrimVInPrim.push_back( primaryPulses.size()-1);
@@ -124,7 +128,7 @@ void GatePulseAdderComptPhotIdealLocal::ProcessOnePulse(const GatePulse* inputPu
 
             if(inputPulse->GetParentID()==0)
             {
-                if(inputPulse->GetPostStepProcess()=="compt" ||inputPulse->GetPostStepProcess()=="phot" ||inputPulse->GetPostStepProcess()=="conv"   ){
+                if(inputPulse->GetPostStepProcessID()==comptID ||inputPulse->GetPostStepProcessID()==photID ||inputPulse->GetPostStepProcessID()==convID   ){
                     PulsePushBack(inputPulse, outputPulseList);
                     primaryPulsesVol.push_back(*inputPulse);
                     indexPrimVInOut.push_back(outputPulseList.size()-1);
@@ -151,7 +155,7 @@ void GatePulseAdderComptPhotIdealLocal::ProcessOnePulse(const GatePulse* inputPu
 
 
                             //first order secondaries
-                            if(inputPulse->GetParentID()==1 && inputPulse->GetProcessCreator()==(*iter).GetPostStepProcess()){
+                            if(inputPulse->GetParentID()==1 && inputPulse->GetProcessCreatorID()==(*iter).GetPostStepProcessID()){
                                 if( (*iter).GetTrackID()==1){
                                     //first secondary for the pulse
 
@@ -0,0 +1,93 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+
+#include "GateStoppingPowerTable.hh"
+#include "GateMessageManager.hh"
+
+#include "G4SystemOfUnits.hh"
+
+//-----------------------------------------------------------------------------
+GateStoppingPowerTable::GateStoppingPowerTable()
+  : mLastKey(0, 0),
+    mLastTable(0),
+    mEmin(1.*keV),
+    mEmax(10.*GeV),
+    mBinsPerDecade(50)
+{
+  SetEnergyRange(mEmin, mEmax);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateStoppingPowerTable::SetEnergyRange(G4double emin, G4double emax)
+{
+  if (emin<=0 || emax<=emin)
+    GateError("GateStoppingPowerTable: invalid energy range [" << emin << ", " << emax << "]");
+  mEmin = emin;
+  mEmax = emax;
+  Clear();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateStoppingPowerTable::SetNumberOfBinsPerDecade(G4int n)
+{
+  mBinsPerDecade = n;
+  Clear();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateStoppingPowerTable::Clear()
+{
+  mTables.clear();
+  mLastKey = KeyType(0, 0);
+  mLastTable = 0;
+  mLogEmin = std::log(mEmin);
+  if (mBinsPerDecade>0) mInvLogStep = mBinsPerDecade/std::log(10.);
+  else mInvLogStep = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+const std::vector<G4double>& GateStoppingPowerTable::GetTable(const G4ParticleDefinition* p, const G4Material* m)
+{
+  KeyType key(p, m);
+  if (mLastTable && key == mLastKey) return *mLastTable;
+
+  std::map<KeyType, std::vector<G4double> >::iterator it = mTables.find(key);
+  if (it == mTables.end()) {
+    it = mTables.insert(std::make_pair(key, std::vector<G4double>())).first;
+    BuildTable(p, m, it->second);
+  }
+  mLastKey = key;
+  mLastTable = &(it->second);
+  return *mLastTable;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateStoppingPowerTable::BuildTable(const G4ParticleDefinition* p, const G4Material* m,
+                                        std::vector<G4double>& table)
+{
+  // n+1 nodes, the last one at or above emax
+  const G4int n = std::max(1, (G4int)std::ceil((std::log(mEmax)-mLogEmin)*mInvLogStep));
+  table.resize(n+1);
+  for (G4int i=0; i<=n; i++)
+    table[i] = mFunction(std::exp(mLogEmin + i/mInvLogStep), p, m);
+
+  GateMessage("Actor", 2, "GateStoppingPowerTable: built table for " << p->GetParticleName()
+              << " in " << m->GetName() << " (" << n+1 << " nodes)" << Gateendl);
+}
+//-----------------------------------------------------------------------------
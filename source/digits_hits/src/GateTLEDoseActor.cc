@@ -158,8 +158,12 @@ void GateTLEDoseActor::ResetData() {
 
 
 //-----------------------------------------------------------------------------
-void GateTLEDoseActor::UserSteppingAction(const GateVVolume *, const G4Step *step)
+void GateTLEDoseActor::UserSteppingAction(const GateVVolume * v, const G4Step *step)
 {
+  if (mStepHitType == TraversalStepHitType) {
+    GateVImageActor::UserSteppingAction(v, step);
+    return;
+  }
   int index = GetIndexFromStepPosition(GetVolume(), step);
   UserSteppingActionInVoxel(index, step);
 }
@@ -187,6 +191,15 @@ void GateTLEDoseActor::BeginOfEventAction(const G4Event *e) {
 
 //-----------------------------------------------------------------------------
 void GateTLEDoseActor::UserSteppingActionInVoxel(const int index, const G4Step *step) {
+  UserSteppingActionInVoxelSegment(index, step, step->GetStepLength());
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// 'distance' is the part of the step length inside the voxel (the whole
+// step unless the step hit type is 'traversal')
+void GateTLEDoseActor::UserSteppingActionInVoxelSegment(const int index, const G4Step *step, const G4double distance) {
   G4StepPoint *PreStep(step->GetPreStepPoint());
   G4StepPoint *PostStep(step->GetPostStepPoint());
   G4ThreeVector prePosition = PreStep->GetPosition();
@@ -198,7 +211,6 @@ void GateTLEDoseActor::UserSteppingActionInVoxel(const int index, const G4Step *
         (mMaterialFilter != "" && mMaterialFilter != step->GetPreStepPoint()->GetMaterial()->GetName()))
       return;
 
-    double distance = step->GetStepLength();
     double energy = PreStep->GetKineticEnergy();
     double muenOverRho = mMaterialHandler->GetMuEnOverRho(PreStep->GetMaterialCutsCouple(), energy);
     double dose = ConversionFactor * energy * muenOverRho * distance / VoxelVolume;
@@ -222,7 +234,8 @@ void GateTLEDoseActor::UserSteppingActionInVoxel(const int index, const G4Step *
     }
 
     if (energy <= .001) {
-      edep = energy;
+      // the remaining energy is shared among the voxels crossed by the step
+      edep = (step->GetStepLength() > 0) ? energy * distance / step->GetStepLength() : energy;
       step->GetTrack()->SetTrackStatus(fStopAndKill);
     }
 
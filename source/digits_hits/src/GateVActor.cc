@@ -38,6 +38,8 @@ GateVActor::GateVActor(G4String name, G4int depth)
   mVolume = 0;
   EnableSaveEveryNEvents(0);
   EnableSaveEveryNSeconds(0);
+  EnableAsyncSave(false);
+  mAsyncSaveRunning = false;
   mNumOfFilters = 0;
   mOverWriteFilesFlag = true;
   pFilterManager = new GateFilterManager(GetObjectName()+"_filter");
@@ -50,6 +52,7 @@ GateVActor::GateVActor(G4String name, G4int depth)
 GateVActor::~GateVActor()
 {
   GateDebugMessageInc("Actor",4,"~GateVActor() -- begin\n");
+  WaitForAsyncSave();
   delete pFilterManager;
   GateDebugMessageDec("Actor",4,"~GateVActor() -- end\n");
 }
@@ -84,9 +87,15 @@ void GateVActor::EndOfEventAction(const G4Event*e)
 {
   int ne = e->GetEventID()+1;
 
+  // Release a finished save (and print its messages)
+  if (mAsyncSaveThread.joinable() && !mAsyncSaveRunning) WaitForAsyncSave();
+
   // Save every n events
   if ((ne != 0) && (mSaveEveryNEvents != 0))
-    if (ne % mSaveEveryNEvents == 0)  SaveData();
+    if (ne % mSaveEveryNEvents == 0) {
+      if (mIsAsyncSaveEnabled) SaveDataAsync();
+      else SaveData();
+    }
 
   // Save every n seconds
   if (mSaveEveryNSeconds != 0) { // need to check time
@@ -95,7 +104,8 @@ void GateVActor::EndOfEventAction(const G4Event*e)
     long seconds  = end.tv_sec  - mTimeOfLastSaveEvent.tv_sec;
     if (seconds > mSaveEveryNSeconds) {
       //GateMessage("Core", 0, "Actor " << GetName() << " : " << mSaveEveryNSeconds << " seconds.\n");
-      SaveData();
+      if (mIsAsyncSaveEnabled) SaveDataAsync();
+      else SaveData();
       mTimeOfLastSaveEvent = end;
     }
   }
@@ -128,8 +138,39 @@ void GateVActor::AttachToVolume(G4String /*volumeName*/)
 //-----------------------------------------------------------------------------
 void GateVActor::SaveData()
 {
+  WaitForAsyncSave();
   if (!this->mOverWriteFilesFlag) {
     mSaveFilename = GetSaveCurrentFilename(mSaveInitialFilename);
   }
 }
 //-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateVActor::StartAsyncSave(std::function<void()> f)
+{
+  WaitForAsyncSave(); // previous thread is finished, release it
+  mAsyncSaveRunning = true;
+  // The standard output is not thread safe: the messages of the save
+  // are kept and printed by this thread once it is over
+  mAsyncSaveThread = std::thread([this, f]() {
+      GateMessageManager::SetThreadStream(&mAsyncSaveLog);
+      f();
+      GateMessageManager::SetThreadStream(0);
+      mAsyncSaveRunning = false;
+    });
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateVActor::WaitForAsyncSave()
+{
+  if (!mAsyncSaveThread.joinable()) return;
+  mAsyncSaveThread.join();
+  if (!mAsyncSaveLog.str().empty()) {
+    GateMessageManager::GetStream() << mAsyncSaveLog.str();
+    mAsyncSaveLog.str("");
+  }
+}
+//-----------------------------------------------------------------------------
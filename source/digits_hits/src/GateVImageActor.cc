@@ -215,6 +215,11 @@ void GateVImageActor::Construct()
   GateMessage("Actor", 3, "GateVImageActor -- Construct(): voxelsize = " << mVoxelSize << Gateendl);
   GateMessage("Actor", 3, "GateVImageActor -- Construct(): hitType   = " << mStepHitTypeName << Gateendl);
 
+  if (mStepHitType == TraversalStepHitType && !IsVoxelTraversalSupported()) {
+    GateError("GateVImageActor -- Construct: the actor '" << GetObjectName()
+              << "' does not support the 'traversal' step hit type.");
+  }
+
   GateDebugMessageDec("Actor", 4, "GateVImageActor -- Construct: end\n");
 
 }
@@ -261,8 +266,9 @@ void GateVImageActor::SetStepHitType(G4String t)
   if (t == "random") { mStepHitType = RandomStepHitType; return; }
   if (t == "randomCylindricalCS") { mStepHitType = RandomStepHitTypeCylindricalCS; return;}
   if (t == "postCylindricalCS") { mStepHitType = PostStepHitTypeCylindricalCS; return;}
+  if (t == "traversal") { mStepHitType = TraversalStepHitType; return;}
 
-  GateError("GateVImageActor -- SetStepHitType: StepHitType is set to '" << t << "' while I only know 'pre', 'post', 'random' or 'middle'.");
+  GateError("GateVImageActor -- SetStepHitType: StepHitType is set to '" << t << "' while I only know 'pre', 'post', 'random', 'middle' or 'traversal'.");
 }
 //-----------------------------------------------------------------------------
 
@@ -311,6 +317,12 @@ void GateVImageActor::UserSteppingAction(const GateVVolume* , const G4Step * ste
 if (custmframe)
 
 else*/
+  if (mStepHitType == TraversalStepHitType) {
+    GetVoxelSegmentsFromStep(GetVolume(), step, mVoxelSegments);
+    for(unsigned int i=0; i<mVoxelSegments.size(); i++)
+      UserSteppingActionInVoxelSegment(mVoxelSegments[i].first, step, mVoxelSegments[i].second);
+    return;
+  }
   int index = GetIndexFromStepPosition(GetVolume(), step);
   UserSteppingActionInVoxel(index, step);
 }
@@ -368,14 +380,14 @@ int GateVImageActor::GetIndexFromStepPosition(const GateVVolume * v, const G4Ste
 
 
 //-----------------------------------------------------------------------------
-int GateVImageActor::GetIndexFromStepPosition2(const GateVVolume * v,
+bool GateVImageActor::GetStepPositionsInVolume(const GateVVolume * v,
                                                const G4Step * step,
-                                               const GateImage & image,
                                                const bool mPositionIsSet,
                                                const G4ThreeVector mPosition,
-                                               const StepHitType mStepHitType)
+                                               G4ThreeVector & prePosition,
+                                               G4ThreeVector & postPosition)
 {
-  if(v==0) return -1;
+  if(v==0) return false;
 
   const G4ThreeVector & worldPos = step->GetPostStepPoint()->GetPosition();
   const G4ThreeVector & worldPre =  step->GetPreStepPoint()->GetPosition() ;
@@ -400,12 +412,12 @@ int GateVImageActor::GetIndexFromStepPosition2(const GateVVolume * v,
       currentVol = theTouchable->GetVolume(depth)->GetLogicalVolume();
     }
 
-  if(depth>=maxDepth) return -1;
+  if(depth>=maxDepth) return false;
 
   GateDebugMessage("Step",3,"GateVImageActor -- GetIndexFromStepPosition: Logical volume "<<currentVol->GetName() <<" found! - Depth = "<<depth << Gateendl );
 
-  G4ThreeVector postPosition = theTouchable->GetHistory()->GetTransform(transDepth).TransformPoint(worldPos);
-  G4ThreeVector prePosition = theTouchable->GetHistory()->GetTransform(transDepth).TransformPoint(worldPre);
+  postPosition = theTouchable->GetHistory()->GetTransform(transDepth).TransformPoint(worldPos);
+  prePosition = theTouchable->GetHistory()->GetTransform(transDepth).TransformPoint(worldPre);
 
   if (mPositionIsSet) {
     GateDebugMessage("Step", 3, "GateVImageActor -- GetIndexFromStepPosition: Step postPosition (vol reference) = " << postPosition << Gateendl);
@@ -414,6 +426,22 @@ int GateVImageActor::GetIndexFromStepPosition2(const GateVVolume * v,
     prePosition -= mPosition;
     postPosition -= mPosition;
   }
+  return true;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+int GateVImageActor::GetIndexFromStepPosition2(const GateVVolume * v,
+                                               const G4Step * step,
+                                               const GateImage & image,
+                                               const bool mPositionIsSet,
+                                               const G4ThreeVector mPosition,
+                                               const StepHitType mStepHitType)
+{
+  G4ThreeVector prePosition;
+  G4ThreeVector postPosition;
+  if (!GetStepPositionsInVolume(v, step, mPositionIsSet, mPosition, prePosition, postPosition)) return -1;
 
   GateDebugMessage("Step", 2, "GateVImageActor -- GetIndexFromStepPosition:Actor  UserSteppingAction (type = " << mStepHitTypeName << ")\n"
 		   << "\tPreStep     = " << prePosition << Gateendl
@@ -432,7 +460,8 @@ int GateVImageActor::GetIndexFromStepPosition2(const GateVVolume * v,
     G4ThreeVector direction = postPosition - prePosition;
     index = image.GetIndexFromPostPositionAndDirection(postPosition, direction);
   }
-  if (mStepHitType == MiddleStepHitType) {
+  // Traversal type: callers asking for a single voxel get the middle one
+  if (mStepHitType == MiddleStepHitType || mStepHitType == TraversalStepHitType) {
     G4ThreeVector middle = prePosition + postPosition;
     middle/=2.;
     GateDebugMessage("Step", 4, "GateVImageActor -- GetIndexFromStepPosition:\tMiddleStep  = " << middle << Gateendl);
@@ -469,4 +498,19 @@ int GateVImageActor::GetIndexFromStepPosition2(const GateVVolume * v,
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateVImageActor::GetVoxelSegmentsFromStep(const GateVVolume * v, const G4Step * step,
+                                               std::vector<std::pair<int, G4double> > & segments)
+{
+  G4ThreeVector prePosition;
+  G4ThreeVector postPosition;
+  if (!GetStepPositionsInVolume(v, step, mPositionIsSet, mPosition, prePosition, postPosition)) {
+    segments.clear();
+    return;
+  }
+  mImage.GetVoxelSegments(prePosition, postPosition, segments);
+}
+//-----------------------------------------------------------------------------
+
+
 #endif /* end #define GATEVIMAGEACTOR_CC */
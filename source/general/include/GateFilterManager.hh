@@ -41,6 +41,12 @@ public:
 
   void AddFilter(GateVFilter* filter){theFilters.push_back(filter);}
   G4int GetNumberOfFilters(){return theFilters.size();}
+
+  /// Resolve the configuration of all filters (called at BeginOfRun)
+  void Initialize();
+  /// Concatenated filter signatures; empty if one filter cannot be shared
+  G4String GetSignature() const;
+  void SetShared(G4bool b);
   void show();
 
 protected:
@@ -51,13 +51,16 @@ public:
   void Reset();
   void MapLabelToMaterial(LabelToMaterialNameType & m);
   double GetHMeanFromLabel(int l);
-  LabelType GetLabelFromH(double h);
+  /// Label of the last material with H1<=h (binary search when the
+  /// materials were added with increasing H1). Thread safe (read only).
+  LabelType GetLabelFromH(double h) const;
 
   GateMaterialsVector GetMaterials() { return mMaterialsVector; }
   inline mMaterials & operator[](int index){ return mMaterialsVector[index];}
 
 protected:
   GateMaterialsVector mMaterialsVector;
+  bool mIsSortedByH1;
 
 };
 #endif
@@ -0,0 +1,106 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+#ifndef GATEIMAGECOPYONWRITE_HH
+#define GATEIMAGECOPYONWRITE_HH
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+
+#include "GateImage.hh"
+
+/*! \class  GateImageCopyOnWrite
+    \brief  Copy of images taken at one instant by another thread, while the owner keeps changing them
+
+    - The images (all of the same size) are split in blocks of kBlockSize voxels. The copying
+      thread copies each block from the image; the owner calls CopyBeforeWrite before changing
+      a voxel, which saves the block aside if it was not copied yet. Either way, the copy holds
+      the values at the time the images were added.
+    - Taking the copy costs the owner nothing up front, and at most one block copy per
+      block changed while the copy is in progress.
+    - Once every block is copied (IsComplete), the images are free again.
+*/
+class GateImageCopyOnWrite
+{
+public:
+  GateImageCopyOnWrite(int nbOfValues);
+
+  //! Adds an image and the image that will receive its copy (its geometry is set here,
+  //! its data is allocated by CopyImages). Images are added before any copy starts.
+  template<class PixelType>
+  void AddImage(GateImageT<PixelType> & image, GateImageT<PixelType> & copy) {
+    static_cast<GateVImage&>(copy) = image;
+    mImages.push_back(std::unique_ptr<ImageCopy>(new TypedImageCopy<PixelType>(image, copy, mNbOfBlocks)));
+  }
+
+  //! Owner side: to call before changing the voxel index of one of the images
+  inline void CopyBeforeWrite(int index) {
+    int block = index/kBlockSize;
+    if (!mIsCopied[block].load(std::memory_order_acquire)) SaveBlock(block);
+  }
+  //! Owner side: to call before changing (or deleting) the images as a whole
+  void CopyAllBeforeWrite();
+  inline bool IsComplete() const { return mNbOfCopiedBlocks.load(std::memory_order_acquire) == mNbOfBlocks; }
+
+  //! Owner side helpers: the copy-on-write is released once complete
+  static inline void BeforeWrite(std::shared_ptr<GateImageCopyOnWrite> & c, int index) {
+    if (c) { c->CopyBeforeWrite(index); if (c->IsComplete()) c.reset(); }
+  }
+  static inline void BeforeWriteAll(std::shared_ptr<GateImageCopyOnWrite> & c) {
+    if (c) { c->CopyAllBeforeWrite(); c.reset(); }
+  }
+
+  //! Copying side: allocates the copies (if needed) and fills them
+  void CopyImages();
+
+  static const int kBlockSize = 4096;
+
+protected:
+  void SaveBlock(int block);
+
+  struct ImageCopy {
+    virtual ~ImageCopy() {}
+    virtual void AllocateCopy() = 0;
+    virtual void SaveBlock(int block, int first, int last) = 0;  //!< owner: image -> saved block
+    virtual void CopyBlock(int block, int first, int last) = 0;  //!< copying thread: image or saved block -> copy
+  };
+
+  template<class PixelType>
+  struct TypedImageCopy : public ImageCopy {
+    TypedImageCopy(GateImageT<PixelType> & i, GateImageT<PixelType> & c, int nbOfBlocks)
+      : image(i), copy(c), saved(nbOfBlocks) {}
+    virtual void AllocateCopy() { if (copy.begin() == copy.end()) copy.Allocate(); }
+    virtual void SaveBlock(int block, int first, int last) {
+      saved[block].reset(new PixelType[last-first]);
+      std::copy(image.begin()+first, image.begin()+last, saved[block].get());
+    }
+    virtual void CopyBlock(int block, int first, int last) {
+      if (saved[block]) {
+        std::copy(saved[block].get(), saved[block].get()+(last-first), copy.begin()+first);
+        saved[block].reset();
+      }
+      else std::copy(image.begin()+first, image.begin()+last, copy.begin()+first);
+    }
+    GateImageT<PixelType> & image;
+    GateImageT<PixelType> & copy;
+    std::vector<std::unique_ptr<PixelType[]> > saved;
+  };
+
+  int mNbOfValues;
+  int mNbOfBlocks;
+  std::vector<std::unique_ptr<ImageCopy> > mImages;
+  std::unique_ptr<std::atomic<bool>[]> mIsCopied;  //!< block copied, or saved aside by the owner
+  std::atomic<int> mNbOfCopiedBlocks;
+  std::mutex mMutex;
+};
+
+#endif
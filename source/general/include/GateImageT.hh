@@ -57,6 +57,9 @@ public:
   /// Allocates the data
   virtual void Allocate();
 
+  /// Releases the data, the image geometry is kept
+  void Deallocate() { std::vector<PixelType>().swap(data); }
+
   // Access to the image values
   /// Returns the value of the image at voxel of index provided
   inline PixelType GetValue(int index) const { return data[index]; }
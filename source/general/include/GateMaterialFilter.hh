@@ -17,6 +17,10 @@ See LICENSE.md for further details
 #include "GateActorManager.hh"
 #include "GateMaterialFilterMessenger.hh"
 
+#include "G4Material.hh"
+
+#include <unordered_map>
+
 class  GateMaterialFilter : 
   public GateVFilter
 {
@@ -29,10 +33,19 @@ public:
   virtual G4bool Accept(const G4Step*);
   virtual G4bool Accept(const G4Track*);
   void Add(const G4String& materialName);
+
+  virtual void Initialize();
+  virtual G4String GetSignature() const;
   virtual void show();
 
 private:
  std::vector<G4String> theMdef;
+
+ // Result of the name test cached per material pointer
+ G4bool AcceptMaterial(const G4Material *);
+ std::unordered_map<const G4Material*, G4bool> mMaterialCache;
+ const G4Material * mLastMaterial;
+ G4bool mLastMaterialAccepted;
  GateMaterialFilterMessenger * pMatMessenger;
  
  int nFilteredParticles;
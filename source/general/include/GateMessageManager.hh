@@ -173,7 +173,7 @@ See LICENSE.md for further details
   do {						\
     GateOnMessageLevel(key,value)		\
       {						\
-	std::cout << GateMessageCode(key,value)	\
+	GateMessageManager::GetStream() << GateMessageCode(key,value)	\
 		  << GateMessageSpace(value)	\
 		  << MESSAGE;			\
       }						\
@@ -188,7 +188,7 @@ See LICENSE.md for further details
     {						\
       GateOnMessageLevel(key,value)		\
 	{					\
-	  std::cout << MESSAGE;			\
+	  GateMessageManager::GetStream() << MESSAGE;			\
 	}					\
     }						\
   while (0)
@@ -198,7 +198,7 @@ See LICENSE.md for further details
     {						\
       GateOnMessageLevel(key,value)		\
 	{					\
-	  std::cout << GateMessageCode(key,value)	\
+	  GateMessageManager::GetStream() << GateMessageCode(key,value)	\
 		    << GateMessageSpace(value)	\
 		    << MESSAGE;			\
 	  GateMessageManager::IncTab();		\
@@ -212,7 +212,7 @@ See LICENSE.md for further details
       GateOnMessageLevel(key,value)		\
 	{					\
 	  GateMessageManager::DecTab();		\
-	  std::cout << GateMessageCode(key,value)	\
+	  GateMessageManager::GetStream() << GateMessageCode(key,value)	\
 		    << GateMessageSpace(value)	\
 		    << MESSAGE;			\
 	}					\
@@ -267,7 +267,7 @@ See LICENSE.md for further details
     {							\
       GateOnMessageLevel(key,value)			\
 	{						\
-	  std::cout << GateDebugMessageCode(key,value)	\
+	  GateMessageManager::GetStream() << GateDebugMessageCode(key,value)	\
 		    << GateMessageSpace(value)		\
 		    << MESSAGE;				\
 	}						\
@@ -282,7 +282,7 @@ See LICENSE.md for further details
     {						\
       GateOnMessageLevel(key,value)		\
 	{					\
-	  std::cout << MESSAGE;			\
+	  GateMessageManager::GetStream() << MESSAGE;			\
 	}					\
     }						\
   while (0)
@@ -292,7 +292,7 @@ See LICENSE.md for further details
     {						\
       GateOnMessageLevel(key,value)		\
 	{					\
-	  std::cout << GateDebugMessageCode(key,value)	\
+	  GateMessageManager::GetStream() << GateDebugMessageCode(key,value)	\
 		    << GateMessageSpace(value)	\
 		    << MESSAGE;			\
 	  GateMessageManager::IncTab();		\
@@ -306,7 +306,7 @@ See LICENSE.md for further details
       GateOnMessageLevel(key,value)		\
 	{					\
 	  GateMessageManager::DecTab();		\
-	  std::cout << GateDebugMessageCode(key,value)	\
+	  GateMessageManager::GetStream() << GateDebugMessageCode(key,value)	\
 		    << GateMessageSpace(value)	\
 		    << MESSAGE;			\
 	}					\
@@ -361,10 +361,10 @@ See LICENSE.md for further details
       int lev = GateMessageManager::GetMessageLevel("Warning");		\
       if (lev >0)							\
 	{								\
-	  std::cout << " <!> *** WARNING *** <!>  " << MESSAGE << Gateendl; \
+	  GateMessageManager::GetStream() << " <!> *** WARNING *** <!>  " << MESSAGE << Gateendl; \
 	  if (lev >1)							\
 	    {								\
-	      std::cout << " <!> *** WARNING *** <!>  In file '"<<__FILE__ \
+	      GateMessageManager::GetStream() << " <!> *** WARNING *** <!>  In file '"<<__FILE__ \
 			<<"' ; Line "<<__LINE__<< Gateendl;		\
 	    }								\
 	}								\
@@ -452,6 +452,12 @@ public:
   static void IncTab() { GetTab() += std::string("   "); }
   static void DecTab() { GetTab() = GetTab().substr(0,GetTab().length()-3); }
   static void ResetTab() { GetTab() = std::string(""); }
+  // Stream of the messages of the calling thread. A thread that must not write
+  // to the standard output (background save) sets its own stream, which the main
+  // thread prints later.
+  static std::ostream& GetStream() { return GetThreadStream() ? *GetThreadStream() : std::cout; }
+  static void SetThreadStream(std::ostream* s) { GetThreadStream() = s; }
+  static std::ostream*& GetThreadStream() { static thread_local std::ostream* s = 0; return s; }
   static void PrintInfo();
 
   // the two follwing are overrided from G4UIsession to intercept
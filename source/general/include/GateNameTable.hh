@@ -0,0 +1,45 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+
+#ifndef GateNameTable_h
+#define GateNameTable_h 1
+
+#include "globals.hh"
+#include <deque>
+#include <unordered_map>
+
+/*! \class  GateNameTable
+    \brief  Process-wide table interning names (volumes, processes) as small integer IDs
+
+    - The table is used by objects that are copied many times (pulses, hits) to store
+      names as a G4int: copying the object then does not copy (nor allocate) any string.
+    - ID 0 is always the empty string, so that a zero-initialised ID is a valid name.
+    - Names are never removed: the table only grows with the number of distinct names
+      (volume and process names), which is small.
+*/
+class GateNameTable
+{
+public:
+  //! Returns the ID of a name, registering it if it is not known yet
+  static G4int GetID(const G4String& name);
+
+  //! Returns the name corresponding to an ID (the reference stays valid for the whole run)
+  static inline const G4String& GetName(G4int id)
+  { return GetNames()[id]; }
+
+  //! Returns the number of registered names
+  static inline size_t GetSize()
+  { return GetNames().size(); }
+
+private:
+  static std::deque<G4String>& GetNames();
+  static std::unordered_map<std::string,G4int>& GetIDs();
+};
+
+#endif
@@ -26,6 +26,8 @@ See LICENSE.md for further details
 #include "G4ParticleTable.hh"
 #include "G4ParticleDefinition.hh"
 
+#include <unordered_map>
+
 class  GateParticleFilter :
   public GateVFilter
 {
@@ -45,6 +47,10 @@ public:
   void AddDirectParent(const G4String &particleName);
   // add the particle into acceptable particle list.
   //
+
+  virtual void Initialize();
+  virtual G4String GetSignature() const;
+
   virtual void show();
 
 private:
@@ -54,6 +60,16 @@ private:
   std::vector<G4int> thePdefPDG;
   std::vector<G4String> theParentPdef;
   std::vector<G4String> theDirectParentPdef;
+
+  // Name/Z/A/PDG tests only depend on the particle definition: their
+  // result is cached per definition pointer (ions are added on the fly)
+  G4bool AcceptDefinition(const G4ParticleDefinition *) const;
+  G4bool AcceptParent(const G4Track *) const;
+  G4bool AcceptDirectParent(const G4Track *) const;
+  std::unordered_map<const G4ParticleDefinition*, G4bool> mDefinitionCache;
+  const G4ParticleDefinition * mLastDefinition;
+  G4bool mLastDefinitionAccepted;
+
   GateParticleFilterMessenger *pPartMessenger;
 
   int nFilteredParticles;
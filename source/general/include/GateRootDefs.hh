@@ -69,6 +69,7 @@ class GateRootHitBuffer
     void Clear();     	      	      	      	  //!< Reset the fields of the structure
     void Fill(GateCrystalHit* aHit);
     GateCrystalHit* CreateHit();
+    void FillHit(GateCrystalHit* aHit);   //!< Same as CreateHit(), into an existing hit
 
     //! \name getters and setters for unit-dependent fields
     //@{
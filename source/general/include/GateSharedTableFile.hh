@@ -0,0 +1,85 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+
+#ifndef GateSharedTableFile_h
+#define GateSharedTableFile_h 1
+
+#include "globals.hh"
+#include <vector>
+#include <stdint.h>
+
+/*! \class  GateSharedTableFile
+    \brief  Read-only, memory-mapped file holding precomputed tables shared by several processes
+
+    - The file is a small header (magic, format version, hash, payload size) followed by
+      the payload. The hash is computed by the owner of the tables from everything the
+      tables depend on (material database, options): a file built with other inputs is
+      ignored and the tables are rebuilt.
+    - Attach() maps the file read-only and shared: all the processes of a node that
+      attach to the same file share the same physical pages, so the tables are loaded
+      once per node instead of once per process.
+    - Write() writes a temporary file and renames it, so that a process never attaches
+      to a partially written file, even if several processes build the tables at once.
+    - The payload starts on a page boundary: arrays of doubles can be used in place.
+    - Used for the mu/muen tables (GateMaterialMuHandler) and the fictitious cross sections
+      tables (GateTotalDiscreteProcess). Image volumes are not shared: GateImageT owns its
+      voxels in a std::vector, and the CT is rewritten in place after reading (margin,
+      HU to label conversion).
+*/
+class GateSharedTableFile
+{
+public:
+  GateSharedTableFile();
+  ~GateSharedTableFile();
+
+  //! Maps the file; returns false (and maps nothing) if it does not exist or if its
+  //! format version or hash differ
+  bool Attach(const G4String& fileName, uint64_t hash, uint32_t version);
+  void Detach();
+  bool IsAttached() const { return mData != 0; }
+
+  const char* GetPayload() const { return mPayload; }
+  uint64_t GetPayloadSize() const { return mPayloadSize; }
+
+  //! Writes a file that can be attached with the same hash and version; returns false on failure
+  static bool Write(const G4String& fileName, uint64_t hash, uint32_t version,
+                    const std::vector<char>& payload);
+
+  //! 64-bit FNV-1a hash, to be fed with the inputs of the tables
+  class Hash {
+  public:
+    Hash() : mValue(14695981039346656037ULL) {}
+    void Add(const void* data, size_t size);
+    void Add(const G4String& s) { Add(s.data(), s.size()); Add(uint64_t(s.size())); }
+    void Add(double x) { Add(&x, sizeof(x)); }
+    void Add(uint64_t x) { Add(&x, sizeof(x)); }
+    void Add(int x) { Add(&x, sizeof(x)); }
+    uint64_t GetValue() const { return mValue; }
+  private:
+    uint64_t mValue;
+  };
+
+private:
+  struct Header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t hash;
+    uint64_t payloadSize;
+  };
+  static const char* GetMagic() { return "GATETAB"; }
+  static size_t GetPayloadOffset();
+
+  void* mData;
+  size_t mSize;
+  const char* mPayload;
+  uint64_t mPayloadSize;
+};
+
+#endif
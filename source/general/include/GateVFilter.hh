@@ -37,10 +37,18 @@ public:
   virtual G4bool Accept(const G4Step*);
   virtual G4bool Accept(const G4Track*);
 
+  /// Resolve the filter configuration (names -> pointers) before tracking
+  virtual void Initialize() {}
+  /// Key describing the configuration; two filters with the same non-empty
+  /// signature always return the same result. Empty means "do not share".
+  virtual G4String GetSignature() const { return ""; }
+  /// Set when the result of this filter is taken from an identical filter
+  void SetShared(G4bool b) { mIsShared = b; }
  
   virtual void show();
 
- 
+protected:
+  G4bool mIsShared;
 
 private:
 
@@ -131,6 +131,13 @@ public:
   int GetIndexFromPostPosition(const double t, const double pret, const double postt, const double resolutiont) const;
   int GetIndexFromPrePosition(const double t, const double pret, const double postt, const double resolutiont) const;
 
+  // Walks the straight segment [start,end] through the voxels it
+  // crosses (Amanatides & Woo traversal) and fills 'segments' with the
+  // index and the length of the segment inside each voxel. The part of
+  // the segment outside the image is ignored.
+  void GetVoxelSegments(const G4ThreeVector & start, const G4ThreeVector & end,
+                        std::vector<std::pair<int, G4double> > & segments) const;
+
   // Returns the (integer) coordinates of the voxel in which the point is : OK
   G4ThreeVector GetCoordinatesFromPosition(const G4ThreeVector & position);
   // Returns the (integer) coordinates of the voxel in which the point is : OK
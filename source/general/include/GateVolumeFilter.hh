@@ -41,7 +41,8 @@ public:
 
   virtual void show();
 
-  void Initialize();
+  virtual void Initialize();
+  virtual G4String GetSignature() const;
 
 private:
 
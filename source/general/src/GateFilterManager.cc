@@ -69,6 +69,35 @@ G4bool GateFilterManager::Accept(const G4Track* aTrack) const
 
 
 
+//---------------------------------------------------------------------------
+void GateFilterManager::Initialize()
+{
+  for(unsigned int i = 0;i<theFilters.size();i++)
+    theFilters[i]->Initialize();
+}
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+G4String GateFilterManager::GetSignature() const
+{
+  G4String signature;
+  for(unsigned int i = 0;i<theFilters.size();i++) {
+    G4String s = theFilters[i]->GetSignature();
+    if (s == "") return "";
+    signature += s + "|";
+  }
+  return signature;
+}
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+void GateFilterManager::SetShared(G4bool b)
+{
+  for(unsigned int i = 0;i<theFilters.size();i++)
+    theFilters[i]->SetShared(b);
+}
+//---------------------------------------------------------------------------
+
 //---------------------------------------------------------------------------
 void GateFilterManager::show(){
   G4cout << "------Filter Manager: "<<mFilterName<<" ------\n";
@@ -18,9 +18,12 @@
 #include "GateMiscFunctions.hh"
 #include "G4UnitsTable.hh"
 
+#include <algorithm>
+
 //-----------------------------------------------------------------------------
 GateHounsfieldMaterialTable::GateHounsfieldMaterialTable()
 {
+  mIsSortedByH1 = true;
 }
 //-----------------------------------------------------------------------------
 
@@ -61,6 +64,7 @@ void GateHounsfieldMaterialTable::AddMaterial(double H1, double H2, double d,
   }
 
   // Set material
+  if (!mMaterialsVector.empty() && H1 < mMaterialsVector.back().mH1) mIsSortedByH1 = false;
   mMaterialsVector.push_back(mat);
 }
 //-----------------------------------------------------------------------------
@@ -118,6 +122,7 @@ void GateHounsfieldMaterialTable::AddMaterial(double H1, double H2, G4String nam
   mat.mName = name;
   mat.mMaterial = theMaterialDatabase.GetMaterial(name);
   mat.md1=mat.mMaterial->GetDensity();
+  if (!mMaterialsVector.empty() && H1 < mMaterialsVector.back().mH1) mIsSortedByH1 = false;
   mMaterialsVector.push_back(mat);
   GateMessage("Actor",3,H1 << " " << H2 << " " << name);
 }
@@ -131,6 +136,7 @@ void GateHounsfieldMaterialTable::Reset()
       it = mMaterialsVector.erase(it);
     }
   mMaterialsVector.clear();
+  mIsSortedByH1 = true;
 }
 //-----------------------------------------------------------------------------
 
@@ -154,12 +160,22 @@ void GateHounsfieldMaterialTable::MapLabelToMaterial(LabelToMaterialNameType & m
 //-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
-GateHounsfieldMaterialTable::LabelType GateHounsfieldMaterialTable::GetLabelFromH(double h)
+static bool HIsLowerThanH1(double h, const GateHounsfieldMaterialTable::mMaterials & m)
+{
+  return h < m.mH1;
+}
+
+GateHounsfieldMaterialTable::LabelType GateHounsfieldMaterialTable::GetLabelFromH(double h) const
 {
+  int n = mMaterialsVector.size();
   int i=0;
-  while ((i<GetNumberOfMaterials() && h>=mMaterialsVector[i].mH1)) i++;
+  // i = index of the first material with H1 > h
+  if (mIsSortedByH1)
+    i = std::upper_bound(mMaterialsVector.begin(), mMaterialsVector.end(), h, HIsLowerThanH1) - mMaterialsVector.begin();
+  else
+    while ((i<n && h>=mMaterialsVector[i].mH1)) i++;
   i--;
-  if ((i==GetNumberOfMaterials()-1) && h>mMaterialsVector[i].mH2) return i+1;
+  if ((i>=0) && (i==n-1) && h>mMaterialsVector[i].mH2) return i+1;
   return i;
 }
 //-----------------------------------------------------------------------------
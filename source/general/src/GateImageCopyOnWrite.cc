@@ -0,0 +1,64 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GateImageCopyOnWrite.hh"
+
+//-----------------------------------------------------------------------------
+GateImageCopyOnWrite::GateImageCopyOnWrite(int nbOfValues)
+  : mNbOfValues(nbOfValues),
+    mNbOfBlocks((nbOfValues+kBlockSize-1)/kBlockSize),
+    mIsCopied(new std::atomic<bool>[(nbOfValues+kBlockSize-1)/kBlockSize]),
+    mNbOfCopiedBlocks(0)
+{
+  for(int b=0; b<mNbOfBlocks; b++) mIsCopied[b].store(false, std::memory_order_relaxed);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageCopyOnWrite::SaveBlock(int block)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (mIsCopied[block].load(std::memory_order_relaxed)) return; // copied in the meantime
+  int first = block*kBlockSize;
+  int last = std::min(first+kBlockSize, mNbOfValues);
+  for(size_t i=0; i<mImages.size(); i++) mImages[i]->SaveBlock(block, first, last);
+  mIsCopied[block].store(true, std::memory_order_release);
+  ++mNbOfCopiedBlocks;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageCopyOnWrite::CopyAllBeforeWrite()
+{
+  for(int b=0; b<mNbOfBlocks; b++)
+    if (!mIsCopied[b].load(std::memory_order_acquire)) SaveBlock(b);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageCopyOnWrite::CopyImages()
+{
+  for(size_t i=0; i<mImages.size(); i++) mImages[i]->AllocateCopy();
+
+  // Each block comes from the image if the owner did not change it yet,
+  // otherwise from the block it saved aside
+  for(int b=0; b<mNbOfBlocks; b++) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    int first = b*kBlockSize;
+    int last = std::min(first+kBlockSize, mNbOfValues);
+    for(size_t i=0; i<mImages.size(); i++) mImages[i]->CopyBlock(b, first, last);
+    if (!mIsCopied[b].load(std::memory_order_relaxed)) {
+      mIsCopied[b].store(true, std::memory_order_release);
+      ++mNbOfCopiedBlocks;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
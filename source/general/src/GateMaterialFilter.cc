@@ -15,12 +15,16 @@ See LICENSE.md for further details
 #include "GateUserActions.hh"
 #include "GateTrajectory.hh"
 
+#include <algorithm>
+
 
 //---------------------------------------------------------------------------
 GateMaterialFilter::GateMaterialFilter(G4String name)
   :GateVFilter(name)
 {
   theMdef.clear();
+  mLastMaterial = 0;
+  mLastMaterialAccepted = false;
   pMatMessenger = new GateMaterialFilterMessenger(this);
   nFilteredParticles = 0;
 }
@@ -29,7 +33,7 @@ GateMaterialFilter::GateMaterialFilter(G4String name)
 //---------------------------------------------------------------------------
 GateMaterialFilter::~GateMaterialFilter()
 {
-  if(nFilteredParticles==0) GateWarning("No particle has been selected by filter: " << GetObjectName()); 
+  if(nFilteredParticles==0 && !mIsShared) GateWarning("No particle has been selected by filter: " << GetObjectName()); 
   delete pMatMessenger ;
 }
 //---------------------------------------------------------------------------
@@ -37,26 +41,62 @@ GateMaterialFilter::~GateMaterialFilter()
 //---------------------------------------------------------------------------
 G4bool GateMaterialFilter::Accept(const G4Step* aStep) 
 {
-    for ( size_t i = 0; i < theMdef.size(); i++){
-      if ( theMdef[i] == aStep->GetPreStepPoint()->GetMaterial()->GetName() ) {
-        nFilteredParticles++;
-        return true;
-      } 
-    }
-  return false;
+  return AcceptMaterial(aStep->GetPreStepPoint()->GetMaterial());
 }
 //---------------------------------------------------------------------------
 
 //---------------------------------------------------------------------------
 G4bool GateMaterialFilter::Accept(const G4Track* aTrack) 
 {
-    for ( size_t i = 0; i < theMdef.size(); i++){ 	
-      if ( theMdef[i] == aTrack->GetMaterial()->GetName() ) {
-        nFilteredParticles++;
-        return true;
-      } 
+  return AcceptMaterial(aTrack->GetMaterial());
+}
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+G4bool GateMaterialFilter::AcceptMaterial(const G4Material * mat)
+{
+  if (mat != mLastMaterial) {
+    std::unordered_map<const G4Material*, G4bool>::const_iterator it = mMaterialCache.find(mat);
+    if (it != mMaterialCache.end()) mLastMaterialAccepted = it->second;
+    else {
+      mLastMaterialAccepted = false;
+      for ( size_t i = 0; i < theMdef.size(); i++) {
+        if ( theMdef[i] == mat->GetName() ) {
+          mLastMaterialAccepted = true;
+          break;
+        }
+      }
+      mMaterialCache[mat] = mLastMaterialAccepted;
     }
-  return false;
+    mLastMaterial = mat;
+  }
+  if (mLastMaterialAccepted) nFilteredParticles++;
+  return mLastMaterialAccepted;
+}
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+void GateMaterialFilter::Initialize()
+{
+  // Resolve the material names into pointers; materials created later
+  // are added to the cache at first use.
+  mMaterialCache.clear();
+  mLastMaterial = 0;
+  mLastMaterialAccepted = false;
+  const G4MaterialTable * table = G4Material::GetMaterialTable();
+  for ( size_t m = 0; m < table->size(); m++ ) {
+    const G4Material * mat = (*table)[m];
+    mMaterialCache[mat] = (std::find(theMdef.begin(), theMdef.end(), mat->GetName()) != theMdef.end());
+  }
+}
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+G4String GateMaterialFilter::GetSignature() const
+{
+  G4String signature = "materialFilter";
+  for ( size_t i = 0; i < theMdef.size(); i++ ) signature += " " + theMdef[i];
+  return signature;
 }
 //---------------------------------------------------------------------------
 
@@ -67,6 +107,8 @@ void GateMaterialFilter::Add(const G4String& materialName)
     if ( theMdef[i] == materialName ) return;
   }
   theMdef.push_back(materialName);
+  mMaterialCache.clear();
+  mLastMaterial = 0;
 }
 //---------------------------------------------------------------------------
 
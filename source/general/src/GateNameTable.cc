@@ -0,0 +1,46 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+
+#include "GateNameTable.hh"
+
+//---------------------------------------------------------------------------
+G4int GateNameTable::GetID(const G4String& name)
+{
+  if (name.empty()) return 0;
+  std::unordered_map<std::string,G4int>& ids = GetIDs();
+  std::unordered_map<std::string,G4int>::const_iterator it = ids.find(name);
+  if (it != ids.end()) return it->second;
+
+  std::deque<G4String>& names = GetNames();
+  G4int id = names.size();
+  names.push_back(name);
+  ids[name] = id;
+  return id;
+}
+//---------------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------------
+// A deque is used so that references returned by GetName are not invalidated
+// when new names are registered
+std::deque<G4String>& GateNameTable::GetNames()
+{
+  static std::deque<G4String> names(1, G4String(""));
+  return names;
+}
+//---------------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------------
+std::unordered_map<std::string,G4int>& GateNameTable::GetIDs()
+{
+  static std::unordered_map<std::string,G4int> ids;
+  return ids;
+}
+//---------------------------------------------------------------------------
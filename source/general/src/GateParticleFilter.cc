@@ -9,11 +9,16 @@
 #include "GateUserActions.hh"
 #include "GateTrajectory.hh"
 
+#include <algorithm>
+#include <sstream>
+
 //---------------------------------------------------------------------------
 GateParticleFilter::GateParticleFilter(G4String name)
   : GateVFilter(name)
 {
   thePdef.clear();
+  mLastDefinition = 0;
+  mLastDefinitionAccepted = false;
   pPartMessenger = new GateParticleFilterMessenger(this);
   nFilteredParticles = 0;
 }
@@ -23,7 +28,7 @@ GateParticleFilter::GateParticleFilter(G4String name)
 //---------------------------------------------------------------------------
 GateParticleFilter::~GateParticleFilter()
 {
-  if (nFilteredParticles == 0) GateWarning("No particle has been selected by filter: " << GetObjectName());
+  if (nFilteredParticles == 0 && !mIsShared) GateWarning("No particle has been selected by filter: " << GetObjectName());
   delete pPartMessenger ;
 }
 //---------------------------------------------------------------------------
@@ -32,106 +37,132 @@ GateParticleFilter::~GateParticleFilter()
 //---------------------------------------------------------------------------
 G4bool GateParticleFilter::Accept(const G4Track *aTrack)
 {
-  std::vector<bool> acceptTemp;
+  // Name, Z, A and PDG tests (cached per particle definition)
+  const G4ParticleDefinition * def = aTrack->GetDefinition();
+  if (def != mLastDefinition) {
+    std::unordered_map<const G4ParticleDefinition*, G4bool>::const_iterator it =
+      mDefinitionCache.find(def);
+    if (it != mDefinitionCache.end()) mLastDefinitionAccepted = it->second;
+    else {
+      mLastDefinitionAccepted = AcceptDefinition(def);
+      mDefinitionCache[def] = mLastDefinitionAccepted;
+    }
+    mLastDefinition = def;
+  }
+  if (!mLastDefinitionAccepted) return false;
+
+  // Test the parent
+  if (!theParentPdef.empty() && !AcceptParent(aTrack)) return false;
+
+  // Test the directParent
+  if (!theDirectParentPdef.empty() && !AcceptDirectParent(aTrack)) return false;
 
+  // Keep the track !
+  nFilteredParticles++;
+  return true;
+}
+//---------------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------------
+G4bool GateParticleFilter::AcceptDefinition(const G4ParticleDefinition * def) const
+{
   // Test the particle name, keep the particle if the name is in the list
-  acceptTemp.push_back(true);
   if (!thePdef.empty()) {
-    acceptTemp.back()=false;
+    bool accept = false;
     for (size_t i = 0; i < thePdef.size(); i++) {
-      if (thePdef[i] == aTrack->GetDefinition()->GetParticleName() ||
-          (aTrack->GetDefinition()->GetParticleSubType() == "generic" && thePdef[i] == "GenericIon") ) {
-        nFilteredParticles++;
-        acceptTemp.back()=true;
+      if (thePdef[i] == def->GetParticleName() ||
+          (def->GetParticleSubType() == "generic" && thePdef[i] == "GenericIon") ) {
+        accept = true;
         break;
       }
     }
-  } // end thePdef !empty
-  if (!acceptTemp.back()) return false;
+    if (!accept) return false;
+  }
 
   // Test the particle Z, keep the particle if Z is in the list
-  acceptTemp.push_back(true);
-  if (!thePdefZ.empty()) {
-    acceptTemp.back()=false;
-    for (size_t i = 0; i < thePdefZ.size(); i++) {
-      if (thePdefZ[i] == aTrack->GetDefinition()->GetAtomicNumber()) {
-        nFilteredParticles++;
-        acceptTemp.back()=true;
-        break;
-      }
-    }
-  } // end thePdefZ !empty
-  if (!acceptTemp.back()) return false;
-
-  //// Test the particle A
-  acceptTemp.push_back(true);
-  if (!thePdefA.empty()) {
-    acceptTemp.back()=false;
-    for (size_t i = 0; i < thePdefA.size(); i++) {
-      if (thePdefA[i] == aTrack->GetDefinition()->GetAtomicMass()) {
-        nFilteredParticles++;
-        acceptTemp.back()=true;
-        break;
-      }
-    }
-  } // end thePdefA !empty
-  if (!acceptTemp.back()) return false;
+  if (!thePdefZ.empty() &&
+      std::find(thePdefZ.begin(), thePdefZ.end(), def->GetAtomicNumber()) == thePdefZ.end())
+    return false;
+
+  // Test the particle A
+  if (!thePdefA.empty() &&
+      std::find(thePdefA.begin(), thePdefA.end(), def->GetAtomicMass()) == thePdefA.end())
+    return false;
 
   // Test the particle PDG
-  acceptTemp.push_back(true);
-  if (!thePdefPDG.empty()) {
-    acceptTemp.back()=false;
-    for (size_t i = 0; i < thePdefPDG.size(); i++) {
-      if (thePdefPDG[i] == aTrack->GetDefinition()->GetPDGEncoding()) {
-        nFilteredParticles++;
-        acceptTemp.back()=true;
-        break;
-      }
-    }
-  } // end thePdefPFG !empty
-  if (!acceptTemp.back()) return false;
+  if (!thePdefPDG.empty() &&
+      std::find(thePdefPDG.begin(), thePdefPDG.end(), def->GetPDGEncoding()) == thePdefPDG.end())
+    return false;
 
-  // Test the parent
-  acceptTemp.push_back(true);
-  if (!theParentPdef.empty()) {
-    acceptTemp.back()=false;
-    GateTrackIDInfo * trackInfo =
-      GateUserActions::GetUserActions()->GetTrackIDInfo(aTrack->GetParentID());
-    while (trackInfo) {
-      for (size_t i = 0; i < theParentPdef.size(); i++) {
-        if (theParentPdef[i] == trackInfo->GetParticleName()) {
-          nFilteredParticles++;
-          acceptTemp.back()=true;
-          break;
-        }
-      }
-      if (acceptTemp.back() == true) break;
-      int id = trackInfo->GetParentID();
-      trackInfo = GateUserActions::GetUserActions()->GetTrackIDInfo(id);
-    }
-  } // end theParentPdef !empty
-  if (!acceptTemp.back()) return false;
+  return true;
+}
+//---------------------------------------------------------------------------
 
-  // Test the directParent
-  acceptTemp.push_back(true);
-  if (!theDirectParentPdef.empty()) {
-    acceptTemp.back()=false;
-    GateTrackIDInfo * trackInfo =
-      GateUserActions::GetUserActions()->GetTrackIDInfo(aTrack->GetParentID());
-    if (trackInfo) {
-      for (size_t i = 0; i < theDirectParentPdef.size(); i++) {
-        if (theDirectParentPdef[i] == trackInfo->GetParticleName()) {
-          nFilteredParticles++;
-          acceptTemp.back()=true;
-          break;
-        }
-      }
+
+//---------------------------------------------------------------------------
+G4bool GateParticleFilter::AcceptParent(const G4Track *aTrack) const
+{
+  GateTrackIDInfo * trackInfo =
+    GateUserActions::GetUserActions()->GetTrackIDInfo(aTrack->GetParentID());
+  while (trackInfo) {
+    const G4String & name = trackInfo->GetParticleName();
+    for (size_t i = 0; i < theParentPdef.size(); i++) {
+      if (theParentPdef[i] == name) return true;
     }
-  } // end theDirectParentPdef !empty
-  if (!acceptTemp.back()) return false;
+    int id = trackInfo->GetParentID();
+    trackInfo = GateUserActions::GetUserActions()->GetTrackIDInfo(id);
+  }
+  return false;
+}
+//---------------------------------------------------------------------------
 
-  // Keep the track !
-  return true;
+
+//---------------------------------------------------------------------------
+G4bool GateParticleFilter::AcceptDirectParent(const G4Track *aTrack) const
+{
+  GateTrackIDInfo * trackInfo =
+    GateUserActions::GetUserActions()->GetTrackIDInfo(aTrack->GetParentID());
+  if (!trackInfo) return false;
+  const G4String & name = trackInfo->GetParticleName();
+  for (size_t i = 0; i < theDirectParentPdef.size(); i++) {
+    if (theDirectParentPdef[i] == name) return true;
+  }
+  return false;
+}
+//---------------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------------
+void GateParticleFilter::Initialize()
+{
+  // Resolve all particles already known by the particle table; ions
+  // created during the run are added to the cache at first use.
+  mDefinitionCache.clear();
+  mLastDefinition = 0;
+  mLastDefinitionAccepted = false;
+  G4ParticleTable::G4PTblDicIterator * it = G4ParticleTable::GetParticleTable()->GetIterator();
+  it->reset();
+  while ((*it)()) {
+    const G4ParticleDefinition * def = it->value();
+    mDefinitionCache[def] = AcceptDefinition(def);
+  }
+}
+//---------------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------------
+G4String GateParticleFilter::GetSignature() const
+{
+  std::ostringstream oss;
+  oss << "particleFilter";
+  for (size_t i = 0; i < thePdef.size(); i++) oss << " n:" << thePdef[i];
+  for (size_t i = 0; i < thePdefZ.size(); i++) oss << " z:" << thePdefZ[i];
+  for (size_t i = 0; i < thePdefA.size(); i++) oss << " a:" << thePdefA[i];
+  for (size_t i = 0; i < thePdefPDG.size(); i++) oss << " pdg:" << thePdefPDG[i];
+  for (size_t i = 0; i < theParentPdef.size(); i++) oss << " p:" << theParentPdef[i];
+  for (size_t i = 0; i < theDirectParentPdef.size(); i++) oss << " dp:" << theDirectParentPdef[i];
+  return oss.str();
 }
 //---------------------------------------------------------------------------
 
@@ -143,6 +174,8 @@ void GateParticleFilter::Add(const G4String &particleName)
     if (thePdef[i] == particleName ) return;
   }
   thePdef.push_back(particleName);
+  mDefinitionCache.clear();
+  mLastDefinition = 0;
 }
 //---------------------------------------------------------------------------
 
@@ -154,6 +187,8 @@ void GateParticleFilter::AddZ(const G4int &particleZ)
     if (thePdefZ[i] == particleZ ) return;
   }
   thePdefZ.push_back(particleZ);
+  mDefinitionCache.clear();
+  mLastDefinition = 0;
 }
 //---------------------------------------------------------------------------
 
@@ -165,6 +200,8 @@ void GateParticleFilter::AddA(const G4int &particleA)
     if (thePdefA[i] == particleA ) return;
   }
   thePdefA.push_back(particleA);
+  mDefinitionCache.clear();
+  mLastDefinition = 0;
 }
 //---------------------------------------------------------------------------
 
@@ -176,6 +213,8 @@ void GateParticleFilter::AddPDG(const G4int &particlePDG)
     if (thePdefPDG[i] == particlePDG ) return;
   }
   thePdefPDG.push_back(particlePDG);
+  mDefinitionCache.clear();
+  mLastDefinition = 0;
 }
 //---------------------------------------------------------------------------
 
@@ -190,6 +190,14 @@ void GateRootHitBuffer::Fill(GateCrystalHit* aHit)
 }
 
 GateCrystalHit* GateRootHitBuffer::CreateHit()
+{
+  // Create a new hit
+  GateCrystalHit* aHit = new GateCrystalHit();
+  FillHit(aHit);
+  return aHit;
+}
+
+void GateRootHitBuffer::FillHit(GateCrystalHit* aHit)
 {
   // Create a volumeID from the root-hit data
   GateVolumeID aVolumeID(volumeID,ROOT_VOLUMEIDSIZE);
@@ -200,9 +208,6 @@ GateCrystalHit* GateRootHitBuffer::CreateHit()
   for ( d=0 ; d<ROOT_OUTPUTIDSIZE ; ++d)
     anOutputVolumeID[d] = outputID[d];
 
-  // Create a new hit
-  GateCrystalHit* aHit = new GateCrystalHit();
-
   // Initialise the hit data from the root-hit data
   aHit->SetEdep(    	      	GetEdep() );
   aHit->SetStepLength(      	GetStepLength() );
@@ -238,7 +243,6 @@ GateCrystalHit* GateRootHitBuffer::CreateHit()
   aHit->SetSourceType(sourceType);
   aHit->SetDecayType(decayType);
   aHit->SetGammaType(gammaType);  
-  return aHit;
 }
 
 void GateHitTree::Init(GateRootHitBuffer& buffer)
@@ -0,0 +1,146 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+
+#include "GateSharedTableFile.hh"
+#include "GateMessageManager.hh"
+
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//---------------------------------------------------------------------------
+GateSharedTableFile::GateSharedTableFile()
+  : mData(0), mSize(0), mPayload(0), mPayloadSize(0)
+{
+}
+//---------------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------------
+GateSharedTableFile::~GateSharedTableFile()
+{
+  Detach();
+}
+//---------------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------------
+size_t GateSharedTableFile::GetPayloadOffset()
+{
+  size_t page = sysconf(_SC_PAGESIZE);
+  return ((sizeof(Header) + page - 1) / page) * page;
+}
+//---------------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------------
+bool GateSharedTableFile::Attach(const G4String& fileName, uint64_t hash, uint32_t version)
+{
+  Detach();
+
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || size_t(st.st_size) < GetPayloadOffset()) {
+    close(fd);
+    GateWarning("Table file '" << fileName << "' is truncated, it is ignored" << Gateendl);
+    return false;
+  }
+
+  void* data = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  // the mapping stays valid once the file is closed
+  close(fd);
+  if (data == MAP_FAILED) {
+    GateWarning("Could not map the table file '" << fileName << "': " << strerror(errno) << Gateendl);
+    return false;
+  }
+
+  const Header* header = static_cast<const Header*>(data);
+  G4String reason;
+  if (strncmp(header->magic, GetMagic(), sizeof(header->magic)) != 0) reason = "not a table file";
+  else if (header->version != version) reason = "format version differs";
+  else if (header->hash != hash) reason = "built for other materials or options";
+  else if (header->headerSize != GetPayloadOffset() ||
+           header->headerSize + header->payloadSize != uint64_t(st.st_size)) reason = "inconsistent size";
+  if (!reason.empty()) {
+    munmap(data, st.st_size);
+    GateMessage("Core", 1, "Table file '" << fileName << "' is not used (" << reason << ")" << Gateendl);
+    return false;
+  }
+
+  mData = data;
+  mSize = st.st_size;
+  mPayload = static_cast<const char*>(data) + header->headerSize;
+  mPayloadSize = header->payloadSize;
+  return true;
+}
+//---------------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------------
+void GateSharedTableFile::Detach()
+{
+  if (mData) munmap(mData, mSize);
+  mData = 0;
+  mSize = 0;
+  mPayload = 0;
+  mPayloadSize = 0;
+}
+//---------------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------------
+bool GateSharedTableFile::Write(const G4String& fileName, uint64_t hash, uint32_t version,
+                                const std::vector<char>& payload)
+{
+  std::vector<char> header(GetPayloadOffset(), 0);
+  Header* h = reinterpret_cast<Header*>(&header[0]);
+  strncpy(h->magic, GetMagic(), sizeof(h->magic));
+  h->version = version;
+  h->headerSize = header.size();
+  h->hash = hash;
+  h->payloadSize = payload.size();
+
+  // unique temporary name, renamed once complete (rename is atomic)
+  std::ostringstream tmpName;
+  tmpName << fileName << ".tmp" << getpid();
+  FILE* f = fopen(tmpName.str().c_str(), "wb");
+  if (!f) {
+    GateWarning("Could not write the table file '" << tmpName.str() << "'" << Gateendl);
+    return false;
+  }
+  bool ok = fwrite(&header[0], 1, header.size(), f) == header.size();
+  if (ok && !payload.empty()) ok = fwrite(&payload[0], 1, payload.size(), f) == payload.size();
+  ok = (fclose(f) == 0) && ok;
+  if (ok) ok = rename(tmpName.str().c_str(), fileName.c_str()) == 0;
+  if (!ok) {
+    remove(tmpName.str().c_str());
+    GateWarning("Could not write the table file '" << fileName << "'" << Gateendl);
+  }
+  return ok;
+}
+//---------------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------------
+void GateSharedTableFile::Hash::Add(const void* data, size_t size)
+{
+  const unsigned char* p = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; i++) {
+    mValue ^= p[i];
+    mValue *= 1099511628211ULL;
+  }
+}
+//---------------------------------------------------------------------------
@@ -14,7 +14,7 @@ See LICENSE.md for further details
 GateVFilter::GateVFilter(G4String name)
   :GateNamedObject(name)
 {
- 
+  mIsShared = false;
 }
 //-------------------------------------------------------------
 
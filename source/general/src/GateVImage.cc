@@ -20,6 +20,9 @@ See LICENSE.md for further details
 
 // std
 #include <iomanip>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 
 // gate
 #include "GateVImage.hh"
@@ -408,6 +411,69 @@ int GateVImage::GetIndexFromPostPositionAndDirection(const G4ThreeVector& positi
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateVImage::GetVoxelSegments(const G4ThreeVector & start, const G4ThreeVector & end,
+                                  std::vector<std::pair<int, G4double> > & segments) const{
+  segments.clear();
+  G4ThreeVector direction = end - start;
+  G4double length = direction.mag();
+  if (length <= 0) return;
+
+  // Clip the segment to the image box, t in [0,1] along the segment
+  G4double tIn = 0.0;
+  G4double tOut = 1.0;
+  for(int a=0; a<3; a++) {
+    if (direction[a] != 0) {
+      G4double t1 = (-halfSize[a] - start[a]) / direction[a];
+      G4double t2 = ( halfSize[a] - start[a]) / direction[a];
+      if (t1 > t2) std::swap(t1, t2);
+      tIn = std::max(tIn, t1);
+      tOut = std::min(tOut, t2);
+    }
+    else if (start[a] < -halfSize[a] || start[a] > halfSize[a]) return;
+  }
+  if (tIn >= tOut) return;
+
+  // First voxel, and parameters of the next boundary crossed along each axis
+  int i[3], res[3], step[3];
+  G4double tMax[3], tDelta[3];
+  for(int a=0; a<3; a++) {
+    res[a] = (int)lrint(resolution[a]);
+    G4double p = (start[a] + tIn*direction[a] + halfSize[a]) / voxelSize[a];
+    i[a] = std::min(std::max((int)floor(p), 0), res[a]-1);
+    if (direction[a] > 0) {
+      step[a] = 1;
+      tMax[a] = ((i[a]+1)*voxelSize[a] - halfSize[a] - start[a]) / direction[a];
+      tDelta[a] = voxelSize[a] / direction[a];
+    }
+    else if (direction[a] < 0) {
+      step[a] = -1;
+      tMax[a] = (i[a]*voxelSize[a] - halfSize[a] - start[a]) / direction[a];
+      tDelta[a] = -voxelSize[a] / direction[a];
+    }
+    else {
+      step[a] = 0;
+      tMax[a] = DBL_MAX;
+      tDelta[a] = DBL_MAX;
+    }
+  }
+
+  // Zero length pieces (start exactly on a voxel boundary) are skipped
+  G4double t = tIn;
+  while (true) {
+    int a = (tMax[0] < tMax[1]) ? ((tMax[0] < tMax[2]) ? 0 : 2) : ((tMax[1] < tMax[2]) ? 1 : 2);
+    G4double tNext = std::min(tMax[a], tOut);
+    if (tNext > t) segments.push_back(std::make_pair(i[0]+i[1]*lineSize+i[2]*planeSize, (tNext-t)*length));
+    if (tMax[a] >= tOut) break;
+    t = tMax[a];
+    i[a] += step[a];
+    if (i[a] < 0 || i[a] >= res[a]) break;
+    tMax[a] += tDelta[a];
+  }
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 int GateVImage::GetIndexFromPostPosition(const G4ThreeVector& pre,
 					const G4ThreeVector& post) const{
@@ -66,6 +66,8 @@ void GateVolumeFilter::addVolume(G4String volName)
 void GateVolumeFilter::Initialize()
 {
   IsInitialized=true;
+  theListOfVolume.clear();
+  theListOfLogicalVolume.clear();
   
   for(unsigned int k =0 ; k<theTempoListOfVolumeName.size();k++)
   {
@@ -108,6 +110,16 @@ void GateVolumeFilter::Initialize()
 //---------------------------------------------------------------------------
 
 
+//---------------------------------------------------------------------------
+G4String GateVolumeFilter::GetSignature() const
+{
+  G4String signature = "volumeFilter";
+  for(unsigned int k =0 ; k<theTempoListOfVolumeName.size();k++)
+    signature += " " + theTempoListOfVolumeName[k];
+  return signature;
+}
+//---------------------------------------------------------------------------
+
 //---------------------------------------------------------------------------
 void GateVolumeFilter::show(){
   G4cout << "------Filter: "<<GetObjectName()<<" ------\n";
@@ -20,6 +20,8 @@
 #include "GatePhysicsList.hh"
 #include "GateRTPhantomMgr.hh"
 
+#include <vector>
+
 #include "G4FieldManager.hh"
 #include "G4MagIntegratorDriver.hh"
 #include "G4MagIntegratorStepper.hh"
@@ -124,6 +126,12 @@ public:
   //  virtual void GeometryHasChanged(GeometryStatus changeLevel);
   virtual void ClockHasChanged();
 
+  //! When the clock changes, only reposition the volumes that have moves and
+  //! re-optimise the navigation voxels of their mothers (default), instead of
+  //! updating the whole geometry tree and re-optimising the whole geometry
+  inline void SetIncrementalMotionUpdate(G4bool val) { flagIncrementalMotionUpdate = val; }
+  inline G4bool GetIncrementalMotionUpdate() const { return flagIncrementalMotionUpdate; }
+
   inline virtual void SetAutoUpdateFlag(G4bool val)
   { flagAutoUpdate = val; }
 
@@ -136,7 +144,7 @@ public:
   inline virtual G4bool GetGeometryStatusFlag()
   { return nGeometryStatus; }
 
-  virtual inline void SetFlagMove(G4bool val)  { moveFlag = val; };
+  virtual inline void SetFlagMove(G4bool val)  { moveFlag = val; m_movingVolumesFound = false; };
 
   virtual inline G4bool GetFlagMove() const { return moveFlag; };
 
@@ -169,6 +177,16 @@ private :
   GeometryStatus nGeometryStatus;
   G4bool flagAutoUpdate;
 
+  //! Incremental update of the moving volumes (see SetIncrementalMotionUpdate)
+  void FindMovingVolumes();
+  void UpdateMovingVolumes();
+  void ReoptimiseVoxels(G4LogicalVolume* volume);
+  G4bool flagIncrementalMotionUpdate;
+  G4bool m_movingVolumesFound;
+  std::vector<GateVVolume*> m_movingVolumes;
+  G4int m_nbOfGeometryUpdates;
+  G4double m_geometryUpdateTime;
+
   GateCrystalSD*   m_crystalSD;
   GatePhantomSD*   m_phantomSD;
 
@@ -41,6 +41,7 @@ private:
     G4UIcmdWithABool*               SkipEqualMaterialsCmd;
     G4UIcmdWithADoubleAndUnit*      FictitiousEnergyCmd;
     G4UIcmdWithADoubleAndUnit*      DiscardEnergyCmd;
+    G4UIcmdWithAString*             CrossSectionsTableFileCmd;
 
     GateFictitiousVoxelMapParameterized*  m_inserter;
 };
@@ -127,6 +127,14 @@ public :
 
   virtual GateVolumePlacement* GetVolumePlacement() const;
 
+  //! True if moves were inserted besides the default placement, i.e. if the
+  //! placements of the volume may change when the clock changes
+  virtual G4bool HasMoves() const;
+
+  //! Recompute the position of the volume's existing physical volumes (moves and repeaters),
+  //! without updating its children
+  virtual inline void UpdateOwnPhysicalVolume() { ConstructOwnPhysicalVolume(true); }
+
 public :
 
   //! Return the name used or to be used for the solid
@@ -31,6 +31,8 @@ class GateVolumeSelector
     
     //! Constructs a GateVolumeSelector for a physical volume
     GateVolumeSelector(G4VPhysicalVolume* itsVolume);
+    //! Same, with the copy-number of a navigation history (replicas, or volumes no longer navigated)
+    GateVolumeSelector(G4VPhysicalVolume* itsVolume,G4int itsCopyNo);
     
     virtual ~GateVolumeSelector() {}
 
@@ -132,6 +134,8 @@ class GateVolumeID : public std::vector<GateVolumeSelector>
     //! Appends a new level at the end of the vector
     inline void InsertVolumeLevel(G4VPhysicalVolume* volume)
     { insert(begin(),GateVolumeSelector(volume)); }
+    inline void InsertVolumeLevel(G4VPhysicalVolume* volume,G4int copyNo)
+    { insert(begin(),GateVolumeSelector(volume,copyNo)); }
 
  
     //! Store the daughterIDs into an array
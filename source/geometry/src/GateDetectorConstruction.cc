@@ -30,6 +30,11 @@
 #include "G4SDManager.hh"
 #include "G4Material.hh"
 #include "G4NistManager.hh"
+#include "G4SmartVoxelHeader.hh"
+#include "G4Timer.hh"
+#include "voxeldefs.hh"
+
+#include <set>
 
 #ifdef GATE_USE_OPTICAL
 #include "GateSurfaceList.hh"
@@ -43,6 +48,10 @@ GateDetectorConstruction::GateDetectorConstruction()
      pworldPhysicalVolume(0),
      nGeometryStatus(geometry_needs_rebuild),
      flagAutoUpdate(false),
+     flagIncrementalMotionUpdate(true),
+     m_movingVolumesFound(false),
+     m_nbOfGeometryUpdates(0),
+     m_geometryUpdateTime(0.),
      m_crystalSD(0),
      m_phantomSD(0),
      pdetectorMessenger(0),
@@ -145,6 +154,7 @@ G4VPhysicalVolume* GateDetectorConstruction::Construct()
 
   pworldPhysicalVolume = pworld->GateVVolume::Construct();
   SetGeometryStatusFlag(geometry_is_uptodate);
+  m_movingVolumesFound = false;
 
   GateMessage("Physic", 1, " \n");
   GateMessage("Physic", 1, "----------------------------------------------------------\n");
@@ -430,18 +440,36 @@ void GateDetectorConstruction::UpdateGeometry()
     return;
   }
 
+  G4Timer timer;
+  timer.Start();
+
   switch (nGeometryStatus){
   case geometry_needs_update:
+    if (flagIncrementalMotionUpdate && pworldPhysicalVolume) {
+      // The world volume is unchanged and its navigation voxels are updated in place
+      UpdateMovingVolumes();
+      break;
+    }
     pworld->Construct(true);
+    GateRunManager::GetRunManager()->DefineWorldVolume(pworldPhysicalVolume);
     break;
 
   case geometry_needs_rebuild:
   default:
     DestroyGeometry();
     Construct();
+    GateRunManager::GetRunManager()->DefineWorldVolume(pworldPhysicalVolume);
     break;
   }
-  GateRunManager::GetRunManager()->DefineWorldVolume(pworldPhysicalVolume);
+
+  timer.Stop();
+  if (nGeometryStatus == geometry_needs_update) {
+    m_nbOfGeometryUpdates++;
+    m_geometryUpdateTime += timer.GetRealElapsed();
+    GateMessage("Geometry", 1, "Geometry update (" << (flagIncrementalMotionUpdate ? "incremental" : "full")
+                << "): " << timer.GetRealElapsed() << " s, mean per time slice: "
+                << m_geometryUpdateTime/m_nbOfGeometryUpdates << " s over " << m_nbOfGeometryUpdates << " slices\n");
+  }
 
   nGeometryStatus = geometry_is_uptodate;
 
@@ -450,6 +478,66 @@ void GateDetectorConstruction::UpdateGeometry()
 }
 //---------------------------------------------------------------------------------
 
+//---------------------------------------------------------------------------------
+void GateDetectorConstruction::FindMovingVolumes()
+{
+  m_movingVolumes.clear();
+  GateObjectStore* store = GateObjectStore::GetInstance();
+  for (GateObjectStore::iterator it = store->begin(); it != store->end(); ++it) {
+    GateVVolume* volume = store->GetCreator(it);
+    if (volume->HasMoves() && volume->GetVolumeNumber()) {
+      m_movingVolumes.push_back(volume);
+      GateMessage("Move", 2, "Volume " << volume->GetObjectName() << " moves with the clock\n");
+    }
+  }
+  m_movingVolumesFound = true;
+}
+//---------------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------------
+// Only the placements of the moving volumes change: their children, and
+// the navigation voxels of their own logical volumes, which are in local
+// coordinates, stay valid. Only their mothers' voxels must be rebuilt.
+void GateDetectorConstruction::UpdateMovingVolumes()
+{
+  if (!m_movingVolumesFound) FindMovingVolumes();
+
+  std::set<G4LogicalVolume*> mothers;
+  for (size_t i = 0; i < m_movingVolumes.size(); i++) {
+    m_movingVolumes[i]->UpdateOwnPhysicalVolume();
+    if (m_movingVolumes[i]->GetMotherLogicalVolume())
+      mothers.insert(m_movingVolumes[i]->GetMotherLogicalVolume());
+  }
+  for (std::set<G4LogicalVolume*>::iterator it = mothers.begin(); it != mothers.end(); ++it)
+    ReoptimiseVoxels(*it);
+
+  // The navigators keep the transformations of the last located volumes
+  G4TransportationManager* transportationManager = G4TransportationManager::GetTransportationManager();
+  std::vector<G4Navigator*>::iterator nav = transportationManager->GetActiveNavigatorsIterator();
+  for (size_t i = 0; i < transportationManager->GetNoActiveNavigators(); i++, nav++)
+    (*nav)->ResetStackAndState();
+
+  GateMessage("Move", 5, m_movingVolumes.size() << " moving volumes updated, "
+              << mothers.size() << " mother volumes re-optimised\n");
+}
+//---------------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------------
+// Same criteria as G4GeometryManager::BuildOptimisations, for a single volume
+void GateDetectorConstruction::ReoptimiseVoxels(G4LogicalVolume* volume)
+{
+  delete volume->GetVoxelHeader();
+  volume->SetVoxelHeader(0);
+
+  if ( (volume->IsToOptimise() && volume->GetNoDaughters() >= kMinVoxelVolumesLevel1)
+       || (volume->GetNoDaughters() == 1
+           && volume->GetDaughter(0)->IsReplicated()
+           && volume->GetDaughter(0)->GetRegularStructureId() != 1) ) {
+    volume->SetVoxelHeader(new G4SmartVoxelHeader(volume));
+  }
+}
+//---------------------------------------------------------------------------------
+
 //---------------------------------------------------------------------------------
 void GateDetectorConstruction::DestroyGeometry()
 {
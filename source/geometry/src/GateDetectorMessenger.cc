@@ -171,6 +171,11 @@ GateDetectorMessenger::GateDetectorMessenger(GateDetectorConstruction* GateDet)
   IoniCmd = new G4UIcmdWithAString(cmd,this);
   IoniCmd->SetGuidance("Set the ionisation potential for a material (two parameters 'material' and 'value and unit')");
 
+  cmd = "/gate/geometry/setIncrementalMotionUpdate";
+  pIncrementalMotionUpdateCmd = new G4UIcmdWithABool(cmd,this);
+  pIncrementalMotionUpdateCmd->SetGuidance("When the time changes, only reposition the moving volumes and re-optimise their mothers (true, default) or update and re-optimise the whole geometry (false)");
+  pIncrementalMotionUpdateCmd->SetParameterName("flag", false);
+
 
 
 
@@ -186,6 +191,7 @@ GateDetectorMessenger::~GateDetectorMessenger()
   delete pMagFieldCmd;
   delete pListCreatorsCmd;
   delete IoniCmd;
+  delete pIncrementalMotionUpdateCmd;
 
   delete pGateGeometryDir;
   delete pGateDir;
@@ -245,6 +251,8 @@ void GateDetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
       GetStringAndValueFromCommand(command, newValue, matName, value);
       pDetectorConstruction->SetMaterialIoniPotential(matName,value);
     }
+  else if( command == pIncrementalMotionUpdateCmd )
+    { pDetectorConstruction->SetIncrementalMotionUpdate(pIncrementalMotionUpdateCmd->GetNewBoolValue(newValue)); }
   else
     G4UImessenger::SetNewValue(command,newValue);
     
@@ -66,6 +66,11 @@ GateFictitiousVoxelMapParameterizedMessenger::GateFictitiousVoxelMapParameterize
   DiscardEnergyCmd->SetUnitCategory("Energy");
 //  DiscardEnergyCmd->AvailableForStates(G4State_PreInit);
 
+  cmdName = G4String("/gate/") + itsInserter->GetObjectName()+"/setCrossSectionsTableFile";
+  CrossSectionsTableFileCmd = new G4UIcmdWithAString(cmdName,this);
+  CrossSectionsTableFileCmd->SetGuidance("Set a file to share the fictitious cross sections tables between the processes of a node (built and written if missing or outdated)");
+  CrossSectionsTableFileCmd->SetParameterName("filename",false);
+
   cmdName = GetDirectoryName()+"removeReader";
   RemoveReaderCmd = new G4UIcmdWithoutParameter(cmdName,this);
   RemoveReaderCmd->SetGuidance("Remove the reader");
@@ -85,6 +90,7 @@ GateFictitiousVoxelMapParameterizedMessenger::~GateFictitiousVoxelMapParameteriz
    delete DiscardEnergyCmd;
    delete FictitiousEnergyCmd;
    delete SkipEqualMaterialsCmd;
+   delete CrossSectionsTableFileCmd;
 }
 
 ///////////////////
@@ -117,6 +123,9 @@ void GateFictitiousVoxelMapParameterizedMessenger::SetNewValue(G4UIcommand* comm
   else if (command == DiscardEnergyCmd)
     { GatePETVRTManager::GetInstance()->GetOrCreatePETVRTSettings()->SetDiscardEnergy(DiscardEnergyCmd->GetNewDoubleValue(newValue)); }
 
+  else if (command == CrossSectionsTableFileCmd)
+    { GatePETVRTManager::GetInstance()->GetOrCreatePETVRTSettings()->SetCrossSectionsTableFile(newValue); }
+
   else
     GateMessenger::SetNewValue(command,newValue);
 }
@@ -14,6 +14,9 @@
 
 #include <pthread.h>
 #include <set>
+#include <thread>
+#include <algorithm>
+#include <cfloat>
 
 #include "GateVImageVolume.hh"
 #include "GateMiscFunctions.hh"
@@ -24,6 +27,7 @@
 #include "GateDMapdt.h"
 #include "GateHounsfieldMaterialTable.hh"
 #include <G4TransportationManager.hh>
+#include <G4Timer.hh>
 #include "globals.hh"
 
 typedef unsigned int uint;
@@ -214,6 +218,8 @@ void GateVImageVolume::SetRangeMaterialTableFilename(const G4String& name)
 void GateVImageVolume::LoadImage(bool add1VoxelMargin)
 {
   GateMessageInc("Volume",4,"Begin GateVImageVolume::LoadImage("<<mImageFilename<<")\n");
+  G4Timer timer;
+  timer.Start();
 
   ImageType* tmp = new ImageType;
 
@@ -309,6 +315,8 @@ void GateVImageVolume::LoadImage(bool add1VoxelMargin)
 
   GateMessage("Volume",4,"voxel size" << pImage->GetVoxelSize() << Gateendl);
   GateMessage("Volume",4,"origin" << GetOrigin() << Gateendl);
+  timer.Stop();
+  GateMessage("Volume",1,"[startup profile] " << mImageFilename << ": LoadImage: " << timer.GetRealElapsed() << " s" << Gateendl);
   GateMessageDec("Volume",4,"End GateVImageVolume::LoadImage("<<mImageFilename<<")\n");
 }
 //--------------------------------------------------------------------
@@ -420,30 +428,59 @@ void GateVImageVolume::LoadImageMaterialsFromHounsfieldTable() {
   // Loop, create map H->label + verify
   mHounsfieldMaterialTable.MapLabelToMaterial(mLabelToMaterialName);
 
-  // Loop change image label
-  ImageType::iterator iter;
-  iter = pImage->begin();
-  while (iter != pImage->end()) {
-    double label = mHounsfieldMaterialTable.GetLabelFromH(*iter);
-    if (label<0) {
-      GateMessage("Volume",1," I find H=" << *iter
+  // Loop change image label. The voxels are independent: large images
+  // are split in chunks converted by several threads.
+  G4Timer timer;
+  timer.Start();
+  const GateHounsfieldMaterialTable & table = mHounsfieldMaterialTable;
+  const int nbMaterials = table.GetNumberOfMaterials();
+  const long nbVoxels = pImage->GetNumberOfValues();
+  const long minVoxelsPerThread = 1<<18;
+  long nbThreads = std::thread::hardware_concurrency();
+  nbThreads = std::max(1L, std::min(nbThreads, nbVoxels/minVoxelsPerThread));
+  std::vector<unsigned int> underflows(nbThreads,0), overflows(nbThreads,0);
+  std::vector<double> minH(nbThreads,DBL_MAX), maxH(nbThreads,-DBL_MAX);
+  auto convert = [&](long t) {
+    ImageType::iterator iter = pImage->begin() + (nbVoxels*t)/nbThreads;
+    ImageType::iterator last = pImage->begin() + (nbVoxels*(t+1))/nbThreads;
+    for (; iter != last; ++iter) {
+      int label = table.GetLabelFromH(*iter);
+      if (label<0) {
+        minH[t] = std::min(minH[t], (double)*iter);
+        label = 0;
+        ++underflows[t];
+      }
+      if (label>=nbMaterials) {
+        maxH[t] = std::max(maxH[t], (double)*iter);
+        label = nbMaterials - 1;
+        ++overflows[t];
+      }
+      (*iter) = label;
+    }
+  };
+  std::vector<std::thread> threads;
+  for (long t=1; t<nbThreads; t++) threads.push_back(std::thread(convert, t));
+  convert(0);
+  for (size_t t=0; t<threads.size(); t++) threads[t].join();
+  unsigned int underflow = 0, overflow = 0;
+  for (long t=0; t<nbThreads; t++) {
+    underflow += underflows[t];
+    overflow += overflows[t];
+  }
+  if (underflow > 0)
+    GateMessage("Volume",1," I find " << underflow << " voxels with H down to " << *std::min_element(minH.begin(), minH.end())
                 << " in the image, while Hounsfield range start at "
                 << mHounsfieldMaterialTable[0].mH1 << Gateendl);
-      label = 0;
-      ++mUnderflow;
-    }
-    if (label>=mHounsfieldMaterialTable.GetNumberOfMaterials()) {
-      GateMessage("Volume",1," I find H=" << *iter
+  if (overflow > 0)
+    GateMessage("Volume",1," I find " << overflow << " voxels with H up to " << *std::max_element(maxH.begin(), maxH.end())
                 << " in the image, while Hounsfield range stop at "
-                << mHounsfieldMaterialTable[mHounsfieldMaterialTable.GetNumberOfMaterials()-1].mH2
+                << mHounsfieldMaterialTable[nbMaterials-1].mH2
                 << Gateendl);
-      label = mHounsfieldMaterialTable.GetNumberOfMaterials() - 1;
-      ++mOverflow;
-    }
-    //GateMessage("Core", 0, " pix = " << (*iter) << " lab = " << label << Gateendl);
-    (*iter) = label;
-    ++iter;
-  }
+  mUnderflow += underflow;
+  mOverflow += overflow;
+  timer.Stop();
+  GateMessage("Volume",1,"[startup profile] " << mImageFilename << ": H to label conversion of "
+              << nbVoxels << " voxels (" << nbThreads << " threads): " << timer.GetRealElapsed() << " s" << Gateendl);
 
   assert( pImage->GetNumberOfValues() > 0 );
   // double out_of_range_fraction = double(mUnderflow+mOverflow)/pImage->GetNumberOfValues(); // not yet
@@ -806,6 +843,8 @@ void GateVImageVolume::BuildLabelToG4MaterialVector( std::vector<G4Material*>& M
 void GateVImageVolume::RemapLabelsContiguously( std::vector<LabelType>& labels, bool /*marginAdded*/ )
 {
   GateMessageInc("Volume",5,"Begin GateVImageVolume::RemapLabelsContiguously\n");
+  G4Timer timer;
+  timer.Start();
   std::map<LabelType,LabelType> lmap;
 
   LabelType cur = 0;
@@ -823,10 +862,20 @@ void GateVImageVolume::RemapLabelsContiguously( std::vector<LabelType>& labels,
     *i = cur;
   }
 
-  // updates the image
-  ImageType::iterator j;
-  for (j=pImage->begin(); j!=pImage->end(); ++j) {
-    *j = lmap[(LabelType)*j];
+  // updates the image (dense lookup table over the label range instead
+  // of a map lookup per voxel)
+  if (!lmap.empty()) {
+    LabelType minLabel = lmap.begin()->first;
+    LabelType maxLabel = lmap.rbegin()->first;
+    std::vector<LabelType> lut(maxLabel-minLabel+1, 0);
+    for (std::map<LabelType,LabelType>::iterator m=lmap.begin(); m!=lmap.end(); ++m)
+      lut[m->first-minLabel] = m->second;
+    ImageType::iterator j;
+    for (j=pImage->begin(); j!=pImage->end(); ++j) {
+      LabelType l = (LabelType)*j;
+      if (l>=minLabel && l<=maxLabel) *j = lut[l-minLabel];
+      else *j = lmap[l];
+    }
   }
 
   // updates the material map
@@ -859,6 +908,8 @@ void GateVImageVolume::RemapLabelsContiguously( std::vector<LabelType>& labels,
       mHounsfieldMaterialTable[i].mH2 = tmp[i].mH2;
       mHounsfieldMaterialTable[i].md1 = tmp[i].md1;
     }
+  timer.Stop();
+  GateMessage("Volume",1,"[startup profile] " << mImageFilename << ": RemapLabelsContiguously: " << timer.GetRealElapsed() << " s" << Gateendl);
 }
 //--------------------------------------------------------------------
 
@@ -548,6 +548,14 @@ GateVolumePlacement *GateVVolume::GetVolumePlacement() const {
 //-----------------------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------------------
+// The first element of the move list is always the default placement (see the constructor)
+G4bool GateVVolume::HasMoves() const {
+    return m_moveList && m_moveList->size() > 1;
+}
+//-----------------------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------------------
 // Method automatically called to color-code the object when its material changes.
 void GateVVolume::AutoSetColor() {
@@ -36,6 +36,19 @@ GateVolumeSelector::GateVolumeSelector(G4VPhysicalVolume* itsVolume)
 //-----------------------------------------------------------------------------------   
 
 
+//-----------------------------------------------------------------------------------
+GateVolumeSelector::GateVolumeSelector(G4VPhysicalVolume* itsVolume,G4int itsCopyNo)
+{
+  m_creator = GateObjectStore::GetInstance()->FindVolumeCreator(itsVolume);
+  m_copyNo = itsCopyNo;
+  if (m_creator->GetMotherList())
+    m_daughterID = m_creator->GetMotherList()->GetChildNo(m_creator,m_copyNo);
+  else
+    m_daughterID = 0;
+}
+//-----------------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------------
 // Friend function: inserts (prints) a GateVolumeSelector into a stream
 std::ostream& operator<<(std::ostream& flux, const GateVolumeSelector& volumeLevelID)    
@@ -77,9 +90,11 @@ GateVolumeID::GateVolumeID(const G4TouchableHistory* touchable)
 */
 
 //   replacement with a GEANT4.6 compatible code:
+  // The copy-numbers are taken from the touchable, so that the volumeID can also
+  // be computed after the navigation has moved on (see GateCrystalHit)
   for (G4int numVol=0;numVol<touchable->GetHistoryDepth();numVol++){
      
-    InsertVolumeLevel( touchable->GetVolume(numVol) );
+    InsertVolumeLevel( touchable->GetVolume(numVol), touchable->GetReplicaNumber(numVol) );
     
   }
     
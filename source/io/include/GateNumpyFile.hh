@@ -14,6 +14,7 @@
 #include <unordered_map>
 #include <stdexcept>
 #include <cxxabi.h>
+#include <memory>
 
 
 #include "GateTreeFile.hh"
@@ -105,6 +106,15 @@ class GateOutputNumpyTreeFile: public GateNumpyTree, public GateOutputTreeFile
 {
 public:
   GateOutputNumpyTreeFile();
+
+  // Entries are staged in memory and written in blocks of this size
+  // (at least one entry). Applies to files opened afterwards.
+  static void set_buffer_size(size_t nb_bytes);
+  // Columnar mode: instead of one structured array, each variable is
+  // written to its own 1D array file "<base>_<variable>.npy", so that
+  // columns can be memory-mapped individually.
+  static void set_columnar(bool b);
+
   void open(const std::string& s) override ;
   bool is_open() override;
   void close() override;
@@ -125,7 +135,27 @@ public:
   }
 
 private:
+  struct NumpyColumn
+  {
+    std::fstream file;
+    uint64_t position_before_shape;
+    std::vector<char> buffer;
+    size_t used;
+  };
+
+  void stage(std::fstream &f, std::vector<char> &buffer, size_t &used, const char *p, size_t n);
+  void flush(std::fstream &f, std::vector<char> &buffer, size_t &used);
+  void write_npy_header(std::fstream &f, const std::string &descr, uint64_t &position_before_shape);
+  void write_shape(std::fstream &f, uint64_t position_before_shape);
+
   bool m_write_header_called;
+  bool m_columnar;
+  bool m_is_open;
+  std::vector<char> m_buffer;
+  size_t m_buffer_used;
+  std::vector<std::unique_ptr<NumpyColumn>> m_columns;
+  static size_t s_buffer_size;
+  static bool s_columnar;
   static bool s_registered;
 };
 
@@ -134,6 +164,11 @@ class GateInputNumpyTreeFile: public GateNumpyTree, public GateInputTreeFile
 {
 public:
   GateInputNumpyTreeFile();
+  ~GateInputNumpyTreeFile() override;
+
+  // Size of the window the kernel is asked to read ahead of the current
+  // entry when the file is memory-mapped.
+  static void set_readahead_size(size_t nb_bytes);
 
   void open(const std::string &name) override ;
   bool is_open() override;
@@ -154,9 +189,21 @@ public:
   std::type_index get_type_of_variable(const std::string &name) override;
 
 private:
+  void decode_entrie(const char *src);
+  void prefetch(size_t position);
+
   size_t  m_length_of_file;
   static bool s_registered;
   bool m_read_header_called;
   size_t m_start_of_data;
+  size_t m_size_of_entrie;
+
+  // The data is memory-mapped when possible, entries are then decoded
+  // straight from the mapping; m_file is only used to parse the header
+  // and as fallback.
+  const char *m_map;
+  size_t m_position;
+  size_t m_prefetched_until;
+  static size_t s_readahead_size;
 };
 
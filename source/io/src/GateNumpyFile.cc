@@ -9,9 +9,13 @@
 
 #include <iomanip>
 #include <cstring>
+#include <algorithm>
 
 #include <stdexcept>
 #include <utility>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "GateFileExceptions.hh"
 #include "GateTreeFileManager.hh"
 
@@ -141,29 +145,15 @@ void  GateNumpyTree::register_variable(const std::string &name, const int *, siz
 
 
 
-void GateOutputNumpyTreeFile::write_header()
+void GateOutputNumpyTreeFile::write_npy_header(std::fstream &f, const std::string &descr, uint64_t &position_before_shape)
 {
-
-  if( (m_mode & ios_base::out) != ios_base::out )
-    throw std::runtime_error("NumpyFile::write_header: file not opened in write mode");
-
-  m_file << magic_prefix.c_str();
+  f << magic_prefix.c_str();
   uint32_t  magic_len = magic_prefix.size() + 2;
 
   std::stringstream ss_dico_before_shape, ss_dico_after_shape;
   string dico_before_shape, dico_after_shape;
 
-  ss_dico_before_shape << "{'descr': [";
-
-
-  for ( auto it = m_vector_of_pointer_to_data.begin(); it != m_vector_of_pointer_to_data.end(); ++it )
-    {
-      if(it != m_vector_of_pointer_to_data.begin())
-        ss_dico_before_shape << ", ";
-      ss_dico_before_shape << (*it).m_numpy_description;
-    }
-
-  ss_dico_before_shape << "], 'fortran_order': False, 'shape': (";
+  ss_dico_before_shape << "{'descr': " << descr << ", 'fortran_order': False, 'shape': (";
 
   string shape = "######";
 
@@ -191,21 +181,102 @@ void GateOutputNumpyTreeFile::write_header()
   uint8_t major = 1;
   uint8_t minor = 0;
 
-  m_file.write((char*)&major, sizeof(major));
-  m_file.write((char*)&minor, sizeof(minor));
-  m_file.write((char*)&hlen, sizeof(hlen));
+  f.write((char*)&major, sizeof(major));
+  f.write((char*)&minor, sizeof(minor));
+  f.write((char*)&hlen, sizeof(hlen));
 
 
-  m_file << dico_before_shape.c_str();
-  m_position_before_shape = m_file.tellp();
+  f << dico_before_shape.c_str();
+  position_before_shape = f.tellp();
 
-  m_file.write(shape.c_str(), shape.size());
-  m_position_after_shape = m_file.tellp();
-  m_file << dico_after_shape.c_str();
+  f.write(shape.c_str(), shape.size());
+  f << dico_after_shape.c_str();
+}
+
+
+void GateOutputNumpyTreeFile::write_header()
+{
+
+  if( (m_mode & ios_base::out) != ios_base::out )
+    throw std::runtime_error("NumpyFile::write_header: file not opened in write mode");
+
+  size_t size_of_entry = 0;
+  for (auto&& d : m_vector_of_pointer_to_data)
+    size_of_entry += d.m_size_of_data;
+
+  if(!m_columnar)
+    {
+      std::stringstream descr;
+      descr << "[";
+      for ( auto it = m_vector_of_pointer_to_data.begin(); it != m_vector_of_pointer_to_data.end(); ++it )
+        {
+          if(it != m_vector_of_pointer_to_data.begin())
+            descr << ", ";
+          descr << (*it).m_numpy_description;
+        }
+      descr << "]";
+      write_npy_header(m_file, descr.str(), m_position_before_shape);
+      m_position_after_shape = m_position_before_shape + 20;
+      m_buffer.resize(std::max(s_buffer_size, size_of_entry));
+      m_buffer_used = 0;
+    }
+  else
+    {
+      // one file per variable, the buffer is shared proportionally to the size of the variables
+      string base = m_path;
+      if(base.size() > 4 && base.substr(base.size() - 4) == ".npy")
+        base = base.substr(0, base.size() - 4);
+      for (auto&& d : m_vector_of_pointer_to_data)
+        {
+          std::unique_ptr<NumpyColumn> c(new NumpyColumn);
+          string name = base + "_" + d.name() + ".npy";
+          c->file.open(name, std::ofstream::binary | std::fstream::out);
+          if(!c->file.is_open())
+            {
+              std::stringstream ss;
+              ss << "Error opening file! '"  << name <<  "' : " << strerror(errno) ;
+              throw std::ios::failure(ss.str());
+            }
+          write_npy_header(c->file, "'" + d.m_numpy_format + "'", c->position_before_shape);
+          size_t size = size_of_entry ? (s_buffer_size / size_of_entry) * d.m_size_of_data : 0;
+          c->buffer.resize(std::max(size, d.m_size_of_data));
+          c->used = 0;
+          m_columns.push_back(std::move(c));
+        }
+    }
   m_write_header_called = true;
 }
 
 
+void GateOutputNumpyTreeFile::stage(std::fstream &f, std::vector<char> &buffer, size_t &used, const char *p, size_t n)
+{
+  // p == nullptr stages n zeros (padding of strings)
+  while(n > 0)
+    {
+      if(used == buffer.size())
+        flush(f, buffer, used);
+      size_t k = std::min(n, buffer.size() - used);
+      if(p)
+        {
+          memcpy(&buffer[used], p, k);
+          p += k;
+        }
+      else
+        memset(&buffer[used], 0, k);
+      used += k;
+      n -= k;
+    }
+}
+
+
+void GateOutputNumpyTreeFile::flush(std::fstream &f, std::vector<char> &buffer, size_t &used)
+{
+  if(used)
+    f.write(buffer.data(), used);
+  used = 0;
+}
+
+
 void GateOutputNumpyTreeFile::fill()
 {
 
@@ -219,10 +290,15 @@ void GateOutputNumpyTreeFile::fill()
   //    return;
 
   //  cout << "OutputNumpyTreeFile::fill()" << endl;
-  for (auto&& d : m_vector_of_pointer_to_data) // access by const reference
+  for (size_t i = 0; i < m_vector_of_pointer_to_data.size(); ++i)
     {
+      auto&& d = m_vector_of_pointer_to_data[i];
+      std::fstream &f = m_columnar ? m_columns[i]->file : m_file;
+      std::vector<char> &buffer = m_columnar ? m_columns[i]->buffer : m_buffer;
+      size_t &used = m_columnar ? m_columns[i]->used : m_buffer_used;
+
       if(d.m_nb_characters == 0)
-        m_file.write((const char*)d.m_pointer_to_data, d.m_size_of_data);
+        stage(f, buffer, used, (const char*)d.m_pointer_to_data, d.m_size_of_data);
       else
         {
           if(d.m_type_index == typeid(char*))
@@ -235,7 +311,7 @@ void GateOutputNumpyTreeFile::fill()
                 p_data[i] = '\0';
 
 
-              m_file.write(p_data, d.m_size_of_data);
+              stage(f, buffer, used, p_data, d.m_size_of_data);
           } else if (d.m_type_index == typeid(string))
           {
               const auto *p_s = (const string*) d.m_pointer_to_data;
@@ -246,11 +322,9 @@ void GateOutputNumpyTreeFile::fill()
                   throw std::length_error(m);
               }
 
-              string s(*p_s); // copy of the data, :-(
-              s.resize(d.m_nb_characters, '\0');
-
-
-              m_file.write(s.c_str(), d.m_size_of_data);
+              // characters then '\0' padding, without copying the string
+              stage(f, buffer, used, p_s->data(), p_s->size());
+              stage(f, buffer, used, nullptr, d.m_size_of_data - p_s->size());
           }
           /*
            *Thinking about how to write in npy file an array of int corresponding to volumeID information. Work in progres. It is not working
@@ -270,20 +344,39 @@ void GateOutputNumpyTreeFile::fill()
   //  cout << "\n";
 }
 
+void GateOutputNumpyTreeFile::write_shape(std::fstream &f, uint64_t position_before_shape)
+{
+  f.seekp(position_before_shape);
+  //    cout << "current position = " << f.tellp() << "\n";
+  stringstream ss_shape;
+  ss_shape << std::setw(20) << std::setfill(' ') << m_nb_elements;
+  string shape = ss_shape.str();
+  f.write(shape.c_str(), shape.size());
+  // back to the end, so that fill() can be called again after write()
+  f.seekp(0, std::ios_base::end);
+}
+
 void GateOutputNumpyTreeFile::write()
 {
 
-  if(!m_file.is_open())
+  if(!m_is_open)
     return;
 
   if( (m_mode & ios_base::out) == ios_base::out )
     {
-      m_file.seekp(m_position_before_shape);
-      //    cout << "current position = " << m_file.tellp() << "\n";
-      stringstream ss_shape;
-      ss_shape << std::setw(20) << std::setfill(' ') << m_nb_elements;
-      string shape = ss_shape.str();
-      m_file.write(shape.c_str(), shape.size());
+      if(!m_write_header_called)
+        return;
+      if(!m_columnar)
+        {
+          flush(m_file, m_buffer, m_buffer_used);
+          write_shape(m_file, m_position_before_shape);
+        }
+      else
+        for (auto&& c : m_columns)
+          {
+            flush(c->file, c->buffer, c->used);
+            write_shape(c->file, c->position_before_shape);
+          }
     } else {
     for (auto&& d : m_vector_of_pointer_to_data) // access by const reference
       {
@@ -297,16 +390,28 @@ void GateOutputNumpyTreeFile::write()
 void GateOutputNumpyTreeFile::close()
 {
 
-  if(!m_file.is_open())
+  if(!m_is_open)
     return;
 
   GateOutputNumpyTreeFile::write();
 
-  m_file.close();
+  if(m_file.is_open())
+    m_file.close();
+  for (auto&& c : m_columns)
+    c->file.close();
+  m_columns.clear();
+  m_buffer.clear();
+  m_buffer.shrink_to_fit();
+  m_is_open = false;
 }
 
 void GateInputNumpyTreeFile::close()
 {
+  if(m_map)
+    {
+      munmap((void*)m_map, m_length_of_file);
+      m_map = nullptr;
+    }
 
   if(!m_file.is_open())
     return;
@@ -319,6 +424,11 @@ void GateInputNumpyTreeFile::close()
 void GateOutputNumpyTreeFile::open(const std::string& s)
 {
   GateFile::open(s, std::ofstream::binary | std::fstream::out);
+  m_columnar = s_columnar;
+  m_is_open = true;
+  // in columnar mode the column files are created by write_header()
+  if(m_columnar)
+    return;
   m_file.open(s, std::ofstream::binary | std::fstream::out);
   if(!m_file.is_open())
     {
@@ -345,6 +455,17 @@ void GateInputNumpyTreeFile::open(const std::string &s)
   m_file.seekg (0, std::fstream::end);
   m_length_of_file = m_file.tellg();
   m_file.seekg (0, std::fstream::beg);
+
+  // map the whole file, reading then falls back to m_file if it fails
+  int fd = ::open(s.c_str(), O_RDONLY);
+  if(fd >= 0 && m_length_of_file > 0)
+    {
+      void *p = mmap(nullptr, m_length_of_file, PROT_READ, MAP_PRIVATE, fd, 0);
+      if(p != MAP_FAILED)
+        m_map = (const char*)p;
+    }
+  if(fd >= 0)
+    ::close(fd);
 }
 
 void GateOutputNumpyTreeFile::write_variable(const std::string &name, const void *p, std::type_index t_index)
@@ -367,9 +488,26 @@ void GateOutputNumpyTreeFile::write_variable(const std::string &name, const int
   this->register_variable(name, p, nb);
 }
 
-GateOutputNumpyTreeFile::GateOutputNumpyTreeFile() : m_write_header_called(false)
+GateOutputNumpyTreeFile::GateOutputNumpyTreeFile() :
+  m_write_header_called(false),
+  m_columnar(false),
+  m_is_open(false),
+  m_buffer_used(0)
 {}
 
+size_t GateOutputNumpyTreeFile::s_buffer_size = 16*1024*1024;
+bool GateOutputNumpyTreeFile::s_columnar = false;
+
+void GateOutputNumpyTreeFile::set_buffer_size(size_t nb_bytes)
+{
+  s_buffer_size = nb_bytes;
+}
+
+void GateOutputNumpyTreeFile::set_columnar(bool b)
+{
+  s_columnar = b;
+}
+
 
 
 
@@ -383,7 +521,7 @@ void GateNumpyTree::register_variable(const std::string &name, const void *p, st
 
 bool GateOutputNumpyTreeFile::is_open()
 {
-  return m_file.is_open();
+  return m_is_open;
 }
 
 
@@ -575,15 +713,60 @@ void GateInputNumpyTreeFile::read_header()
         }
     }
   m_start_of_data = m_file.tellg();
+  m_size_of_entrie = 0;
+  for (auto&& d : m_vector_of_pointer_to_data)
+    m_size_of_entrie += d.m_size_of_data;
+  m_position = m_start_of_data;
+  m_prefetched_until = m_start_of_data;
   m_read_header_called = true;
 }
 
+void GateInputNumpyTreeFile::prefetch(size_t position)
+{
+  if(position + m_size_of_entrie <= m_prefetched_until)
+    return;
+  // ask for the next window asynchronously; madvise wants page aligned addresses
+  static const size_t page_size = sysconf(_SC_PAGESIZE);
+  size_t start = position - position % page_size;
+  size_t length = std::min(s_readahead_size + (position - start), m_length_of_file - start);
+  madvise((void*)(m_map + start), length, MADV_WILLNEED);
+  m_prefetched_until = start + length;
+}
+
+void GateInputNumpyTreeFile::decode_entrie(const char *src)
+{
+  for (auto&& d : m_vector_of_pointer_to_data)
+    {
+      if(d.m_pointer_to_data)
+        {
+          if(d.m_nb_characters && d.m_type_index_read == typeid(string))
+            {
+              memcpy(d.buffer_read, src, d.m_size_of_data);
+              ((string*)d.m_pointer_to_data)->assign(d.buffer_read);
+            }
+          else
+            memcpy((void*)d.m_pointer_to_data, src, d.m_size_of_data);
+        }
+      src += d.m_size_of_data;
+    }
+}
+
 void GateInputNumpyTreeFile::read_next_entrie()
 {
 
   if(!m_read_header_called)
     throw std::logic_error("read_header not called");
 
+  if(m_map)
+    {
+      if(m_position + m_size_of_entrie > m_length_of_file)
+        throw std::out_of_range("InputNumpyTreeFile::read_next_entrie: no more entries in file");
+      prefetch(m_position);
+      decode_entrie(m_map + m_position);
+      m_position += m_size_of_entrie;
+      return;
+    }
+
   //  cout << "0. current pos = " << m_file.tellg() << " end = " << m_file.end << "eof = " <<  m_file.eof() << "data_to_read() ="  << data_to_read() <<   "\n";
   for (auto&& d : m_vector_of_pointer_to_data) // access by const reference
     {
@@ -687,9 +870,26 @@ void GateInputNumpyTreeFile::read_variable(const std::string &name, void *p, std
 
 }
 
-GateInputNumpyTreeFile::GateInputNumpyTreeFile() : m_read_header_called(false)
+GateInputNumpyTreeFile::GateInputNumpyTreeFile() :
+  m_length_of_file(0),
+  m_read_header_called(false),
+  m_start_of_data(0),
+  m_size_of_entrie(0),
+  m_map(nullptr),
+  m_position(0),
+  m_prefetched_until(0)
 {}
 
+GateInputNumpyTreeFile::~GateInputNumpyTreeFile()
+{
+  close();
+}
+
+void GateInputNumpyTreeFile::set_readahead_size(size_t nb_bytes)
+{
+  s_readahead_size = nb_bytes;
+}
+
 void GateInputNumpyTreeFile::read_variable(const std::string &name, char *p)
 {
   read_variable(name, p, typeid(char*));
@@ -699,6 +899,8 @@ bool GateInputNumpyTreeFile::data_to_read()
 {
   if(!m_read_header_called)
     throw std::logic_error("read_header not called");
+  if(m_map)
+    return m_length_of_file > m_position;
   return m_length_of_file > (size_t)m_file.tellg(); // cast to remove warning
 }
 
@@ -728,6 +930,13 @@ void GateInputNumpyTreeFile::read_entrie(const uint64_t &i)
 {
   //  m_file.seekg(m_start_of_data);
 
+  if(m_map)
+    {
+      m_position = m_start_of_data + i * m_size_of_entrie;
+      this->read_next_entrie();
+      return;
+    }
+
   size_t one_element = 0;
   for (auto&& d : m_vector_of_pointer_to_data) // access by const reference
     {
@@ -765,6 +974,7 @@ type_index GateInputNumpyTreeFile::get_type_of_variable(const std::string &name)
 
 
 bool GateOutputNumpyTreeFile::s_registered =  GateOutputTreeFileFactory::_register(GateOutputNumpyTreeFile::_get_factory_name(), &GateOutputNumpyTreeFile::_create_method<GateOutputNumpyTreeFile>);
+size_t GateInputNumpyTreeFile::s_readahead_size = 8*1024*1024;
 bool GateInputNumpyTreeFile::s_registered =  GateInputTreeFileFactory::_register(GateInputNumpyTreeFile::_get_factory_name(), &GateInputNumpyTreeFile::_create_method<GateInputNumpyTreeFile>);
 
 
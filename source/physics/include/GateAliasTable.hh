@@ -0,0 +1,64 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+#ifndef GATEALIASTABLE_HH
+#define GATEALIASTABLE_HH
+
+#include <vector>
+#include "globals.hh"
+
+/*! \class  GateAliasTable
+    \brief  Walker/Vose alias table to sample an index according to a discrete distribution
+
+    - The table is built once in O(n) from a vector of non-negative weights
+      (zero weights are skipped and cost no memory), then each sample costs O(1):
+      one uniform random number, one comparison and at most one indirection.
+    - Memory is 16 bytes per non-zero weight.
+*/
+class GateAliasTable
+{
+public:
+  GateAliasTable() : mTotalWeight(0.) {}
+
+  //! Build the table from the weights; index i is sampled with probability weights[i]/sum
+  void Build(const std::vector<G4double>& weights);
+
+  //! Release the table
+  void Clear();
+
+  //! Sample an index of the weight vector given in Build, from a uniform number u in [0,1[.
+  //! Returns -1 if the table is empty (no non-zero weight).
+  inline G4int Sample(G4double u) const
+  {
+    const size_t n = mThreshold.size();
+    if (n==0) return -1;
+    const G4double x = u*n;
+    size_t bin = static_cast<size_t>(x);
+    if (bin>=n) bin = n-1;
+    const G4int entry = (x-bin < mThreshold[bin]) ? static_cast<G4int>(bin) : mAlias[bin];
+    return mIndex[entry];
+  }
+
+  inline G4bool IsEmpty() const { return mThreshold.empty(); }
+  //! Number of entries with a non-zero weight
+  inline size_t GetNumberOfEntries() const { return mThreshold.size(); }
+  //! Sum of all weights
+  inline G4double GetTotalWeight() const { return mTotalWeight; }
+  //! Memory used by the table, in bytes
+  inline size_t GetMemorySize() const
+  { return mThreshold.capacity()*sizeof(G4double) + (mAlias.capacity()+mIndex.capacity())*sizeof(G4int); }
+
+protected:
+  std::vector<G4double> mThreshold; //!< acceptance probability of each bin
+  std::vector<G4int>    mAlias;     //!< entry returned when the bin is not accepted
+  std::vector<G4int>    mIndex;     //!< index in the original weight vector of each entry
+  G4double              mTotalWeight;
+};
+
+#endif
@@ -41,6 +41,7 @@ class GateCrossSectionsTable: public G4PhysicsTable
 		~GateCrossSectionsTable();
 
 		size_t SetAndBuildProductionMaterialTable(); // returns index of last material
+		size_t SetProductionMaterialTable(const double* sharedValues); // same, with values built by another process (returns index of last material)
 		bool CheckInternalProductionMaterialTable() const; // should return true if internal tables correctly initialized
 
 		bool BuildMaxCrossSection ( const std::vector<G4Material*>& ); // turns this table into a fictitious table
@@ -55,6 +56,11 @@ class GateCrossSectionsTable: public G4PhysicsTable
 
 		G4double GetEnergyLimitForGivenMaxCrossSection(G4double crossSection) const;
 		void StoreTable ( std::ofstream& out, bool ascii ) const;
+
+		// Flat layout of the values, used to share them between processes (GateSharedTableFile):
+		// for each material of the production cuts table, the values at the m_nPhysicsVectorBinNumber+1 nodes
+		inline size_t GetNumberOfSharedValues() const;
+		void AppendSharedValues ( std::vector<double>& values ) const;
 		void RetrieveTable ( std::ifstream& in, bool ascii );
 
 		inline G4double GetCrossSection ( const G4Material*, G4double energy ) const;
@@ -77,11 +83,15 @@ class GateCrossSectionsTable: public G4PhysicsTable
 		std::vector<const G4Material*> m_oMaterialVec;
 		const std::vector<G4VDiscreteProcess*> m_oProcessVec;// several if cross section should be total
 		G4PhysicsVector* m_pMaxCrossSection;
+		const double* pSharedValues; // values in a shared file, instead of the G4PhysicsVectors of the table (NULL if not)
 		int m_nVerbose;
 
 		const G4ParticleDefinition* pParticleDefinition;
 		static G4int PARTICLE_NAME_LENGTH; // for ParticleName and Retrieve and Store Table if writing/reading in binary
 
+		inline G4double GetNodeValue ( size_t materialIndex, size_t node ) const;
+		inline G4double GetSharedValue ( size_t materialIndex, G4double energy ) const;
+
 		void Store ( std::ofstream&, bool ascii, size_t num ) const;
 		void Retrieve ( std::ifstream&, bool ascii, size_t num );
 
@@ -113,23 +123,43 @@ inline G4double GateCrossSectionsTable::GetMaxCrossSection ( G4double energy ) c
 	return m_pMaxCrossSection->GetValue ( energy,NotUsedAnyMoreIsOutOfRange );
 }
 
+inline size_t GateCrossSectionsTable::GetNumberOfSharedValues() const
+{
+	return m_nPhysicsVectorBinNumber+1;
+}
+
+inline G4double GateCrossSectionsTable::GetNodeValue ( size_t materialIndex, size_t node ) const
+{
+	if ( pSharedValues ) return pSharedValues[materialIndex*GetNumberOfSharedValues()+node];
+	return ( *operator() ( materialIndex ) ) [node];
+}
+
+// Linear interpolation between the nodes, as G4PhysicsLinearVector::GetValue
+inline G4double GateCrossSectionsTable::GetSharedValue ( size_t materialIndex, G4double energy ) const
+{
+	const double* v=pSharedValues+materialIndex*GetNumberOfSharedValues();
+	if ( energy<=m_nMinEnergy ) return v[0];
+	if ( energy>=m_nMaxEnergy ) return v[m_nPhysicsVectorBinNumber];
+	const G4double x= ( energy-m_nMinEnergy ) *m_nPhysicsVectorBinNumber/ ( m_nMaxEnergy-m_nMinEnergy );
+	size_t bin=static_cast<size_t> ( x );
+	if ( bin>=static_cast<size_t> ( m_nPhysicsVectorBinNumber ) ) bin=m_nPhysicsVectorBinNumber-1;
+	return v[bin]+ ( v[bin+1]-v[bin] ) * ( x-bin );
+}
+
 inline G4double GateCrossSectionsTable::GetCrossSection ( size_t materialIndex, G4double energy) const
 {
 	bool NotUsedAnyMoreIsOutOfRange;
-	assert ( size() >materialIndex );
+	assert ( m_oInvDensity.size() >materialIndex );
 	assert ( energy>=m_nMinEnergy );
 	assert ( energy<m_nMaxEnergy );
 	//G4cout << "material no " << materialIndex << " energy "<< energy << Gateendl;
+	if ( pSharedValues ) return GetSharedValue ( materialIndex,energy );
 	return operator() ( materialIndex )->GetValue ( energy,NotUsedAnyMoreIsOutOfRange );
 }
 
 inline G4double GateCrossSectionsTable::GetCrossSection ( size_t materialIndex, G4double energy, G4double density) const
 {
-	bool NotUsedAnyMoreIsOutOfRange;
-	assert ( size() >materialIndex );
-	assert ( energy>=m_nMinEnergy );
-	assert ( energy<m_nMaxEnergy );
-	return operator() ( materialIndex )->GetValue ( energy,NotUsedAnyMoreIsOutOfRange )*m_oInvDensity[materialIndex]*density;
+	return GetCrossSection ( materialIndex,energy )*m_oInvDensity[materialIndex]*density;
        }
 
        inline G4double GateCrossSectionsTable::GetCrossSection ( const G4Material* mat, G4double energy) const
@@ -0,0 +1,53 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+#ifndef GATEINDEXEDMINHEAP_HH
+#define GATEINDEXEDMINHEAP_HH
+
+#include <vector>
+#include "globals.hh"
+
+/*! \class  GateIndexedMinHeap
+    \brief  Binary min-heap of items 0..n-1 with a key each, the key of any item can be changed
+
+    - Build() heapifies n keys in O(n); GetTop() is O(1); Update() of any item is O(log n),
+      since the position of each item in the heap is stored.
+    - Items with equal keys are ordered by item index, so the top is deterministic.
+*/
+class GateIndexedMinHeap
+{
+public:
+  //! Build the heap from the keys; item i has key keys[i]
+  void Build(const std::vector<G4double>& keys);
+
+  //! Release the heap
+  void Clear();
+
+  //! Change the key of an item and restore the heap order
+  void Update(G4int item, G4double key);
+
+  inline G4bool IsEmpty() const { return mHeap.empty(); }
+  inline size_t GetSize() const { return mHeap.size(); }
+  //! Item with the smallest key (the heap must not be empty)
+  inline G4int GetTop() const { return mHeap[0]; }
+  inline G4double GetTopKey() const { return mKeys[mHeap[0]]; }
+  inline G4double GetKey(G4int item) const { return mKeys[item]; }
+
+protected:
+  inline G4bool IsLess(G4int a, G4int b) const
+  { return mKeys[a]<mKeys[b] || (mKeys[a]==mKeys[b] && a<b); }
+  void SiftUp(size_t pos);
+  void SiftDown(size_t pos);
+
+  std::vector<G4double> mKeys;     //!< key of each item
+  std::vector<G4int>    mHeap;     //!< item at each heap position
+  std::vector<size_t>   mPosition; //!< heap position of each item
+};
+
+#endif
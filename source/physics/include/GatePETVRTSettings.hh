@@ -15,6 +15,7 @@ See LICENSE.md for further details
 
 class G4Region;
 #include "GateVFictitiousMap.hh"
+#include "G4String.hh"
 
 typedef G4Region G4Envelope;
 class GateFictitiousFastSimulationModel;
@@ -41,6 +42,9 @@ public:
     void SetFictitiousEnergy(double);
     void SetDiscardEnergy(double); //should be equal or below fictitious energy
     void SetApproximations(GatePETVRT::Approx);
+    // file sharing the cross sections tables between the processes of a node (none if empty)
+    inline void SetCrossSectionsTableFile(const G4String& f) { m_sCrossSectionsTableFile=f; }
+    inline const G4String& GetCrossSectionsTableFile() const { return m_sCrossSectionsTableFile; }
 	
     inline G4Envelope* GetEnvelope() const;
     inline GateVFictitiousMap* GetFictitiousMap() const;
@@ -64,6 +68,7 @@ private:
     G4double m_nFictitiousEnergy;
     G4double m_nDiscardEnergy;
 	VerbosityLevel m_nVerbosityLevel;
+    G4String m_sCrossSectionsTableFile;
 };
 
 inline G4Envelope* GatePETVRTSettings::GetEnvelope() const
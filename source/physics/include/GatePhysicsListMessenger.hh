@@ -80,6 +80,7 @@ protected:
   G4UIcmdWithADoubleAndUnit * pMuHandlerSetAtomicShellEMin;
   G4UIcmdWithADoubleAndUnit * pMuHandlerSetAtomicShellTolerance;
   G4UIcmdWithADouble * pMuHandlerSetPrecision;
+  G4UIcmdWithAString * pMuHandlerSetCacheFile;
 
   G4UIcommand * pAddAtomDeexcitation;
   G4UIcmdWithAString * pAddPhysicsList;
@@ -22,6 +22,8 @@ public:
 
   GateRTPhantom * CheckGeometryAttached( G4String aname);
 
+  inline G4int GetNumberOfPhantoms() const { return m_RTPhantom.size(); }
+
 
   //! Used to create and access the OutputMgr
   static GateRTPhantomMgr* GetInstance() {
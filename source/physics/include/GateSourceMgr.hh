@@ -20,6 +20,8 @@
 #include "GateSourcePencilBeam.hh"
 #include "GateSourceTPSPencilBeam.hh"
 #include "GateSourceFastY90.hh"
+#include "GateAliasTable.hh"
+#include "GateIndexedMinHeap.hh"
 
 class GateSourceMgrMessenger;
 
@@ -39,6 +41,10 @@ class GateSourceMgrMessenger;
  * the beginning of the Run.
  * For each event, it decides which source is to be used and it asks to this source
  * to generate the primary vertices.
+ * With many sources, the choice does not loop over all the sources: in
+ * TotalAmountOfPrimaries mode the source is sampled from an alias table of the
+ * intensities, otherwise the absolute time of the next event of each source is kept
+ * in a min-heap and only the source that wins is asked for a new time.
  *
  * GateSourceMgr is a singleton.
  * @author G.Santin
@@ -129,6 +135,9 @@ public:
 protected:
   GateSourceMgr();
   G4int CheckSourceName( G4String sourceName );
+  void UpdateScheduler();
+  //! Absolute time of the next event of the source, drawn from time
+  G4double GetNextEventTime( GateVSource* source, G4double time );
 
   static GateSourceMgr*     mInstance;
   GateVSourceVector         mSources;
@@ -161,6 +170,11 @@ protected:
 
   std::vector<int>          mSourceID;
 
+  // Source selection, rebuilt when the sources change or at each run
+  GateAliasTable            mIntensityTable;   // intensity of each source (TotalAmountOfPrimaries mode)
+  GateIndexedMinHeap        mNextTimeHeap;     // absolute time of the next event of each source
+  G4bool                    mSchedulerNeedsUpdate;
+
   /* PY Descourt 08/09/2008 */
   G4int m_currentSourceID; // for detector mode
   GateVSource* m_fictiveSource; // idem
@@ -12,8 +12,10 @@
   \class  GateSourceOfPromptGammaData
 
   Manage a 3D distribution of prompt gamma, with 1 energy spectrum at
-  each voxel, stored as TH1D. For voxels with yield==0, the TH1D is not
-  instantiated/allocated.
+  each voxel. The voxel is sampled with an alias table, and the energy
+  with the cumulative distribution of the voxel spectrum, stored as
+  float in a single array shared by all voxels (the energy bins are
+  the same for all voxels). Voxels with yield==0 cost no memory.
 
 */
 
@@ -27,6 +29,7 @@
 #include "G4SPSEneDistribution.hh"
 #include "GateConfiguration.h"
 #include "GateImageOfHistograms.hh"
+#include "GateAliasTable.hh"
 
 //------------------------------------------------------------------------
 class GateSourceOfPromptGammaData
@@ -47,25 +50,25 @@ public:
 protected:
   // The 3D prompt gamma distribution
   GateImageOfHistograms * mImage;
-  std::vector<float> mDataCounts;
 
-  // Current pixel index for position in 3D space
-  int mCurrentIndex_i;
-  int mCurrentIndex_j;
-  int mCurrentIndex_k;
+  // Current voxel (index in the list of non-empty voxels), set by
+  // SampleRandomPosition and used by SampleRandomEnergy
+  int mCurrentVoxel;
 
-  // Physical coordinates from index coordinate
-  std::vector<double> mIndexCoordX;
-  std::vector<double> mIndexCoordY;
-  std::vector<double> mIndexCoordZ;
-
-  // The angular, position and energy generator
+  // The angular generator
   G4SPSAngDistribution mAngleGen;
-  //  std::vector<G4SPSEneDistribution> mEnergyGen;
-  std::vector<TH1D*> mEnergyGen;
-  G4SPSRandomGenerator mPositionXGen;
-  std::vector<G4SPSRandomGenerator*> mPositionYGen;
-  std::vector<std::vector<G4SPSRandomGenerator*> > mPositionZGen;
+
+  // Position: alias table over the non-empty voxels, and image index
+  // of each non-empty voxel
+  GateAliasTable mVoxelGen;
+  std::vector<unsigned int> mVoxelIndex;
+
+  // Energy: cumulative distribution of the spectrum of each non-empty
+  // voxel (nbOfBins values per voxel, the last one is 1)
+  std::vector<float> mEnergyCDF;
+  unsigned int mNbOfEnergyBins;
+  double mEnergyMin;
+  double mEnergyStep;
 
 }; // end class
 //------------------------------------------------------------------------
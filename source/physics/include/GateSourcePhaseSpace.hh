@@ -85,6 +85,7 @@ public:
   void SetUseNbOfParticleAsIntensity(bool b) { mUseNbOfParticleAsIntensity = b; }
 
   void SetRmax(float r) { mRmax = r; }
+  void SetUseRmaxIndexFile(bool b) { mUseRmaxIndexFile = b; }
   void SetSphereRadius(float r) { mSphereRadius = r; }
 
   void SetStartingParticleId(long id) { mStartingParticleId = id; }
@@ -97,6 +98,13 @@ public:
 
 protected:
 
+  // Sidecar file storing pListOfSelectedEvents for a given Rmax, so that
+  // the scan of the whole PhS is only done once. The file is tied to the
+  // name, size and modification time of every PhS file.
+  G4String GetRmaxIndexFileName() const;
+  std::string GetRmaxIndexHeader() const;
+  bool ReadRmaxIndexFile();
+  void WriteRmaxIndexFile() const;
 
   //TEntryList
   std::vector<unsigned int> pListOfSelectedEvents;
@@ -137,6 +145,7 @@ protected:
   bool mAlreadyLoad;
 
   float mRmax;
+  bool mUseRmaxIndexFile;
   double mSphereRadius;
 
   double px ;
@@ -148,6 +157,7 @@ protected:
   bool mPositionInWorldFrame;
 
   FILE* pIAEAFile;
+  std::vector<char> mIAEAReadBuffer;
   iaea_record_type *pIAEARecordType;
   iaea_header_type *pIAEAheader;
 
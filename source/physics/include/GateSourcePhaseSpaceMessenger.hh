@@ -50,6 +50,7 @@ private:
   G4UIcmdWithABool*          setUseNbParticleAsIntensityCmd;
   G4UIcmdWithABool*          ignoreWeightCmd;
   G4UIcmdWithADoubleAndUnit* setRmaxCmd;
+  G4UIcmdWithABool*          useRmaxIndexFileCmd;
   G4UIcmdWithADoubleAndUnit* setSphereRadiusCmd;
   G4UIcmdWithADouble*        setStartIdCmd;
   G4UIcmdWithAnInteger*      setPytorchBatchSizeCmd;
@@ -95,6 +95,7 @@ public:
 protected:
 
   void ConfigurePencilBeam();
+  GateSourcePencilBeam* CreatePencilBeam(double energy);
   GateSourceTPSPencilBeamMessenger * pMessenger;
 
   bool mIsInitialized;
@@ -104,7 +105,9 @@ protected:
   bool mIsASourceDescriptionFile;
   G4String mSourceDescriptionFile;
 
-  GateSourcePencilBeam* mPencilBeam;
+  GateSourcePencilBeam* mPencilBeam; // pencil beam of the current spot
+  std::vector<GateSourcePencilBeam*> mPencilBeams; // one per energy layer
+  std::vector<int> mSpotPencilBeam; // index in mPencilBeams for each spot
   double mDistanceSMXToIsocenter;
   double mDistanceSMYToIsocenter;
   double mDistanceSourcePatient;
@@ -147,7 +150,7 @@ protected:
   std::vector<int> mSpotLayer; //in which layer is this spot?
   std::vector<double> mSpotEnergy;
   std::vector<double> mSpotWeight; // (proportional to) the expected number (for each bin in a multinomial distribution)
-  std::vector<int> mNbIonsToGenerate; // the actual number (for each bin in a multinomial distribution)
+  std::vector<long int> mNbIonsToGenerate; // the actual number (for each bin in a multinomial distribution)
   std::vector<G4ThreeVector> mSpotPosition, mSpotRotation;
 };
 //------------------------------------------------------------------------------------------------------
@@ -26,6 +26,7 @@ class G4String;
 #include "G4Gamma.hh"
 #include "G4PhysicsTable.hh"
 #include "GateCrossSectionsTable.hh"
+#include "GateSharedTableFile.hh"
 #include "CLHEP/Random/RandFlat.h" 
 #include <iostream>
 #include "Randomize.hh"
@@ -58,6 +59,12 @@ class GateTotalDiscreteProcess : public G4VDiscreteProcess
 
 		void BuildCrossSectionsTables();
 
+		// Tables shared between the processes of a node (GatePETVRTSettings::GetCrossSectionsTableFile)
+		uint64_t ComputeCrossSectionsTablesHash() const;
+		bool AttachCrossSectionsTables(const G4String& fileName);
+		void WriteCrossSectionsTables(const G4String& fileName) const;
+		GateSharedTableFile m_oCrossSectionsTableFile;
+
 		G4int m_nNumProcesses, m_nMaxNumProcesses;
 		bool m_nInitialized;
 		const G4ParticleDefinition* pParticleType;
@@ -40,7 +40,7 @@ public:
   virtual void SetName( G4String value ) { m_name = value; }
   virtual G4String GetName()             { return m_name; }
 
-  virtual void SetType( G4String value ) { m_type = value; }
+  virtual void SetType( G4String value ) { m_type = value; m_kind = GetSourceKind(value); }
   virtual G4String GetType()             { return m_type; }
 
   virtual void SetSourceID(G4int value)  { m_sourceID = value; }
@@ -145,6 +145,10 @@ private:
   static GateColorMap theColorMap;
 
 protected:
+  //! Primary generation method of the source, resolved from its type when it is set
+  enum SourceKind { kGPSSource, kBackToBackSource, kFastI124Source, kUnknownSource };
+  static SourceKind GetSourceKind( const G4String& type );
+
   GateVSourceMessenger*               m_sourceMessenger;
   GateSingleParticleSourceMessenger*  m_SPSMessenger ;
   GateSPSPosDistribution*             m_posSPS;
@@ -156,6 +160,7 @@ protected:
 
   G4String   m_name;         // source name
   G4String   m_type;         // source type
+  SourceKind m_kind;         // source type, as used by GeneratePrimaries
   G4int      m_sourceID;     // source progressive number
   G4double   m_activity;     // activity of the source (e.g. # becquerel)
   G4double   m_startTime;
@@ -0,0 +1,69 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GateAliasTable.hh"
+
+//-------------------------------------------------------------------------------------------------
+void GateAliasTable::Build(const std::vector<G4double>& weights)
+{
+  Clear();
+
+  // Keep only the non-zero weights
+  size_t n = 0;
+  for (size_t i=0; i<weights.size(); i++)
+    if (weights[i]>0.0) n++;
+  if (n==0) return;
+
+  mIndex.reserve(n);
+  mThreshold.reserve(n);
+  for (size_t i=0; i<weights.size(); i++) {
+    if (weights[i]>0.0) {
+      mIndex.push_back(i);
+      mThreshold.push_back(weights[i]);
+      mTotalWeight += weights[i];
+    }
+  }
+  mAlias.resize(n);
+
+  // Vose's algorithm: scaled probabilities are split between the bins below
+  // and above the mean, and each small bin is completed by a large one.
+  std::vector<G4int> small, large;
+  small.reserve(n);
+  large.reserve(n);
+  for (size_t i=0; i<n; i++) {
+    mThreshold[i] *= n/mTotalWeight;
+    mAlias[i] = i;
+    if (mThreshold[i]<1.0) small.push_back(i);
+    else large.push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    G4int s = small.back(); small.pop_back();
+    G4int l = large.back();
+    mAlias[s] = l;
+    mThreshold[l] -= 1.0 - mThreshold[s];
+    if (mThreshold[l]<1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // Remaining bins are full (up to rounding errors)
+  for (size_t i=0; i<large.size(); i++) mThreshold[large[i]] = 1.0;
+  for (size_t i=0; i<small.size(); i++) mThreshold[small[i]] = 1.0;
+}
+//-------------------------------------------------------------------------------------------------
+
+
+//-------------------------------------------------------------------------------------------------
+void GateAliasTable::Clear()
+{
+  std::vector<G4double>().swap(mThreshold);
+  std::vector<G4int>().swap(mAlias);
+  std::vector<G4int>().swap(mIndex);
+  mTotalWeight = 0.;
+}
+//-------------------------------------------------------------------------------------------------
@@ -33,7 +33,7 @@ G4int GateCrossSectionsTable::PARTICLE_NAME_LENGTH=20;
 
 //G4EmCalculator GateCrossSectionsTable::m_sEmCalculator;
 
-GateCrossSectionsTable::GateCrossSectionsTable ( G4double minEnergy, G4double maxEnergy,  G4int physicsVectorBinNumber, const G4ParticleDefinition* pdef, const vector<G4VDiscreteProcess*>& processes ) :G4PhysicsTable(),m_oInvDensity(),m_oMaterialVec(), m_oProcessVec ( processes ),m_pMaxCrossSection ( NULL )
+GateCrossSectionsTable::GateCrossSectionsTable ( G4double minEnergy, G4double maxEnergy,  G4int physicsVectorBinNumber, const G4ParticleDefinition* pdef, const vector<G4VDiscreteProcess*>& processes ) :G4PhysicsTable(),m_oInvDensity(),m_oMaterialVec(), m_oProcessVec ( processes ),m_pMaxCrossSection ( NULL ),pSharedValues ( NULL )
 {
 	assert ( pdef == G4Gamma::GammaDefinition() ); // perhaps it works for other particles, perhaps not... did not think about that
 	m_nMinEnergy=minEnergy;
@@ -49,7 +49,7 @@ GateCrossSectionsTable::GateCrossSectionsTable ( G4double minEnergy, G4double ma
 
 }
 
-GateCrossSectionsTable::GateCrossSectionsTable ( G4double minEnergy, G4double maxEnergy,  G4int physicsVectorBinNumber, const G4ParticleDefinition* pdef, G4VDiscreteProcess& process ) :G4PhysicsTable(),m_oInvDensity(),m_oMaterialVec(), m_oProcessVec ( 1, &process ),m_pMaxCrossSection ( NULL )
+GateCrossSectionsTable::GateCrossSectionsTable ( G4double minEnergy, G4double maxEnergy,  G4int physicsVectorBinNumber, const G4ParticleDefinition* pdef, G4VDiscreteProcess& process ) :G4PhysicsTable(),m_oInvDensity(),m_oMaterialVec(), m_oProcessVec ( 1, &process ),m_pMaxCrossSection ( NULL ),pSharedValues ( NULL )
 {
 
 	assert ( pdef == G4Gamma::GammaDefinition() ); // perhaps it works for other particles, perhaps not... did not think about that
@@ -66,7 +66,7 @@ GateCrossSectionsTable::GateCrossSectionsTable ( G4double minEnergy, G4double ma
 
 }
 
-GateCrossSectionsTable::GateCrossSectionsTable ( std::ifstream& in, bool ascii, const vector<G4VDiscreteProcess*>& processes ) :G4PhysicsTable(),m_oInvDensity(),m_oMaterialVec(), m_oProcessVec ( processes ),m_pMaxCrossSection ( NULL )
+GateCrossSectionsTable::GateCrossSectionsTable ( std::ifstream& in, bool ascii, const vector<G4VDiscreteProcess*>& processes ) :G4PhysicsTable(),m_oInvDensity(),m_oMaterialVec(), m_oProcessVec ( processes ),m_pMaxCrossSection ( NULL ),pSharedValues ( NULL )
 {
 	GatePETVRTManager* man=GatePETVRTManager::GetInstance();
 	pMaterialTableToProductionCutsTable=man->GetMaterialTableToProductionCutsTable();
@@ -92,6 +92,10 @@ size_t GateCrossSectionsTable::AddMaterial ( const G4MaterialCutsCouple* couple
 
         static G4EmCalculator m_sEmCalculator;
 
+	if ( pSharedValues!=NULL )
+	{
+		G4Exception ( "GateCrossSectionsTable::AddMaterial(const G4MaterialCutsCouple*)", "InvalidSetup", FatalException,"Cannot add a material to a table attached to shared values." );
+	}
 	if ( m_pMaxCrossSection!=NULL )
 	{
 		G4cout << "GateCrossSectionsTable::AddMaterial( const G4Material* mat ) : Added material AFTER building maximal! This will most probably lead to wrong results!\n";
@@ -227,6 +231,36 @@ size_t GateCrossSectionsTable::SetAndBuildProductionMaterialTable () // returns
 	return ( size()-1 );
 }
 
+size_t GateCrossSectionsTable::SetProductionMaterialTable ( const double* sharedValues ) // returns index of last material
+{
+	if ( size() >0 || pSharedValues!=NULL )
+		G4cout << "GateCrossSectionsTable::SetProductionMaterialTable (): Delete old materials in table!\n";
+	clearAndDestroy();
+	m_oInvDensity.clear();
+	m_oMaterialVec.clear();
+	const G4ProductionCutsTable* table=G4ProductionCutsTable::GetProductionCutsTable ();
+	size_t	nMaterials = table->GetTableSize ();
+
+	pMaterialTableToProductionCutsTable->Update();
+	for ( size_t m=0; m<nMaterials; m++ )
+	{
+		const G4MaterialCutsCouple* couple=table->GetMaterialCutsCouple ( m );
+		assert ( pMaterialTableToProductionCutsTable->P2M ( m ) ==static_cast<G4int> ( couple->GetMaterial()->GetIndex() ) );
+		m_oInvDensity.push_back ( 1./couple->GetMaterial()->GetDensity() );
+		m_oMaterialVec.push_back ( couple->GetMaterial() );
+	}
+	pSharedValues=sharedValues;
+	CheckInternalProductionMaterialTable(); // can be removed later, just to be sure
+	return ( m_oMaterialVec.size()-1 );
+}
+
+void GateCrossSectionsTable::AppendSharedValues ( std::vector<double>& values ) const
+{
+	for ( size_t m=0;m<m_oInvDensity.size();m++ )
+		for ( size_t i=0;i<GetNumberOfSharedValues();i++ )
+			values.push_back ( GetNodeValue ( m,i ) );
+}
+
 G4int GateCrossSectionsTable::GetIndex ( const G4Material* mat ) const
 {
 	return pMaterialTableToProductionCutsTable->M2P ( mat->GetIndex() );
@@ -294,7 +328,7 @@ bool GateCrossSectionsTable::BuildMaxCrossSection ( const vector<G4Material*> &
 		for ( size_t j=0;j<involved_mat_index.size();j++ )
 		{
 
-			if ( operator[] ( involved_mat_index[j] )->operator[] ( i ) >b ) b=operator[] ( involved_mat_index[j] )->operator[] ( i );
+			if ( GetNodeValue ( involved_mat_index[j],i ) >b ) b=GetNodeValue ( involved_mat_index[j],i );
 		}
 		if (b<0)
 		{
@@ -390,6 +424,7 @@ void GateCrossSectionsTable::RetrieveTable ( std::ifstream& in, bool ascii )
 		in.read ( reinterpret_cast<char*> ( &tmpsize ) ,sizeof ( tmpsize ) );
 	}
 	clearAndDestroy();
+	pSharedValues=NULL;
 	m_oInvDensity.resize ( tmpsize );
 
 	for ( size_t i=0;i<tmpsize; i++ )
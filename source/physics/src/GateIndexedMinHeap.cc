@@ -0,0 +1,83 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GateIndexedMinHeap.hh"
+
+//-------------------------------------------------------------------------------------------------
+void GateIndexedMinHeap::Build(const std::vector<G4double>& keys)
+{
+  mKeys = keys;
+  const size_t n = keys.size();
+  mHeap.resize(n);
+  mPosition.resize(n);
+  for (size_t i=0; i<n; i++) {
+    mHeap[i] = i;
+    mPosition[i] = i;
+  }
+  // Floyd's heap construction, from the last parent to the root
+  for (size_t i=n/2; i>0; i--) SiftDown(i-1);
+}
+//-------------------------------------------------------------------------------------------------
+
+
+//-------------------------------------------------------------------------------------------------
+void GateIndexedMinHeap::Clear()
+{
+  mKeys.clear();
+  mHeap.clear();
+  mPosition.clear();
+}
+//-------------------------------------------------------------------------------------------------
+
+
+//-------------------------------------------------------------------------------------------------
+void GateIndexedMinHeap::Update(G4int item, G4double key)
+{
+  const G4double oldKey = mKeys[item];
+  mKeys[item] = key;
+  if (key<oldKey) SiftUp(mPosition[item]);
+  else SiftDown(mPosition[item]);
+}
+//-------------------------------------------------------------------------------------------------
+
+
+//-------------------------------------------------------------------------------------------------
+void GateIndexedMinHeap::SiftUp(size_t pos)
+{
+  const G4int item = mHeap[pos];
+  while (pos>0) {
+    const size_t parent = (pos-1)/2;
+    if (!IsLess(item, mHeap[parent])) break;
+    mHeap[pos] = mHeap[parent];
+    mPosition[mHeap[pos]] = pos;
+    pos = parent;
+  }
+  mHeap[pos] = item;
+  mPosition[item] = pos;
+}
+//-------------------------------------------------------------------------------------------------
+
+
+//-------------------------------------------------------------------------------------------------
+void GateIndexedMinHeap::SiftDown(size_t pos)
+{
+  const size_t n = mHeap.size();
+  const G4int item = mHeap[pos];
+  while (true) {
+    size_t child = 2*pos+1;
+    if (child>=n) break;
+    if (child+1<n && IsLess(mHeap[child+1], mHeap[child])) child++;
+    if (!IsLess(mHeap[child], item)) break;
+    mHeap[pos] = mHeap[child];
+    mPosition[mHeap[pos]] = pos;
+    pos = child;
+  }
+  mHeap[pos] = item;
+  mPosition[item] = pos;
+}
+//-------------------------------------------------------------------------------------------------
@@ -59,6 +59,7 @@ GatePhysicsListMessenger::~GatePhysicsListMessenger()
   delete pMuHandlerSetENumber;
   delete pMuHandlerSetAtomicShellEMin;
   delete pMuHandlerSetPrecision;
+  delete pMuHandlerSetCacheFile;
 
   delete pAddAtomDeexcitation;
   delete pAddPhysicsList;
@@ -230,6 +231,11 @@ void GatePhysicsListMessenger::BuildCommands(G4String base)
   guidance = "Set precision to be reached in %";
   pMuHandlerSetPrecision->SetGuidance(guidance);
 
+  bb = base+"/MuHandler/setCacheFile";
+  pMuHandlerSetCacheFile = new G4UIcmdWithAString(bb,this);
+  guidance = "Set a file to share the mu/muen tables between processes: the tables are attached from it (memory mapped) if it was built for the same materials and options, otherwise they are built and written to it";
+  pMuHandlerSetCacheFile->SetGuidance(guidance);
+
   bb = base+"/addAtomDeexcitation";
   pAddAtomDeexcitation = new G4UIcommand(bb,this);
   guidance = "Add atom deexcitation into the energy loss table manager";
@@ -424,6 +430,10 @@ void GatePhysicsListMessenger::SetNewValue(G4UIcommand* command, G4String param)
     nMuHandler->SetPrecision(val);
     GateMessage("Physic", 1, "(MuHandler Options) Precision set to "<<val<<". Precision defaut Value: 0.01\n");
   }
+  if(command == pMuHandlerSetCacheFile){
+    nMuHandler->SetCacheFileName(param);
+    GateMessage("Physic", 1, "(MuHandler Options) Tables shared through the file "<<param<<".\n");
+  }
 
   if (command == pAddAtomDeexcitation) {
     pPhylist->AddAtomDeexcitation();
@@ -52,6 +52,7 @@ GateSourceMgr::GateSourceMgr()
   m_currentSourceID = -1;
   mTotalIntensity=0.;
   m_launchLastBuffer = false;
+  mSchedulerNeedsUpdate = true;
 }
 //----------------------------------------------------------------------------------------
 
@@ -74,6 +75,7 @@ GateSourceMgr::~GateSourceMgr()
 G4int GateSourceMgr::AddSource( GateVSource* pSource )
 {
   mSources.push_back( pSource );
+  mSchedulerNeedsUpdate = true;
   return 0;
 }
 //----------------------------------------------------------------------------------------
@@ -88,6 +90,7 @@ G4int GateSourceMgr::RemoveSource( G4String name )
       for( size_t is = 0; is != mSources.size(); ++is )//Use an iterator??
         delete mSources[is];
       mSources.clear();
+      mSchedulerNeedsUpdate = true;
       if( mVerboseLevel > 0 )
         G4cout << "GateSourceMgr::RemoveSource : all sources removed \n";
       return 0;
@@ -100,6 +103,7 @@ G4int GateSourceMgr::RemoveSource( G4String name )
         {
           delete *itr;
           mSources.erase( itr );
+          mSchedulerNeedsUpdate = true;
           if( mVerboseLevel > 0 )
             G4cout << "GateSourceMgr::RemoveSource : source <" << name
                    << "> removed\n";
@@ -242,6 +246,7 @@ G4int GateSourceMgr::AddSource( std::vector<G4String> sourceVec )
       }
 
     mSources.push_back( source );
+    mSchedulerNeedsUpdate = true;
     m_sourceProgressiveNumber++;
   }
   else
@@ -313,20 +318,32 @@ GateVSource* GateSourceMgr::GetNextSource()
 
   G4double aTime;
 
+  if( mSchedulerNeedsUpdate ) UpdateScheduler();
+
   if (IsTotalAmountOfPrimariesModeEnabled()) {
-    G4double randNumber = G4UniformRand()*mTotalIntensity;
-    G4double sumIntensity=0.;
-    G4int currentSourceNumber = 0;
-    while ( (currentSourceNumber<(int)mSources.size()) && (sumIntensity<=randNumber)){
-      pFirstSource = mSources[ currentSourceNumber ];
-      sumIntensity += pFirstSource->GetIntensity();
-      currentSourceNumber++;
-    }
+    G4int currentSourceNumber = mIntensityTable.Sample( G4UniformRand() );
+    if( currentSourceNumber < 0 )
+      GateError( "GateSourceMgr::GetNextSource : the intensities of all the sources are null" );
+    pFirstSource = mSources[ currentSourceNumber ];
 
     m_firstTime = GateApplicationMgr::GetInstance()->GetTimeStepInTotalAmountOfPrimariesMode();
   }
+  else if( GateRTPhantomMgr::GetInstance()->GetNumberOfPhantoms() == 0 ) {
+    // the source with the earliest next event wins, then proposes its following event
+    G4int currentSourceNumber = mNextTimeHeap.GetTop();
+    pFirstSource = mSources[ currentSourceNumber ];
+    G4double eventTime = mNextTimeHeap.GetTopKey();
+    m_firstTime = eventTime - m_time;
+    aTime = GetNextEventTime( pFirstSource, eventTime );
+    mNextTimeHeap.Update( currentSourceNumber, aTime );
+    if( mVerboseLevel > 1 )
+      G4cout << "GateSourceMgr::GetNextSource : source "
+             << pFirstSource->GetName()
+             << "    Next time (s) : " << m_firstTime/s
+             << "   following time (s) : " << ( aTime - eventTime )/s << Gateendl;
+  }
   else {
-    // if there is at least one source
+    // with RT phantoms the activities change at each event (UpdatePhantoms):
     // make a competition among all the available sources
     // the source that proposes the shortest interval for the next event wins
     GateVSourceVector::iterator itr;
@@ -354,6 +371,38 @@ GateVSource* GateSourceMgr::GetNextSource()
 //----------------------------------------------------------------------------------------
 
 
+//----------------------------------------------------------------------------------------
+void GateSourceMgr::UpdateScheduler()
+{
+  mIntensityTable.Clear();
+  mNextTimeHeap.Clear();
+  if (IsTotalAmountOfPrimariesModeEnabled()) {
+    std::vector<G4double> intensities( mSources.size() );
+    for( size_t i = 0; i != mSources.size(); ++i )
+      intensities[i] = mSources[i]->GetIntensity();
+    mIntensityTable.Build( intensities );
+  }
+  else if( GateRTPhantomMgr::GetInstance()->GetNumberOfPhantoms() == 0 ) {
+    std::vector<G4double> nextTimes( mSources.size() );
+    for( size_t i = 0; i != mSources.size(); ++i )
+      nextTimes[i] = GetNextEventTime( mSources[i], m_time );
+    mNextTimeHeap.Build( nextTimes );
+  }
+  mSchedulerNeedsUpdate = false;
+}
+//----------------------------------------------------------------------------------------
+
+
+//----------------------------------------------------------------------------------------
+G4double GateSourceMgr::GetNextEventTime( GateVSource* source, G4double time )
+{
+  // a source that is not started yet proposes its first event from its start time
+  if( source->GetStartTime() > time ) time = source->GetStartTime();
+  return time + source->GetNextTime( time );
+}
+//----------------------------------------------------------------------------------------
+
+
 //----------------------------------------------------------------------------------------
 void GateSourceMgr::ListSources()
 {
@@ -434,6 +483,7 @@ void GateSourceMgr::Initialization()//std::vector<G4double> * time, std::vector<
       if((*itr)->GetIntensity()==0) GateError("Intensity of the source should not be null");
       mTotalIntensity += (*itr)->GetIntensity();// intensity;
     }
+  mSchedulerNeedsUpdate = true;
 
 }
 //----------------------------------------------------------------------------------------
@@ -500,6 +550,9 @@ G4int GateSourceMgr::PrepareNextRun( const G4Run* r)
   for(GateVSourceVector::iterator itr = mSources.begin(); itr != mSources.end(); ++itr )
     (*itr)->Update(m_time);
 
+  // next times are drawn again from the beginning of the run
+  mSchedulerNeedsUpdate = true;
+
 
 //  m_runNumber++;
 
@@ -14,10 +14,16 @@
 #include "G4Gamma.hh"
 #include "GateRandomEngine.hh"
 
+#include <algorithm>
+
 //------------------------------------------------------------------------
 GateSourceOfPromptGammaData::GateSourceOfPromptGammaData()
 {
-    computesum = 0;
+  computesum = 0;
+  mCurrentVoxel = -1;
+  mNbOfEnergyBins = 0;
+  mEnergyMin = 0.0;
+  mEnergyStep = 0.0;
 }
 //------------------------------------------------------------------------
 
@@ -25,11 +31,6 @@ GateSourceOfPromptGammaData::GateSourceOfPromptGammaData()
 //------------------------------------------------------------------------
 GateSourceOfPromptGammaData::~GateSourceOfPromptGammaData()
 {
-  for(unsigned int i=0; i< mPositionYGen.size(); i++)
-    delete mPositionYGen[i];
-  for(unsigned int i=0; i< mPositionZGen.size(); i++)
-    for(unsigned int j=0; i< mPositionZGen[i].size(); j++)
-      delete mPositionZGen[i][j];
 }
 //------------------------------------------------------------------------
 
@@ -50,79 +51,45 @@ void GateSourceOfPromptGammaData::Initialize()
   unsigned int sizeY = mImage->GetResolution().y();
   unsigned int sizeZ = mImage->GetResolution().z();
   unsigned int nbOfBins = mImage->GetNbOfBins();
-  unsigned long nbOfValues = sizeX*sizeY*sizeZ;
-
-  // Random generators for position: set sizes
-  mPositionYGen.resize(sizeX);
-  mPositionZGen.resize(sizeX);
-  for(unsigned int i=0; i<sizeX; i++) {
-    mPositionZGen[i].resize(sizeY);
-  }
-
-  // Build the scalar image with total number of counts at each pixel
-  mImage->ComputeTotalOfCountsImageDataFloat(mDataCounts);
+  unsigned long nbOfValues = (unsigned long)sizeX*sizeY*sizeZ;
+  float * data = mImage->GetDataFloatPointer();
   computesum = mImage->ComputeSum();
 
-  // Initialize random generator for position. Loop over the total
-  // count scalar image (mDataCounts)
-  mPositionXGen.SetXBias(G4ThreeVector(0., 0., 0.)); // important
-  for(unsigned int i=0; i<sizeX; i++) {
-    double sumYZ = 0.0;
-    mPositionYGen[i] = new G4SPSRandomGenerator;
-    mPositionYGen[i]->SetYBias(G4ThreeVector(0., 0., 0.)); // important
-    for(unsigned int j=0; j<sizeY; j++) {
-      double sumZ = 0.0;
-      mPositionZGen[i][j] = new G4SPSRandomGenerator;
-      mPositionZGen[i][j]->SetZBias(G4ThreeVector(0., 0., 0.)); // important
-      for(unsigned int k=0; k<sizeZ; k++) {
-        double val = mDataCounts[mImage->GetIndexFromPixelIndex(i, j, k)];
-        sumZ += val;
-        // Bias the Z component according to the voxel value
-        mPositionZGen[i][j]->SetZBias(G4ThreeVector(k+1 ,val,0.));
-      }
-      sumYZ += sumZ;
-      // Bias the Y component according to integration over Z
-      mPositionYGen[i]->SetYBias(G4ThreeVector(j+1, sumZ,0.));
+  // Energy bins, the same for all voxels
+  mNbOfEnergyBins = nbOfBins;
+  mEnergyMin = mImage->GetMinValue();
+  mEnergyStep = (mImage->GetMaxValue()-mImage->GetMinValue())/nbOfBins;
+
+  // Total of counts of each voxel; only the non-empty voxels are kept
+  std::vector<double> weights;
+  mVoxelIndex.clear();
+  for(unsigned long index_image=0; index_image<nbOfValues; index_image++) {
+    const float * spectrum = data + index_image*nbOfBins;
+    double sum = 0.0;
+    for(unsigned int l=0; l<nbOfBins; l++) sum += spectrum[l];
+    if (sum > 0.0) {
+      weights.push_back(sum);
+      mVoxelIndex.push_back(index_image);
     }
-    // Bias the X component according to integration over YZ plane
-    mPositionXGen.SetXBias(G4ThreeVector(i+1, sumYZ,0.));
   }
-
-  // Initialize energy.
-  mEnergyGen.resize(nbOfValues);
-  double energyStep  = (mImage->GetMaxValue()-mImage->GetMinValue())/nbOfBins;
-  double energy = 0.0;
-  long index_image = 0;
-  long index_data = 0;
-  float * data = mImage->GetDataFloatPointer();
-  long nbNonZero = 0;
-
-  // We only create TH1D for non zero pixel.
-  for(unsigned int k=0; k<sizeZ; k++) {
-    for(unsigned int j=0; j<sizeY; j++) {
-      for(unsigned int i=0; i<sizeX; i++) {
-        if (mDataCounts[index_image] == 0) { // FIXME
-          index_data+=nbOfBins;
-        }
-        else {
-          energy = mImage->GetMinValue();
-          mEnergyGen[index_image] = new TH1D;
-          // This is much much faster to use the constructor without
-          // param, the SetBins than using the following line with constructor :
-          // new TH1D("", "", nbOfBins, mImage->GetMinValue(), mImage->GetMaxValue());
-          TH1D * h = mEnergyGen[index_image];
-          h->SetBins(nbOfBins, mImage->GetMinValue(), mImage->GetMaxValue());
-          for(unsigned int l=0; l<nbOfBins; l++) {
-            h->Fill(energy, data[index_data]);
-            index_data++;
-            energy += energyStep;
-          }
-          nbNonZero++;
-        }
-        index_image++;
-      }
+  mVoxelGen.Build(weights);
+
+  // Cumulative distribution of the spectrum of each non-empty voxel
+  mEnergyCDF.resize(mVoxelIndex.size()*nbOfBins);
+  for(unsigned int v=0; v<mVoxelIndex.size(); v++) {
+    const float * spectrum = data + (unsigned long)mVoxelIndex[v]*nbOfBins;
+    float * cdf = &mEnergyCDF[(unsigned long)v*nbOfBins];
+    double sum = 0.0;
+    for(unsigned int l=0; l<nbOfBins; l++) {
+      if (spectrum[l] > 0.0) sum += spectrum[l]; // as TH1::GetRandom, negative bins are ignored
+      cdf[l] = sum/weights[v];
     }
+    cdf[nbOfBins-1] = 1.0;
   }
+  GateMessage("Beam", 1, "Prompt gamma source: " << mVoxelIndex.size() << " non-empty voxels over "
+              << nbOfValues << ", sampling tables "
+              << (mVoxelGen.GetMemorySize() + mVoxelIndex.size()*sizeof(unsigned int)
+                  + mEnergyCDF.size()*sizeof(float))/1024 << " kB\n");
 
   // Initialize direction sampling
   G4SPSRandomGenerator * biasRndm = new G4SPSRandomGenerator;
@@ -140,30 +107,22 @@ void GateSourceOfPromptGammaData::Initialize()
 //------------------------------------------------------------------------
 void GateSourceOfPromptGammaData::SampleRandomPosition(G4ThreeVector & position)
 {
-  // Random 3D position (in pixel). If size == 1, then bug in GenRand
-  // (infinite loop), so we test and set random value [0:1]
-  double x;
-  if (mImage->GetResolution().x() == 1) x=G4UniformRand();
-  else x = mPositionXGen.GenRandX();
-  int i =  mCurrentIndex_i = floor(x);
-  double y;
-  if (mImage->GetResolution().y() == 1) y=G4UniformRand();
-  else y = mPositionYGen[i]->GenRandY();
-  int j = mCurrentIndex_j = floor(y);
-  double z;
-  if (mImage->GetResolution().z() == 1) z=G4UniformRand();
-  else  z = mPositionZGen[i][j]->GenRandZ();
-  mCurrentIndex_k = floor(z);
+  // Random voxel, then uniform position in the voxel
+  mCurrentVoxel = mVoxelGen.Sample(G4UniformRand());
+  if (mCurrentVoxel < 0) {
+    GateError("The prompt gamma distribution is empty (no voxel with a non-zero yield)");
+  }
+  long index = mVoxelIndex[mCurrentVoxel];
+  long sizeX = mImage->GetResolution().x();
+  long sizePlane = sizeX*(long)mImage->GetResolution().y();
+  int k = index / sizePlane;
+  int j = (index - k*sizePlane) / sizeX;
+  int i = index - k*sizePlane - j*sizeX;
 
   // Offset according to image origin (and half voxel position)
-  x = mImage->GetOrigin().x() + x*mImage->GetVoxelSize().x();
-  y = mImage->GetOrigin().y() + y*mImage->GetVoxelSize().y();
-  z = mImage->GetOrigin().z() + z*mImage->GetVoxelSize().z();
-
-  // Vector
-  position.setX(x);
-  position.setY(y);
-  position.setZ(z);
+  position.setX(mImage->GetOrigin().x() + (i+G4UniformRand())*mImage->GetVoxelSize().x());
+  position.setY(mImage->GetOrigin().y() + (j+G4UniformRand())*mImage->GetVoxelSize().y());
+  position.setZ(mImage->GetOrigin().z() + (k+G4UniformRand())*mImage->GetVoxelSize().z());
 }
 //------------------------------------------------------------------------
 
@@ -171,13 +130,18 @@ void GateSourceOfPromptGammaData::SampleRandomPosition(G4ThreeVector & position)
 //------------------------------------------------------------------------
 void GateSourceOfPromptGammaData::SampleRandomEnergy(double & energy)
 {
-  // Get energy spectrum in the current pixel
-  long index = mImage->GetIndexFromPixelIndex(mCurrentIndex_i, mCurrentIndex_j, mCurrentIndex_k);
-
-  if (mDataCounts[index] != 0) {
-    energy = mEnergyGen[index]->GetRandom();
+  // Sample the spectrum of the current voxel, linear inside the bin (as TH1::GetRandom)
+  if (mCurrentVoxel < 0) {
+    energy = 0.0;
+    return;
   }
-  else energy = 0.0;
+  const float * cdf = &mEnergyCDF[(unsigned long)mCurrentVoxel*mNbOfEnergyBins];
+  double r = G4UniformRand();
+  unsigned int bin = std::upper_bound(cdf, cdf+mNbOfEnergyBins, r) - cdf;
+  if (bin >= mNbOfEnergyBins) bin = mNbOfEnergyBins-1;
+  double low = (bin == 0) ? 0.0 : cdf[bin-1];
+  double frac = (cdf[bin] > low) ? (r-low)/(cdf[bin]-low) : 0.0;
+  energy = mEnergyMin + (bin+frac)*mEnergyStep;
 }
 //------------------------------------------------------------------------
 
@@ -77,6 +77,7 @@ GateSourcePencilBeam::GateSourcePencilBeam(G4String name, bool useMessenger):
   mTestFlag=false;
   mIsInitialized=false;
   mCurrentParticleNumber=0;
+  pMessenger = NULL;
   if (useMessenger) pMessenger = new GateSourcePencilBeamMessenger(this);
 }
 
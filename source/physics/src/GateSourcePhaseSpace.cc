@@ -35,6 +35,10 @@
 #include "GateApplicationMgr.hh"
 #include "GateFileExceptions.hh"
 #include <chrono>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <fcntl.h>
 
 typedef unsigned int uint;
 
@@ -87,6 +91,7 @@ GateSourcePhaseSpace::GateSourcePhaseSpace(G4String name ):
   mTotalSimuTime = 0.;
   mAlreadyLoad = false;
   mRmax=0;
+  mUseRmaxIndexFile = false;
   mSphereRadius = -1;
   mCurrentParticleInIAEAFiles = 0;
   mCurrentUsedParticleInIAEAFiles = 0;
@@ -121,12 +126,13 @@ void GateSourcePhaseSpace::Initialize()
     int totalEventInFile = 0;
     mCurrentParticleNumberInFile = -1;
     G4String IAEAFileName  = " ";
+    bool indexRead = (mRmax>0 && ReadRmaxIndexFile());
     for(uint j=0;j<listOfPhaseSpaceFile.size();j++) {
       IAEAFileName = G4String(removeExtension(listOfPhaseSpaceFile[j]));
       totalEventInFile = OpenIAEAFile(IAEAFileName);
       mTotalNumberOfParticles += totalEventInFile;
 
-      if (mRmax>0){
+      if (mRmax>0 && !indexRead){
         for(int j=0 ; j<totalEventInFile ; j++) {
           pIAEARecordType->read_particle();
           if (std::abs(pIAEARecordType->x*cm)<mRmax && std::abs(pIAEARecordType->y*cm)<mRmax) {
@@ -137,7 +143,10 @@ void GateSourcePhaseSpace::Initialize()
         }
       }
     }
-    if (mRmax>0) mTotalNumberOfParticles = pListOfSelectedEvents.size();
+    if (mRmax>0) {
+      if (!indexRead) WriteRmaxIndexFile();
+      mTotalNumberOfParticles = pListOfSelectedEvents.size();
+    }
   }
 
   else if (mFileType == "pytorch") {
@@ -182,11 +191,14 @@ void GateSourcePhaseSpace::Initialize()
     }
 
     if (mRmax>0){
-      for(int i = 0; i < mTotalNumberOfParticles;i++) {
-        mChain.read_entrie(i);
-        if (std::abs(x)<mRmax && std::abs(y)<mRmax) {
-          pListOfSelectedEvents.push_back(i);
+      if (!ReadRmaxIndexFile()) {
+        for(int i = 0; i < mTotalNumberOfParticles;i++) {
+          mChain.read_entrie(i);
+          if (std::abs(x)<mRmax && std::abs(y)<mRmax) {
+            pListOfSelectedEvents.push_back(i);
+          }
         }
+        WriteRmaxIndexFile();
       }
       mTotalNumberOfParticles = pListOfSelectedEvents.size();
       mNumberOfParticlesInFile = mTotalNumberOfParticles;
@@ -615,6 +627,14 @@ G4int GateSourcePhaseSpace::OpenIAEAFile(G4String file)
   pIAEAFile = open_file(const_cast<char*>(IAEAFileName.c_str()), const_cast<char*>(IAEAFileExt.c_str()),(char*)"rb");
   if (!pIAEAFile) GateError("Error file not found: " + IAEAFileName + IAEAFileExt);
 
+  // Records are read field by field with fread: give the stream a large
+  // buffer so that the file is actually read in big sequential blocks.
+  mIAEAReadBuffer.resize(4*1024*1024);
+  setvbuf(pIAEAFile, mIAEAReadBuffer.data(), _IOFBF, mIAEAReadBuffer.size());
+#ifdef POSIX_FADV_SEQUENTIAL
+  posix_fadvise(fileno(pIAEAFile), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
   pIAEAheader = (iaea_header_type *) calloc(1, sizeof(iaea_header_type));
   pIAEAheader->fheader = open_file(const_cast<char*>(IAEAFileName.c_str()), const_cast<char*>(IAEAHeaderExt.c_str()), (char*)"rb");
 
@@ -631,6 +651,91 @@ G4int GateSourcePhaseSpace::OpenIAEAFile(G4String file)
 // ----------------------------------------------------------------------------------
 
 
+// ----------------------------------------------------------------------------------
+G4String GateSourcePhaseSpace::GetRmaxIndexFileName() const
+{
+  std::ostringstream oss;
+  oss << listOfPhaseSpaceFile[0] << ".rmax" << mRmax/mm << "mm.idx";
+  return oss.str();
+}
+// ----------------------------------------------------------------------------------
+
+
+// ----------------------------------------------------------------------------------
+std::string GateSourcePhaseSpace::GetRmaxIndexHeader() const
+{
+  // Everything the selection depends on. The index is discarded as soon
+  // as one of the PhS files is replaced or modified.
+  std::ostringstream oss;
+  oss << "GATE phase space Rmax index 1" << std::endl;
+  oss << std::setprecision(9) << "rmax " << mRmax/mm << std::endl;
+  for(auto & file: listOfPhaseSpaceFile) {
+    struct stat st;
+    if (stat(file.c_str(), &st) != 0) {
+      st.st_size = -1;
+      st.st_mtime = 0;
+    }
+    oss << file << " " << st.st_size << " " << st.st_mtime << std::endl;
+  }
+  return oss.str();
+}
+// ----------------------------------------------------------------------------------
+
+
+// ----------------------------------------------------------------------------------
+bool GateSourcePhaseSpace::ReadRmaxIndexFile()
+{
+  if (!mUseRmaxIndexFile) return false;
+  G4String filename = GetRmaxIndexFileName();
+  std::ifstream is(filename, std::ios::binary);
+  if (!is) return false;
+
+  std::string header = GetRmaxIndexHeader();
+  std::string fileHeader(header.size(), '\0');
+  is.read(&fileHeader[0], fileHeader.size());
+  uint64_t n = 0;
+  is.read((char*)&n, sizeof(n));
+  if (!is || fileHeader != header) {
+    GateMessage("Beam", 1, "Phase Space Source. Rmax index " << filename
+                << " does not match the PhS files, it will be recomputed" << Gateendl);
+    return false;
+  }
+  std::vector<unsigned int> selected(n);
+  is.read((char*)selected.data(), n*sizeof(unsigned int));
+  if (!is) {
+    GateWarning("Phase Space Source. Rmax index " << filename << " is truncated, it will be recomputed");
+    return false;
+  }
+  pListOfSelectedEvents.swap(selected);
+  GateMessage("Beam", 1, "Phase Space Source. Read " << n << " selected particles from "
+              << filename << Gateendl);
+  return true;
+}
+// ----------------------------------------------------------------------------------
+
+
+// ----------------------------------------------------------------------------------
+void GateSourcePhaseSpace::WriteRmaxIndexFile() const
+{
+  if (!mUseRmaxIndexFile) return;
+  G4String filename = GetRmaxIndexFileName();
+  std::ofstream os(filename, std::ios::binary);
+  std::string header = GetRmaxIndexHeader();
+  uint64_t n = pListOfSelectedEvents.size();
+  os.write(header.data(), header.size());
+  os.write((const char*)&n, sizeof(n));
+  os.write((const char*)pListOfSelectedEvents.data(), n*sizeof(unsigned int));
+  os.close();
+  if (!os) {
+    GateWarning("Phase Space Source. Cannot write the Rmax index " << filename);
+    std::remove(filename.c_str());
+    return;
+  }
+  GateMessage("Beam", 1, "Phase Space Source. Rmax index written to " << filename << Gateendl);
+}
+// ----------------------------------------------------------------------------------
+
+
 // ----------------------------------------------------------------------------------
 void GateSourcePhaseSpace::InitializePyTorch()
 {
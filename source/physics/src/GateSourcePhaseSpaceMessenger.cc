@@ -64,6 +64,10 @@ GateSourcePhaseSpaceMessenger::GateSourcePhaseSpaceMessenger(GateSourcePhaseSpac
   setRmaxCmd->SetGuidance("set the value of R");
   setRmaxCmd->SetParameterName("R value",false);
 
+  cmdName = GetDirectoryName()+"useRmaxIndexFile";
+  useRmaxIndexFileCmd = new G4UIcmdWithABool(cmdName,this);
+  useRmaxIndexFileCmd->SetGuidance("Store the entries selected with setRmax in an index file next to the first PhS file, and reuse it in later runs");
+
   cmdName = GetDirectoryName()+"setStartingParticleId";
   setStartIdCmd = new G4UIcmdWithADouble(cmdName,this);
   setStartIdCmd->SetGuidance("set the id of the particle to start with");
@@ -96,6 +100,7 @@ GateSourcePhaseSpaceMessenger::~GateSourcePhaseSpaceMessenger()
   delete setParticleTypeCmd;
   delete setUseNbParticleAsIntensityCmd;
   delete setRmaxCmd;
+  delete useRmaxIndexFileCmd;
   delete setStartIdCmd;
   delete setPytorchBatchSizeCmd;
   delete setPytorchParamsCmd;
@@ -118,6 +123,7 @@ void GateSourcePhaseSpaceMessenger::SetNewValue(G4UIcommand* command, G4String n
     pSource->SetUseNbOfParticleAsIntensity(setUseNbParticleAsIntensityCmd->GetNewBoolValue(newValue));
    if (command == ignoreWeightCmd) pSource->SetIgnoreWeight(ignoreWeightCmd->GetNewBoolValue(newValue)); 
   if (command == setRmaxCmd) pSource->SetRmax(setRmaxCmd->GetNewDoubleValue(newValue));
+  if (command == useRmaxIndexFileCmd) pSource->SetUseRmaxIndexFile(useRmaxIndexFileCmd->GetNewBoolValue(newValue));
   if (command == setSphereRadiusCmd) pSource->SetSphereRadius(setSphereRadiusCmd->GetNewDoubleValue(newValue));
   if (command == setStartIdCmd) pSource->SetStartingParticleId(setStartIdCmd->GetNewDoubleValue(newValue));
   if (command == setPytorchBatchSizeCmd) pSource->SetPytorchBatchSize(setPytorchBatchSizeCmd->GetNewIntValue(newValue));
@@ -21,6 +21,7 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <map>
 
 // geant4
 #include "globals.hh"
@@ -35,9 +36,12 @@
 #include "GateMiscFunctions.hh"
 #include "GateApplicationMgr.hh"
 
+// CLHEP
+#include "CLHEP/Random/RandBinomial.h"
+
 
 //------------------------------------------------------------------------------------------------------
-GateSourceTPSPencilBeam::GateSourceTPSPencilBeam(G4String name ):GateVSource( name ), mPencilBeam(NULL), mDistriGeneral(NULL)
+GateSourceTPSPencilBeam::GateSourceTPSPencilBeam(G4String name ):GateVSource( name ), mPencilBeam(NULL), mPDF(NULL), mDistriGeneral(NULL)
 {
   //Particle Type
   mParticleType="proton";
@@ -65,11 +69,11 @@ GateSourceTPSPencilBeam::GateSourceTPSPencilBeam(G4String name ):GateVSource( na
 }
 //------------------------------------------------------------------------------------------------------
 GateSourceTPSPencilBeam::~GateSourceTPSPencilBeam() {
-  delete pMessenger;  // commented due to segfault
-  //FIXME segfault when uncommented
-//  delete mPencilBeam;
-//  delete mPDF;
-//  delete mDistriGeneral;
+  delete pMessenger;
+  // mPencilBeam points to one of the cached pencil beams
+  for (size_t i = 0; i < mPencilBeams.size(); i++) delete mPencilBeams[i];
+  delete [] mPDF;
+  delete mDistriGeneral;
 }
 //------------------------------------------------------------------------------------------------------
 void GateSourceTPSPencilBeam::GenerateVertex( G4Event *aEvent ) {
@@ -78,8 +82,6 @@ void GateSourceTPSPencilBeam::GenerateVertex( G4Event *aEvent ) {
     GateMessage("Beam", 1, "[TPSPencilBeam] Starting..." << Gateendl );
     // get GATE random engine
     CLHEP::HepRandomEngine *engine = GateRandomEngine::GetInstance()->GetRandomEngine();
-    // the "false" means -> do not create messenger (memory gain)
-    mPencilBeam = new GateSourcePencilBeam("PencilBeam", false);
 
     //---------INITIALIZATION - START----------------------
     mIsInitialized = true;
@@ -269,11 +271,22 @@ void GateSourceTPSPencilBeam::GenerateVertex( G4Event *aEvent ) {
     }
     mDistriGeneral = new RandGeneral(engine, mPDF, mTotalNumberOfSpots, 0);
     if (mSortedSpotGenerationFlag){
+      // Multinomial allocation of all primaries over the spots, sampled as
+      // a chain of conditional binomials: O(number of spots) instead of
+      // one RandGeneral call per primary.
       mNbIonsToGenerate.resize(mTotalNumberOfSpots,0);
-      long int ntotal = GateApplicationMgr::GetInstance()->GetTotalNumberOfPrimaries();
-      for (long int i = 0; i<ntotal; i++){
-        int bin = mTotalNumberOfSpots * mDistriGeneral->fire();
-        ++mNbIonsToGenerate[bin];
+      long int nleft = GateApplicationMgr::GetInstance()->GetTotalNumberOfPrimaries();
+      double wleft = 0.;
+      for (int i = 0; i < mTotalNumberOfSpots; i++) wleft += mPDF[i];
+      for (int i = 0; (i < mTotalNumberOfSpots) && (nleft > 0); i++) {
+        double p = (wleft > 0.) ? mPDF[i]/wleft : 1.;
+        if ((p >= 1.) || (i == mTotalNumberOfSpots-1)) {
+          mNbIonsToGenerate[i] = nleft;
+        } else if (p > 0.) {
+          mNbIonsToGenerate[i] = static_cast<long int>(CLHEP::RandBinomial::shoot(engine, nleft, p));
+        }
+        nleft -= mNbIonsToGenerate[i];
+        wleft -= mPDF[i];
       }
       for (int i = 0; i < mTotalNumberOfSpots; i++) {
         GateMessage("Beam", 3, "[TPSPencilBeam] bin " << std::setw(5) << i << ": spotweight=" << std::setw(8) << mPDF[i] << ", Ngen=" << mNbIonsToGenerate[i] << Gateendl );
@@ -281,18 +294,20 @@ void GateSourceTPSPencilBeam::GenerateVertex( G4Event *aEvent ) {
       mCurrentSpot = 0;
     }
 
-  //Correlation Position/Direction
-  //this parameter is not spot or energy dependent and is therefore once for all at the end of the initialization phase.
-      if (mConvergentSourceXTheta) {
-    mPencilBeam->SetEllipseXThetaRotationNorm("positive");   // convergent beam    
-  	 } else {
-    	mPencilBeam->SetEllipseXThetaRotationNorm("negative");   // divergent beam
-  	   }
-  if (mConvergentSourceYPhi) {
-	 mPencilBeam->SetEllipseYPhiRotationNorm("positive"); // convergent beam
-  	 } else {  
-  	   mPencilBeam->SetEllipseYPhiRotationNorm("negative"); // divergent beam
-  		}
+    // One pencil beam per energy layer: the energy dependent beam
+    // parameters (and the gaussian samplers of GateSourcePencilBeam) are
+    // set up once, hopping between spots only changes position/rotation.
+    std::map<double,int> beamOfEnergy;
+    mSpotPencilBeam.resize(mTotalNumberOfSpots);
+    for (int i = 0; i < mTotalNumberOfSpots; i++) {
+      std::map<double,int>::iterator it = beamOfEnergy.find(mSpotEnergy[i]);
+      if (it == beamOfEnergy.end()) {
+        it = beamOfEnergy.insert(std::make_pair(mSpotEnergy[i], (int)mPencilBeams.size())).first;
+        mPencilBeams.push_back(CreatePencilBeam(mSpotEnergy[i]));
+      }
+      mSpotPencilBeam[i] = it->second;
+    }
+    GateMessage("Beam", 1, "[TPSPencilBeam] " << mPencilBeams.size() << " pencil beams configured for " << mTotalNumberOfSpots << " spots." << Gateendl );
 	// pencil beam configuration
    need_pencilbeam_config = true;
    
@@ -305,12 +320,12 @@ void GateSourceTPSPencilBeam::GenerateVertex( G4Event *aEvent ) {
     while ( (mCurrentSpot<mTotalNumberOfSpots) && (mNbIonsToGenerate[mCurrentSpot] <= 0) ){
       GateMessage("Beam", 4, "[TPSPencilBeam] spot " << mCurrentSpot << " has no ions left to generate." << Gateendl );
       mCurrentSpot++;
-      mCurrentLayer = mSpotLayer[mCurrentSpot];
       need_pencilbeam_config = true;
     }
     if ( mCurrentSpot>=mTotalNumberOfSpots ){
       GateError("Too many primary vertex requests!");
     }
+    mCurrentLayer = mSpotLayer[mCurrentSpot];
   } else {
     int nextspot = mTotalNumberOfSpots * mDistriGeneral->fire();
     need_pencilbeam_config = (nextspot!=mCurrentSpot);
@@ -330,38 +345,65 @@ void GateSourceTPSPencilBeam::GenerateVertex( G4Event *aEvent ) {
 //---------GENERATION - END-----------------------
 
 //------------------------------------------------------------------------------------------------------
-void GateSourceTPSPencilBeam::ConfigurePencilBeam() {
-  double energy = mSpotEnergy[mCurrentSpot];
+GateSourcePencilBeam* GateSourceTPSPencilBeam::CreatePencilBeam(double energy) {
+  // the "false" means -> do not create messenger (memory gain)
+  GateSourcePencilBeam* beam = new GateSourcePencilBeam("PencilBeam", false);
   GateMessage("Beam", 5, "[TPSPencilBeam] configuring pencil beam with E= " << energy << Gateendl );
     //Particle Type
-    mPencilBeam->SetParticleType(mParticleType);
+    beam->SetParticleType(mParticleType);
   if (mIsGenericIon==true){
     //Particle Properties If GenericIon
     GateMessage("Beam", 5, "[TPSPencilBeam] configuring pencil beam with generic ion with parameters \"" << mParticleParameters << "\"" << Gateendl );
-    mPencilBeam->SetIonParameter(mParticleParameters);
+    beam->SetIonParameter(mParticleParameters);
   }
   //Energy
-  GateMessage("Beam", 5, "[TPSPencilBeam] configuring pencil beam with E= " << energy << Gateendl );
-  mPencilBeam->SetEnergy(GetEnergy(energy));
   if ( mSigmaEnergyInMeVFlag ){
     GateMessage("Beam", 5, "[TPSPencilBeam] sigma energy from polynomial in MEV" << Gateendl );
     double sourceE = GetEnergy(energy);
-    mPencilBeam->SetEnergy(sourceE);
+    beam->SetEnergy(sourceE);
     double sigmaE = GetSigmaEnergy(energy);
     GateMessage("Beam", 5, "[TPSPencilBeam] : E=" << energy << " sourceE=" << sourceE << " sigmaE=" << sigmaE << Gateendl );
-    mPencilBeam->SetSigmaEnergy(sigmaE);
+    beam->SetSigmaEnergy(sigmaE);
   } else {
     GateMessage("Beam", 5, "[TPSPencilBeam] sigma energy in PERCENT" << Gateendl );
     double sourceE = GetEnergy(energy);
-    mPencilBeam->SetEnergy(sourceE);
+    beam->SetEnergy(sourceE);
     double sigmaEPCT = GetSigmaEnergy(energy);
     double sigmaEMEV = sigmaEPCT*sourceE/100.;
     GateMessage("Beam", 5, "[TPSPencilBeam] : E=" << energy
 		                   << " sourceE=" << sourceE
 				   << " sigmaEPCT=" << sigmaEPCT
 				   << " sigmaEMEV=" << sigmaEMEV << Gateendl );
-    mPencilBeam->SetSigmaEnergy(sigmaEMEV);
+    beam->SetSigmaEnergy(sigmaEMEV);
+  }
+  //Position
+  beam->SetSigmaX(GetSigmaX(energy));
+  beam->SetSigmaY(GetSigmaY(energy));
+  //Direction
+  beam->SetSigmaTheta(GetSigmaTheta(energy));
+  beam->SetEllipseXThetaArea(GetEllipseXThetaArea(energy));
+  beam->SetSigmaPhi(GetSigmaPhi(energy));
+  beam->SetEllipseYPhiArea(GetEllipseYPhiArea(energy));
+  //Correlation Position/Direction
+  //this parameter is not spot or energy dependent
+  if (mConvergentSourceXTheta) {
+    beam->SetEllipseXThetaRotationNorm("positive");   // convergent beam
+  } else {
+    beam->SetEllipseXThetaRotationNorm("negative");   // divergent beam
+  }
+  if (mConvergentSourceYPhi) {
+    beam->SetEllipseYPhiRotationNorm("positive"); // convergent beam
+  } else {
+    beam->SetEllipseYPhiRotationNorm("negative"); // divergent beam
   }
+  beam->SetTestFlag(mTestFlag);
+  return beam;
+}
+//------------------------------------------------------------------------------------------------------
+void GateSourceTPSPencilBeam::ConfigurePencilBeam() {
+  // energy dependent parameters are already set in the cached pencil beam
+  double energy = mSpotEnergy[mCurrentSpot];
+  mPencilBeam = mPencilBeams[mSpotPencilBeam[mCurrentSpot]];
   //Weight
   if (mFlatGenerationFlag) {
     mPencilBeam->SetWeight(mSpotWeight[mCurrentSpot]);
@@ -370,18 +412,9 @@ void GateSourceTPSPencilBeam::ConfigurePencilBeam() {
   }
   //Position
   mPencilBeam->SetPosition(mSpotPosition[mCurrentSpot]);
-  mPencilBeam->SetSigmaX(GetSigmaX(energy));
-  mPencilBeam->SetSigmaY(GetSigmaY(energy));
   //Direction
-  mPencilBeam->SetSigmaTheta(GetSigmaTheta(energy));
-  mPencilBeam->SetEllipseXThetaArea(GetEllipseXThetaArea(energy));
-  mPencilBeam->SetSigmaPhi(GetSigmaPhi(energy));
-  mPencilBeam->SetEllipseYPhiArea(GetEllipseYPhiArea(energy));
   mPencilBeam->SetRotation(mSpotRotation[mCurrentSpot]);
-  //Correlation Position/Direction
-  //this parameter is not spot or energy dependent and is therefore once for all at the end of the initialization phase.
 
-  mPencilBeam->SetTestFlag(mTestFlag);
   if (mTestFlag) {
     GateMessage("Beam", 0, "Configuration of spot (ID) No. " << mCurrentSpot << " (out of " << mTotalNumberOfSpots << ")" << Gateendl);
     GateMessage("Beam", 0, "Energy\t" << energy << Gateendl);
@@ -17,6 +17,10 @@ See LICENSE.md for further details
 #include "GatePETVRTManager.hh"
 #include "GatePETVRTSettings.hh"
 #include "GateMessageManager.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4Version.hh"
+#include <cstdlib>
+#include <typeinfo>
 
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
@@ -108,6 +112,9 @@ void 	GateTotalDiscreteProcess::BuildPhysicsTable ( const G4ParticleDefinition &
 
 void GateTotalDiscreteProcess::BuildCrossSectionsTables()
 {
+	const G4String fileName=GatePETVRTManager::GetInstance()->GetOrCreatePETVRTSettings()->GetCrossSectionsTableFile();
+	if ( fileName!="" && AttachCrossSectionsTables ( fileName ) ) return;
+
 	// build tables for single processes
 	for ( G4int i=0;i<m_nNumProcesses;i++ )
 	{
@@ -132,6 +139,100 @@ void GateTotalDiscreteProcess::BuildCrossSectionsTables()
 	G4cout << "*****************\n";
 #endif
 	m_pTotalCrossSectionsTable->SetAndBuildProductionMaterialTable();
+
+	if ( fileName!="" ) WriteCrossSectionsTables ( fileName );
+}
+
+// Everything the tables depend on: binning, processes, Geant4 version and low energy
+// data, and for each couple its material composition
+uint64_t GateTotalDiscreteProcess::ComputeCrossSectionsTablesHash() const
+{
+	GateSharedTableFile::Hash hash;
+	hash.Add ( m_nTotalMinEnergy );
+	hash.Add ( m_nTotalMaxEnergy );
+	hash.Add ( m_nTotalBinNumber );
+	hash.Add ( G4VERSION_NUMBER );
+	const char* ledata=getenv ( "G4LEDATA" );
+	hash.Add ( G4String ( ledata ? ledata : "" ) );
+	hash.Add ( uint64_t ( m_nNumProcesses ) );
+	for ( G4int i=0;i<m_nNumProcesses;i++ )
+	{
+		hash.Add ( m_oProcessVec[i]->GetProcessName() );
+		hash.Add ( G4String ( typeid ( *m_oProcessVec[i] ).name() ) );
+	}
+
+	const G4ProductionCutsTable* table=G4ProductionCutsTable::GetProductionCutsTable ();
+	hash.Add ( uint64_t ( table->GetTableSize() ) );
+	for ( size_t m=0;m<table->GetTableSize();m++ )
+	{
+		const G4Material* material=table->GetMaterialCutsCouple ( m )->GetMaterial();
+		hash.Add ( material->GetName() );
+		hash.Add ( material->GetDensity() );
+		hash.Add ( uint64_t ( material->GetNumberOfElements() ) );
+		const G4double* fractionMass=material->GetFractionVector();
+		for ( size_t i=0;i<material->GetNumberOfElements();i++ )
+		{
+			hash.Add ( material->GetElement ( i )->GetZ() );
+			hash.Add ( fractionMass[i] );
+		}
+	}
+	return hash.GetValue();
+}
+
+// Payload: number of tables (one per process, then the total), number of couples and
+// number of values per couple, then the values of each table (GateCrossSectionsTable::AppendSharedValues)
+static const uint32_t crossSectionsTableFileVersion = 1;
+
+bool GateTotalDiscreteProcess::AttachCrossSectionsTables ( const G4String& fileName )
+{
+	if ( !m_oCrossSectionsTableFile.Attach ( fileName,ComputeCrossSectionsTablesHash(),crossSectionsTableFileVersion ) ) return false;
+
+	const uint64_t* header=reinterpret_cast<const uint64_t*> ( m_oCrossSectionsTableFile.GetPayload() );
+	const uint64_t nbTables=m_nNumProcesses+1;
+	const uint64_t nbCouples=G4ProductionCutsTable::GetProductionCutsTable()->GetTableSize();
+	const uint64_t nbValues=m_nTotalBinNumber+1;
+	if ( m_oCrossSectionsTableFile.GetPayloadSize() != ( 3+nbTables*nbCouples*nbValues ) *sizeof ( double )
+	     || header[0]!=nbTables || header[1]!=nbCouples || header[2]!=nbValues )
+	{
+		GateWarning ( "GateTotalDiscreteProcess -- inconsistent cross sections table file '" << fileName << "', tables are rebuilt" << Gateendl );
+		m_oCrossSectionsTableFile.Detach();
+		return false;
+	}
+
+	// the processes are still needed to do the interactions
+	const double* values=reinterpret_cast<const double*> ( header+3 );
+	for ( G4int i=0;i<m_nNumProcesses;i++ )
+	{
+		m_oProcessVec[i]->PreparePhysicsTable ( *pParticleType );
+		m_oProcessVec[i]->BuildPhysicsTable ( *pParticleType );
+		m_oCrossSectionsTableVec[i]=new GateCrossSectionsTable ( m_nTotalMinEnergy,m_nTotalMaxEnergy,m_nTotalBinNumber,pParticleType,*m_oProcessVec[i] );
+		m_oCrossSectionsTableVec[i]->SetProductionMaterialTable ( values+i*nbCouples*nbValues );
+	}
+	m_pTotalCrossSectionsTable=new GateCrossSectionsTable ( m_nTotalMinEnergy,m_nTotalMaxEnergy,m_nTotalBinNumber,pParticleType,m_oProcessVec);
+	m_pTotalCrossSectionsTable->SetProductionMaterialTable ( values+m_nNumProcesses*nbCouples*nbValues );
+
+	GateMessage ( "Physic",1,"Fictitious cross sections tables attached from " << fileName << Gateendl );
+	return true;
+}
+
+void GateTotalDiscreteProcess::WriteCrossSectionsTables ( const G4String& fileName ) const
+{
+	std::vector<double> values;
+	values.push_back ( 0. ); // header, filled below
+	values.push_back ( 0. );
+	values.push_back ( 0. );
+	for ( G4int i=0;i<m_nNumProcesses;i++ ) m_oCrossSectionsTableVec[i]->AppendSharedValues ( values );
+	m_pTotalCrossSectionsTable->AppendSharedValues ( values );
+	uint64_t* header=reinterpret_cast<uint64_t*> ( &values[0] );
+	header[0]=m_nNumProcesses+1;
+	header[1]=G4ProductionCutsTable::GetProductionCutsTable()->GetTableSize();
+	header[2]=m_nTotalBinNumber+1;
+
+	std::vector<char> payload ( reinterpret_cast<const char*> ( &values[0] ),reinterpret_cast<const char*> ( &values[0]+values.size() ) );
+	if ( GateSharedTableFile::Write ( fileName,ComputeCrossSectionsTablesHash(),crossSectionsTableFileVersion,payload ) )
+	{
+		GateMessage ( "Physic",1,"Fictitious cross sections tables written to " << fileName << Gateendl );
+	}
 }
 
 
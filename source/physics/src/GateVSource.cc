@@ -52,6 +52,7 @@ GateVSource::GateColorMap GateVSource::theColorMap =
 //-------------------------------------------------------------------------------------------------
 GateVSource::GateVSource(G4String name): m_name( name ) {
   m_type        			 = "";
+  m_kind        			 = kGPSSource;
   m_sourceID     			 = 0;
   m_activity     			 = 0.*becquerel;
   m_startTime    			 = 0.*s;
@@ -444,6 +445,17 @@ void GateVSource::GeneratePrimariesForFastI124Source(G4Event* event) {
 //-------------------------------------------------------------------------------------------------
 
 
+//-------------------------------------------------------------------------------------------------
+GateVSource::SourceKind GateVSource::GetSourceKind( const G4String& type )
+{
+  if (type == "backtoback") return kBackToBackSource;
+  if (type == "fastI124") return kFastI124Source;
+  if (type == "" || type == "gps") return kGPSSource;
+  return kUnknownSource;
+}
+//-------------------------------------------------------------------------------------------------
+
+
 //-------------------------------------------------------------------------------------------------
 G4int GateVSource::GeneratePrimaries( G4Event* event )
 {
@@ -459,16 +471,16 @@ G4int GateVSource::GeneratePrimaries( G4Event* event )
   //
   if ( test ) // replace if ( test == TrackingMode::kBoth  ) // mdupont
     {
-      if (GetType() == G4String("backtoback"))    { GeneratePrimariesForBackToBackSource(event); }
-      else if (GetType() == G4String("fastI124")) { GeneratePrimariesForFastI124Source(event); }
-      else if ((GetType() == G4String("")) || (GetType() == G4String("gps"))) {
+      switch (m_kind) {
+      case kBackToBackSource: GeneratePrimariesForBackToBackSource(event); break;
+      case kFastI124Source:   GeneratePrimariesForFastI124Source(event); break;
+      case kGPSSource:
         // decay time for ions inside the timeSlice controlled here and not by RDM
         // NB: temporary: secondary ions of the decay chain not properly treated
         SetParticleTime( m_time );
         GeneratePrimaryVertex( event );
-
-      }
-      else {
+        break;
+      default:
         GateError("Sorry, I don't know the source type '"<< GetType() << "'. Known source types are"
                   << "<backtoback> <fastI124> <gps>");
       }
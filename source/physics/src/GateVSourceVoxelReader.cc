@@ -36,7 +36,7 @@ GateVSourceVoxelReader::~GateVSourceVoxelReader()
   if (m_voxelTranslator) {
     delete m_voxelTranslator;
   }
-  m_sourceVoxelIntegratedActivities.clear();
+  m_sourceVoxelIntegratedActivities.Clear();
 }
 //-------------------------------------------------------------------------------------------------
 
@@ -110,9 +110,10 @@ G4int GateVSourceVoxelReader::GetNextSource()
     // if there is at least one voxel
 
     // now assign the event to one voxel, according to the relative activity
-    // integral method
-    // from STL doc: iterator upper_bound(const key_type& k)   Sorted Associative Container   Finds the first element whose key greater than k.
-    firstSource = (m_sourceVoxelIntegratedActivities.upper_bound(G4UniformRand() * m_activityTotal))->second;
+    // alias method: O(1) whatever the number of active voxels
+    firstSource = m_sourceVoxelIntegratedActivities.Sample(G4UniformRand());
+    if (firstSource<0)
+      GateError("GateVSourceVoxelReader::GetNextSource : ERROR: No voxel with a non-zero activity");
 
   }
 
@@ -173,27 +174,23 @@ void GateVSourceVoxelReader::RemoveTranslator()
 //-------------------------------------------------------------------------------------------------
 void GateVSourceVoxelReader::PrepareIntegratedActivityMap()
 {
-  // erase all the elements of the old integrated activity map
-  m_sourceVoxelIntegratedActivities.clear();
-
-  // create the new integrated activity map
-  m_activityTotal = 0.;
-  //GateSourceActivityMap::iterator voxel;
-  for (size_t iVoxel = 0; iVoxel < m_sourceVoxelActivities.size(); iVoxel++) {
-	  if (m_sourceVoxelActivities[iVoxel]>0.0) {
-		  m_activityTotal += m_sourceVoxelActivities[iVoxel];
-		  m_sourceVoxelIntegratedActivities[m_activityTotal] = iVoxel;
-	  }
-  }
+  // build the alias table of the voxel activities (replaces the old integrated activity map)
+  m_sourceVoxelIntegratedActivities.Build(m_sourceVoxelActivities);
+  m_activityTotal = m_sourceVoxelIntegratedActivities.GetTotalWeight();
+
+  if (nVerboseLevel>0)
+    G4cout << "[GateVSourceVoxelReader::PrepareIntegratedActivityMap] "
+           << m_sourceVoxelIntegratedActivities.GetNumberOfEntries() << " active voxels, "
+           << "total activity (Bq) " << m_activityTotal / becquerel << ", "
+           << "sampling table " << m_sourceVoxelIntegratedActivities.GetMemorySize()/1024 << " kB"
+           << Gateendl;
 
   if (nVerboseLevel>1) {
-	  GateSourceIntegratedActivityMap::iterator intVoxel;
-	  for (intVoxel = m_sourceVoxelIntegratedActivities.begin(); intVoxel != m_sourceVoxelIntegratedActivities.end(); intVoxel++) {
-		  G4int iVoxel = intVoxel->second;
+	  for (size_t iVoxel = 0; iVoxel < m_sourceVoxelActivities.size(); iVoxel++) {
+		  if (m_sourceVoxelActivities[iVoxel]>0.0)
 		  G4cout << "[GateVSourceVoxelReader::PrepareIntegratedActivityMap] "
 				  << "   voxel: " << GetVoxelIndices(iVoxel)
 				  << "   activity : (Bq) " << m_sourceVoxelActivities[iVoxel] / becquerel
-				  << "   integrated: (Bq) " << ((*intVoxel).first)  / becquerel
 				  << Gateendl;
     }
   }